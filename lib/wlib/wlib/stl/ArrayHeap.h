@@ -5,7 +5,8 @@
  * This file contains generic heap manipulation functions
  * for data structures that supply a @code RandomAccessIterator @endcode
  * and a general @code ArrayHeap @endcode implementation using
- * @code ArrayList @endcode.
+ * @code ArrayList @endcode, as well as a bounded @code top_k @endcode
+ * accumulator that selects the greatest values of a stream.
  *
  * @author Jeff Niu
  * @date November 9, 2017
@@ -28,6 +29,7 @@ namespace wlp {
      * heap, preserving heap property. This version uses
      * a supplied comparator.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType integer size type
      * @tparam ValType the type of the inserted value
@@ -39,6 +41,7 @@ namespace wlp {
      * @param cmp the comparator use for @code __lt__ @endcode
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename SizeType,
             typename ValType,
@@ -51,11 +54,11 @@ namespace wlp {
             ValType value,
             Cmp cmp
     ) {
-        SizeType parent = static_cast<SizeType>((hole_index - 1) / 2);
+        SizeType parent = static_cast<SizeType>((hole_index - 1) / Arity);
         while (hole_index > top_index && cmp.__lt__(*(first + parent), value)) {
             *(first + hole_index) = *(first + parent);
             hole_index = parent;
-            parent = static_cast<SizeType>((hole_index - 1) / 2);
+            parent = static_cast<SizeType>((hole_index - 1) / Arity);
         }
         *(first + hole_index) = value;
     };
@@ -65,6 +68,7 @@ namespace wlp {
      * at @code hole_index @endcode and inserts into the
      * heap, preserving heap property.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType integer size type
      * @tparam ValType the type of the inserted value
@@ -74,6 +78,7 @@ namespace wlp {
      * @param value the value to insert
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename SizeType,
             typename ValType
@@ -84,11 +89,11 @@ namespace wlp {
             SizeType top_index,
             ValType value
     ) {
-        SizeType parent = static_cast<SizeType>((hole_index - 1) / 2);
+        SizeType parent = static_cast<SizeType>((hole_index - 1) / Arity);
         while (hole_index > top_index && *(first + parent) < value) {
             *(first + hole_index) = *(first + parent);
             hole_index = parent;
-            parent = static_cast<SizeType>((hole_index - 1) / 2);
+            parent = static_cast<SizeType>((hole_index - 1) / Arity);
         }
         *(first + hole_index) = value;
     };
@@ -98,6 +103,7 @@ namespace wlp {
      * data structure into a heap structure at @code [first, last) @endcode.
      * This function assumes the aforementioned range is already a heap.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam Cmp comparator type
      * @tparam SizeType integer size type, acquired from the iterator type
@@ -107,6 +113,7 @@ namespace wlp {
      * @param cmp comparator to use
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename Cmp,
             typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
@@ -121,7 +128,7 @@ namespace wlp {
             RandomAccessIterator last,
             Cmp cmp
     ) {
-        __push_heap(first, static_cast<SizeType>(last - first - 1), (SizeType) 0, ValType(*(last - 1)), cmp);
+        __push_heap<Arity>(first, static_cast<SizeType>(last - first - 1), (SizeType) 0, ValType(*(last - 1)), cmp);
     }
 
     /**
@@ -129,6 +136,7 @@ namespace wlp {
      * data structure into a heap structure at @code [first, last) @endcode.
      * This function assumes the aforementioned range is already a heap.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType integer size type, acquired from the iterator type
      * @tparam ValType type of the inserted value, acquired from the iterator type
@@ -136,6 +144,7 @@ namespace wlp {
      * @param last iterator to the element to be inserted
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename = typename enable_if<
                     is_random_access_iterator<RandomAccessIterator>()
@@ -147,12 +156,19 @@ namespace wlp {
             RandomAccessIterator first,
             RandomAccessIterator last
     ) {
-        __push_heap(first, static_cast<SizeType>(last - first - 1), (SizeType) 0, ValType(*(last - 1)));
+        __push_heap<Arity>(first, static_cast<SizeType>(last - first - 1), (SizeType) 0, ValType(*(last - 1)));
     }
 
     /**
      * Helper function performs heapify at the specified index.
+     * The hole is first moved down to a leaf along the path of
+     * largest children, and the value is then pushed back up,
+     * which takes fewer comparisons than sifting the value down.
+     * With a larger arity the tree is shallower and the children
+     * of a node are adjacent, so a level costs one scan of
+     * consecutive elements.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType integer size type
      * @tparam ValType value type for insertion
@@ -164,6 +180,7 @@ namespace wlp {
      * @param cmp comparator to use
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename SizeType,
             typename ValType,
@@ -176,26 +193,37 @@ namespace wlp {
             ValType value,
             Cmp cmp
     ) {
+        static_assert(Arity >= 2, "Heap arity must be at least two");
         SizeType top_index = hole_index;
-        SizeType second_child = static_cast<SizeType>(2 * hole_index + 2);
-        while (second_child < length) {
-            if (cmp.__lt__(*(first + second_child), *(first + second_child - 1))) {
-                --second_child;
+        SizeType child = static_cast<SizeType>(Arity * hole_index + 1);
+        while (child + Arity <= length) {
+            SizeType largest = child;
+            for (SizeType i = 1; i < Arity; ++i) {
+                if (cmp.__lt__(*(first + largest), *(first + child + i))) {
+                    largest = static_cast<SizeType>(child + i);
+                }
             }
-            *(first + hole_index) = *(first + second_child);
-            hole_index = second_child;
-            second_child = static_cast<SizeType>(2 * (second_child + 1));
+            *(first + hole_index) = *(first + largest);
+            hole_index = largest;
+            child = static_cast<SizeType>(Arity * hole_index + 1);
         }
-        if (second_child == length) {
-            *(first + hole_index) = *(first + second_child - 1);
-            hole_index = static_cast<SizeType>(second_child - 1);
+        if (child < length) {
+            SizeType largest = child;
+            for (SizeType i = static_cast<SizeType>(child + 1); i < length; ++i) {
+                if (cmp.__lt__(*(first + largest), *(first + i))) {
+                    largest = i;
+                }
+            }
+            *(first + hole_index) = *(first + largest);
+            hole_index = largest;
         }
-        __push_heap(first, hole_index, top_index, value, cmp);
+        __push_heap<Arity>(first, hole_index, top_index, value, cmp);
     };
 
     /**
      * Helper function performs heapify at the specified index.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType integer size type
      * @tparam ValType value type for insertion
@@ -205,6 +233,7 @@ namespace wlp {
      * @param value value to heapify
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename SizeType,
             typename ValType
@@ -215,26 +244,37 @@ namespace wlp {
             SizeType length,
             ValType value
     ) {
+        static_assert(Arity >= 2, "Heap arity must be at least two");
         SizeType top_index = hole_index;
-        SizeType second_child = static_cast<SizeType>(2 * hole_index + 2);
-        while (second_child < length) {
-            if (*(first + second_child) < *(first + second_child - 1)) {
-                --second_child;
+        SizeType child = static_cast<SizeType>(Arity * hole_index + 1);
+        while (child + Arity <= length) {
+            SizeType largest = child;
+            for (SizeType i = 1; i < Arity; ++i) {
+                if (*(first + largest) < *(first + child + i)) {
+                    largest = static_cast<SizeType>(child + i);
+                }
             }
-            *(first + hole_index) = *(first + second_child);
-            hole_index = second_child;
-            second_child = static_cast<SizeType>(2 * (second_child + 1));
+            *(first + hole_index) = *(first + largest);
+            hole_index = largest;
+            child = static_cast<SizeType>(Arity * hole_index + 1);
         }
-        if (second_child == length) {
-            *(first + hole_index) = *(first + second_child - 1);
-            hole_index = static_cast<SizeType>(second_child - 1);
+        if (child < length) {
+            SizeType largest = child;
+            for (SizeType i = static_cast<SizeType>(child + 1); i < length; ++i) {
+                if (*(first + largest) < *(first + i)) {
+                    largest = i;
+                }
+            }
+            *(first + hole_index) = *(first + largest);
+            hole_index = largest;
         }
-        __push_heap(first, hole_index, top_index, value);
+        __push_heap<Arity>(first, hole_index, top_index, value);
     };
 
     /**
      * Helper function to pop an element from the heap.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam Cmp comparator type
      * @tparam SizeType integer size type
@@ -246,6 +286,7 @@ namespace wlp {
      * @param cmp comparator to use
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename Cmp,
             typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
@@ -259,12 +300,13 @@ namespace wlp {
             Cmp cmp
     ) {
         *result = *first;
-        __adjust_heap(first, (SizeType) 0, (SizeType) (last - first), value, cmp);
+        __adjust_heap<Arity>(first, (SizeType) 0, (SizeType) (last - first), value, cmp);
     };
 
     /**
      * Helper function to pop an element from the heap.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType integer size type
      * @tparam ValType value type
@@ -274,6 +316,7 @@ namespace wlp {
      * @param value the value that is popped
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
             typename ValType
@@ -285,7 +328,7 @@ namespace wlp {
             ValType value
     ) {
         *result = *first;
-        __adjust_heap(first, (SizeType) 0, (SizeType) (last - first), value);
+        __adjust_heap<Arity>(first, (SizeType) 0, (SizeType) (last - first), value);
     };
 
     /**
@@ -293,6 +336,7 @@ namespace wlp {
      * such that the popped element is then stored at @code last @endcode
      * and the heap now ranges @code [first, last - 1) @endcode.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam Cmp comparator type
      * @tparam ValType value type acquired from the iterator type
@@ -301,6 +345,7 @@ namespace wlp {
      * @param cmp comparator to use
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename Cmp,
             typename ValType = typename obtain_val_type<RandomAccessIterator>::type,
@@ -314,7 +359,7 @@ namespace wlp {
             RandomAccessIterator last,
             Cmp cmp
     ) {
-        __pop_heap(first, last - 1, last - 1, (ValType) *(last - 1), cmp);
+        __pop_heap<Arity>(first, last - 1, last - 1, (ValType) *(last - 1), cmp);
     };
 
     /**
@@ -322,12 +367,14 @@ namespace wlp {
      * such that the popped element is then stored at @code last @endcode
      * and the heap now ranges @code [first, last - 1) @endcode.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam ValType value type acquired from the iterator type
      * @param first iterator to first element in random access structure
      * @param last iterator to last element in random access structure
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename = typename enable_if<
                     is_random_access_iterator<RandomAccessIterator>()
@@ -338,7 +385,7 @@ namespace wlp {
             RandomAccessIterator first,
             RandomAccessIterator last
     ) {
-        __pop_heap(first, last - 1, last - 1, (ValType) *(last - 1));
+        __pop_heap<Arity>(first, last - 1, last - 1, (ValType) *(last - 1));
     };
 
     /**
@@ -346,6 +393,7 @@ namespace wlp {
      * (typically an array or vector) and create a heap
      * that ranges from @code [first, last) @endcode.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam Cmp comparator type
      * @tparam SizeType size type acquired from iterator type
@@ -355,6 +403,7 @@ namespace wlp {
      * @param cmp comparator to use
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename Cmp,
             typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
@@ -373,9 +422,9 @@ namespace wlp {
         if (length < 2) {
             return;
         }
-        SizeType parent = static_cast<SizeType>((length - 2) / 2);
+        SizeType parent = static_cast<SizeType>((length - 2) / Arity);
         for (;;) {
-            __adjust_heap(first, parent, length, (ValType) *(first + parent), cmp);
+            __adjust_heap<Arity>(first, parent, length, (ValType) *(first + parent), cmp);
             if (parent == 0) {
                 return;
             }
@@ -388,6 +437,7 @@ namespace wlp {
      * (typically an array or vector) and create a heap
      * that ranges from @code [first, last) @endcode.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam SizeType size type acquired from iterator type
      * @tparam ValType value type acquired from iterator type
@@ -395,6 +445,7 @@ namespace wlp {
      * @param last iterator to last element in random acces structure
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
             typename ValType = typename obtain_val_type<RandomAccessIterator>::type,
@@ -410,9 +461,9 @@ namespace wlp {
         if (length < 2) {
             return;
         }
-        SizeType parent = static_cast<SizeType>((length - 2) / 2);
+        SizeType parent = static_cast<SizeType>((length - 2) / Arity);
         for (;;) {
-            __adjust_heap(first, parent, length, (ValType) *(first + parent));
+            __adjust_heap<Arity>(first, parent, length, (ValType) *(first + parent));
             if (parent == 0) {
                 return;
             }
@@ -425,6 +476,7 @@ namespace wlp {
      * such that they are ordered from smallest to largest between
      * @code [first, last) @endcode. This eliminates the heap property.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @tparam Cmp comparator type
      * @param first iterator to first element in heap
@@ -432,6 +484,7 @@ namespace wlp {
      * @param cmp comparator type
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename Cmp,
             typename = typename enable_if<
@@ -444,7 +497,7 @@ namespace wlp {
             Cmp cmp
     ) {
         while (last - first > 1) {
-            pop_heap(first, last--, cmp);
+            pop_heap<Arity>(first, last--, cmp);
         }
     };
 
@@ -453,11 +506,13 @@ namespace wlp {
      * such that they are ordered from smallest to largest between
      * @code [first, last) @endcode. This eliminates the heap property.
      *
+     * @tparam Arity number of children of each heap node
      * @tparam RandomAccessIterator random access iterator type
      * @param first iterator to first element in heap
      * @param last iterator to last element in heap
      */
     template<
+            size_t Arity = 2,
             typename RandomAccessIterator,
             typename = typename enable_if<
                     is_random_access_iterator<RandomAccessIterator>()
@@ -467,22 +522,27 @@ namespace wlp {
             RandomAccessIterator last
     ) {
         while (last - first > 1) {
-            pop_heap(first, last--);
+            pop_heap<Arity>(first, last--);
         }
     };
 
     /**
      * A basic heap implementation using @code ArrayList @endcode
      * as the backing structure. May be used as a priority queue.
+     * Large heaps pop faster with an arity of 4 or 8, which makes
+     * the tree shallower and keeps the children of a node next to
+     * each other. The array is not aligned to cache lines, so the
+     * children of a node may still span two lines.
      *
      * @tparam T data type
      * @tparam Cmp comparator type, which uses the default
+     * @tparam Arity number of children of each heap node
      */
-    template<typename T, class Cmp = comparator<T>>
+    template<typename T, class Cmp = comparator<T>, size_t Arity = 2>
     class array_heap {
     public:
         typedef Cmp comparator;
-        typedef array_heap<T> heap_t;
+        typedef array_heap<T, Cmp, Arity> heap_t;
         typedef typename array_list<T>::val_type val_type;
         typedef typename array_list<T>::size_type size_type;
         typedef typename array_list<T>::list_type array_list_t;
@@ -530,27 +590,35 @@ namespace wlp {
          * Push an element onto the heap.
          *
          * @param value value to insert
+         * @return false if the backing array is full
          */
-        void push(const val_type &value) {
-            m_list.push_back(value);
-            push_heap(m_list.begin(), m_list.end(), m_cmp);
+        bool push(const val_type &value) {
+            if (!m_list.push_back(value)) {
+                return false;
+            }
+            push_heap<Arity>(m_list.begin(), m_list.end(), m_cmp);
+            return true;
         }
 
         /**
          * Push an rvalue onto the heap.
          *
          * @param value rvalue to insert
+         * @return false if the backing array is full
          */
-        void push(val_type &&value) {
-            m_list.push_back(forward<val_type>(value));
-            push_heap(m_list.begin(), m_list.end(), m_cmp);
+        bool push(val_type &&value) {
+            if (!m_list.push_back(forward<val_type>(value))) {
+                return false;
+            }
+            push_heap<Arity>(m_list.begin(), m_list.end(), m_cmp);
+            return true;
         }
 
         /**
          * Pop the top element from the heap.
          */
         void pop() {
-            pop_heap(m_list.begin(), m_list.end(), m_cmp);
+            pop_heap<Arity>(m_list.begin(), m_list.end(), m_cmp);
             m_list.pop_back();
         }
 
@@ -612,6 +680,213 @@ namespace wlp {
         }
     };
 
+    /**
+     * Bounded accumulator that keeps the @code k @endcode greatest
+     * values pushed into it. The kept values form a heap whose top
+     * is the smallest of them, so a value that does not make the cut
+     * costs one comparison and one that does costs a single sift
+     * down. Selecting the top k of n values runs in O(n log k) time
+     * with O(k) memory, without storing the whole input.
+     *
+     * @tparam T data type
+     * @tparam Cmp comparator type, which uses the default
+     */
+    template<typename T, class Cmp = comparator<T>>
+    class top_k {
+    public:
+        typedef Cmp comparator;
+        typedef top_k<T, Cmp> top_k_t;
+        typedef typename array_list<T>::val_type val_type;
+        typedef typename array_list<T>::size_type size_type;
+        typedef typename array_list<T>::list_type array_list_t;
+
+    private:
+        /**
+         * Reverses the comparator, making the heap a min heap.
+         */
+        struct ReverseOrder {
+            const comparator *m_cmp;
+
+            bool __lt__(const val_type &a, const val_type &b) const {
+                return m_cmp->__lt__(b, a);
+            }
+        };
+
+        /**
+         * The kept values, as a heap with the smallest on top.
+         */
+        array_list_t m_heap;
+        /**
+         * The number of values to keep.
+         */
+        size_type m_k;
+        /**
+         * The comparator instance.
+         */
+        comparator m_cmp;
+
+        /**
+         * @return the reversed comparator
+         */
+        ReverseOrder order() const {
+            return ReverseOrder{&m_cmp};
+        }
+
+    public:
+        /**
+         * Create an accumulator keeping the given number of values.
+         *
+         * @param k number of values to keep
+         */
+        explicit top_k(size_type k)
+                : m_heap(k > 0 ? k : 1),
+                  m_k(k),
+                  m_cmp(Cmp()) {
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        top_k(const top_k_t &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param acc accumulator whose resources to transfer
+         */
+        top_k(top_k_t &&acc)
+                : m_heap(move(acc.m_heap)),
+                  m_k(acc.m_k),
+                  m_cmp(move(acc.m_cmp)) {
+        }
+
+        /**
+         * Offer a value to the accumulator.
+         *
+         * @param value value to offer
+         * @return true if the value is among the kept values
+         */
+        bool push(const val_type &value) {
+            if (m_heap.size() < m_k) {
+                if (!m_heap.push_back(value)) {
+                    return false;
+                }
+                __push_heap(m_heap.data(), m_heap.size() - 1, (size_type) 0, value, order());
+                return true;
+            }
+            if (m_k == 0 || !m_cmp.__lt__(*m_heap.data(), value)) {
+                return false;
+            }
+            __adjust_heap(m_heap.data(), (size_type) 0, m_heap.size(), value, order());
+            return true;
+        }
+
+        /**
+         * Offer a range of values to the accumulator.
+         *
+         * @tparam It forward iterator type
+         * @param first the first value
+         * @param last  pass-the-end of the range
+         */
+        template<typename It>
+        void push(It first, It last) {
+            for (; first != last; ++first) {
+                push(*first);
+            }
+        }
+
+        /**
+         * Get the smallest kept value, which a value must exceed
+         * to be kept once the accumulator is full. The accumulator
+         * must not be empty.
+         *
+         * @return reference to the smallest kept value
+         */
+        const val_type &threshold() const {
+            return *m_heap.data();
+        }
+
+        /**
+         * @return true if k values are kept
+         */
+        bool full() const {
+            return m_heap.size() == m_k;
+        }
+
+        /**
+         * @return whether no values are kept
+         */
+        bool empty() const {
+            return m_heap.empty();
+        }
+
+        /**
+         * @return the number of kept values
+         */
+        size_type size() const {
+            return m_heap.size();
+        }
+
+        /**
+         * @return the number of values to keep
+         */
+        size_type k() const {
+            return m_k;
+        }
+
+        /**
+         * @return the kept values, in heap order
+         */
+        const array_list_t &values() const {
+            return m_heap;
+        }
+
+        /**
+         * Remove the kept values.
+         */
+        void clear() noexcept {
+            m_heap.clear();
+        }
+
+        /**
+         * Sort the kept values from greatest to smallest and
+         * transfer them out, leaving the accumulator empty.
+         *
+         * @return array list of the kept values, greatest first
+         */
+        array_list_t release_sorted() {
+            val_type *base = m_heap.data();
+            for (size_type end = m_heap.size(); end > 1;) {
+                --end;
+                val_type value(move(base[end]));
+                base[end] = move(*base);
+                __adjust_heap(base, (size_type) 0, end, move(value), order());
+            }
+            array_list_t sorted(move(m_heap));
+            m_heap = array_list_t(m_k > 0 ? m_k : 1);
+            return sorted;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this accumulator
+         */
+        top_k_t &operator=(const top_k_t &) = delete;
+
+        /**
+         * Move assignment operator.
+         *
+         * @param acc accumulator whose resources to transfer
+         * @return reference to this accumulator
+         */
+        top_k_t &operator=(top_k_t &&acc) {
+            m_heap = move(acc.m_heap);
+            m_k = acc.m_k;
+            return *this;
+        }
+    };
+
     /**
      * Sort an array list using heap sort.
      * This function uses the array list
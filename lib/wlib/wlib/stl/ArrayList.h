@@ -15,12 +15,88 @@
 
 #include <wlib/utility>
 #include <wlib/memory>
+#include <wlib/stl/ArrayScan.h>
 #include <stddef.h>
 
 namespace wlp {
 
+    /**
+     * Geometric growth policy for @code array_list @endcode. The
+     * backing array capacity is multiplied by @code Num / Den @endcode
+     * whenever the list is full.
+     *
+     * @tparam Num growth factor numerator
+     * @tparam Den growth factor denominator
+     */
+    template<size_t Num, size_t Den>
+    struct geometric_growth {
+        static_assert(Num > Den, "Growth factor must be greater than one");
+
+        /**
+         * @tparam SizeType integer size type
+         * @param capacity the current capacity of the backing array
+         * @param required the minimum number of elements to hold
+         * @return the next capacity of the backing array
+         */
+        template<typename SizeType>
+        static SizeType grow(SizeType capacity, SizeType required) {
+            SizeType next = static_cast<SizeType>(capacity / Den * Num + capacity % Den * Num / Den);
+            return next < required ? required : next;
+        }
+    };
+
+    /**
+     * Double the capacity on each growth. This is the default policy.
+     */
+    typedef geometric_growth<2, 1> double_growth;
+
+    /**
+     * Grow the capacity by half on each growth, which allows freed
+     * blocks to be reused by later growths and wastes less memory
+     * in the worst case.
+     */
+    typedef geometric_growth<3, 2> three_halves_growth;
+
+    /**
+     * Linear growth policy that adds a fixed number of elements
+     * to the capacity whenever the list is full. Peak memory is
+     * predictable at the cost of more frequent reallocations.
+     *
+     * @tparam Increment the number of elements to add
+     */
+    template<size_t Increment>
+    struct fixed_growth {
+        static_assert(Increment > 0, "Growth increment must be positive");
+
+        template<typename SizeType>
+        static SizeType grow(SizeType capacity, SizeType required) {
+            SizeType next = static_cast<SizeType>(capacity + Increment);
+            return next < required ? required : next;
+        }
+    };
+
+    /**
+     * Chunked growth policy which rounds the capacity up to the next
+     * multiple of the chunk size, so that backing arrays always
+     * occupy a whole number of equally sized chunks in the pool.
+     *
+     * @tparam Chunk the number of elements in a chunk
+     */
+    template<size_t Chunk>
+    struct chunked_growth {
+        static_assert(Chunk > 0, "Chunk size must be positive");
+
+        template<typename SizeType>
+        static SizeType grow(SizeType capacity, SizeType required) {
+            if (required <= capacity) {
+                required = static_cast<SizeType>(capacity + 1);
+            }
+            return static_cast<SizeType>((required + Chunk - 1) / Chunk * Chunk);
+        }
+    };
+
     // ArrayList forward declaration.
-    template<typename T>
+    template<typename T, typename Growth = double_growth>
     class array_list;
 
     /**
@@ -29,8 +105,9 @@ namespace wlp {
      * @tparam T list element type
      * @tparam Ref reference type, which may be const
      * @tparam Ptr pointer type, which may be const
+     * @tparam Growth growth policy of the backing array list
      */
-    template<typename T, typename Ref, typename Ptr>
+    template<typename T, typename Ref, typename Ptr, typename Growth = double_growth>
     class ArrayListIterator {
     public:
         typedef size_t size_type;
@@ -38,8 +115,8 @@ namespace wlp {
         typedef T val_type;
         typedef Ref reference;
         typedef Ptr pointer;
-        typedef array_list<T> array_list_t;
-        typedef ArrayListIterator<T, Ref, Ptr> self_type;
+        typedef array_list<T, Growth> array_list_t;
+        typedef ArrayListIterator<T, Ref, Ptr, Growth> self_type;
 
     private:
         /**
@@ -51,7 +128,7 @@ namespace wlp {
          */
         size_type m_i;
 
-        friend class array_list<T>;
+        friend class array_list<T, Growth>;
 
     public:
         /**
@@ -264,18 +341,22 @@ namespace wlp {
 
     /**
      * List implementation using an array. This implementation
-     * will resize if attempting to insert into a full array.
+     * will resize if attempting to insert into a full array,
+     * unless the maximum capacity has been reached, in which
+     * case the insertion fails.
      *
      * @tparam T value type
+     * @tparam Growth growth policy used to compute the next capacity
      */
-    template<typename T>
+    template<typename T, typename Growth>
     class array_list {
     public:
         typedef T val_type;
         typedef size_t size_type;
-        typedef array_list<T> list_type;
-        typedef ArrayListIterator<T, T &, T *> iterator;
-        typedef ArrayListIterator<T, const T &, const T *> const_iterator;
+        typedef Growth growth_policy;
+        typedef array_list<T, Growth> list_type;
+        typedef ArrayListIterator<T, T &, T *, Growth> iterator;
+        typedef ArrayListIterator<T, const T &, const T *, Growth> const_iterator;
 
     private:
         /**
@@ -290,10 +371,14 @@ namespace wlp {
          * The current size of the backing array.
          */
         size_type m_capacity;
+        /**
+         * The largest capacity to which the backing array may grow.
+         */
+        size_type m_max_capacity;
 
-        friend class ArrayListIterator<T, T &, T *>;
+        friend class ArrayListIterator<T, T &, T *, Growth>;
 
-        friend class ArrayListIterator<T, const T &, const T *>;
+        friend class ArrayListIterator<T, const T &, const T *, Growth>;
 
     public:
         /**
@@ -304,7 +389,8 @@ namespace wlp {
          */
         explicit array_list(size_type initial_capacity = 12)
                 : m_size(0),
-                  m_capacity(initial_capacity) {
+                  m_capacity(initial_capacity),
+                  m_max_capacity(static_cast<size_type>(-1)) {
             init_array(initial_capacity);
         }
 
@@ -321,7 +407,8 @@ namespace wlp {
         array_list(list_type &&list)
                 : m_data(move(list.m_data)),
                   m_size(move(list.m_size)),
-                  m_capacity(move(list.m_capacity)) {
+                  m_capacity(move(list.m_capacity)),
+                  m_max_capacity(move(list.m_max_capacity)) {
             list.m_data = nullptr;
             list.m_size = 0;
             list.m_capacity = 0;
@@ -338,7 +425,8 @@ namespace wlp {
          */
         array_list(const val_type *values, size_type length, size_type initial_capacity)
                 : m_size(length),
-                  m_capacity(initial_capacity) {
+                  m_capacity(initial_capacity),
+                  m_max_capacity(static_cast<size_type>(-1)) {
             if (m_capacity < length) {
                 m_capacity = length;
             }
@@ -401,10 +489,22 @@ namespace wlp {
         /**
          * Called before any insertion operation,
          * this function will extend the size of the
-         * array to twice its capacity and copy
+         * array as per the growth policy and copy
          * the elements of the previous array.
+         *
+         * @return false if the array is full and cannot grow
+         * past the maximum capacity or the allocation failed
          */
-        void ensure_capacity();
+        bool ensure_capacity();
+
+        /**
+         * Replace the backing array with one of the given capacity,
+         * copying over the current elements.
+         *
+         * @param new_capacity the size of the new backing array
+         * @return false if the allocation failed
+         */
+        bool reallocate(size_type new_capacity);
 
         /**
          * Shift elements in the array at position @code i @endcode
@@ -446,12 +546,32 @@ namespace wlp {
             return m_capacity;
         }
 
+        /**
+         * @return the largest size the backing array may grow to
+         */
+        size_type max_capacity() const {
+            return m_max_capacity;
+        }
+
+        /**
+         * Set a hard limit on the size of the backing array. Once
+         * the list is full at this capacity, insertions fail instead
+         * of allocating. The limit does not shrink an array that is
+         * already larger.
+         *
+         * @param max_capacity the maximum backing array size
+         */
+        void set_max_capacity(size_type max_capacity) {
+            m_max_capacity = max_capacity;
+        }
+
         /**
          * Copy the elements in the current array into
          * a new array such that the new array has
          * a size corresponding to the new capacity.
          * If the new capacity is smaller than the current
-         * capacity, nothing happens.
+         * capacity, nothing happens. The reserved capacity
+         * is limited to the maximum capacity.
          *
          * @param new_capacity the size of backing array to reserve
          */
@@ -601,11 +721,14 @@ namespace wlp {
          *
          * @param i position to insert
          * @param t element to insert
-         * @return iterator to the inserted element
+         * @return iterator to the inserted element, or pass-the-end
+         * if the list is full
          */
         template<typename V>
         iterator insert(size_type i, V &&val) {
-            ensure_capacity();
+            if (!ensure_capacity()) {
+                return end();
+            }
             normalize(i);
             shift_right(i);
             m_data[i] = forward<V>(val);
@@ -619,14 +742,14 @@ namespace wlp {
          *
          * @param it iterator to the inserted position
          * @param t element to insert
-         * @return iterator to the inserted element
+         * @return iterator to the inserted element, or pass-the-end
+         * if the list is full
          */
         template<typename V>
         iterator insert(const iterator &it, V &&val) {
-            if (it.m_i > m_size) {
+            if (it.m_i > m_size || !ensure_capacity()) {
                 return end();
             }
-            ensure_capacity();
             shift_right(it.m_i);
             m_data[it.m_i] = forward<V>(val);
             ++m_size;
@@ -668,25 +791,33 @@ namespace wlp {
          * Insert an element to the back of the list.
          *
          * @param val element to insert
+         * @return false if the list is full and the element was not inserted
          */
         template<typename V>
-        void push_back(V &&val) {
-            ensure_capacity();
+        bool push_back(V &&val) {
+            if (!ensure_capacity()) {
+                return false;
+            }
             m_data[m_size] = forward<V>(val);
             ++m_size;
+            return true;
         }
 
         /**
          * Insert an element at the front of the list.
          *
          * @param val element to insert
+         * @return false if the list is full and the element was not inserted
          */
         template<typename V>
-        void push_front(V &&val) {
-            ensure_capacity();
+        bool push_front(V &&val) {
+            if (!ensure_capacity()) {
+                return false;
+            }
             shift_right(0);
             m_data[0] = forward<V>(val);
             ++m_size;
+            return true;
         }
 
         /**
@@ -709,16 +840,23 @@ namespace wlp {
         }
 
         /**
+         * Arithmetic element types are searched with vector
+         * instructions when available.
+         *
          * @param val the value to find
          * @return the index of the value, or the size of the list
          * if the value is not found
          */
         size_type index_of(const val_type &val) const {
-            size_type i = 0;
-            for (; i < m_size; ++i) {
-                if (val == m_data[i]) { return i; }
-            }
-            return i;
+            return static_cast<size_type>(scan_find(m_data, m_size, val));
+        }
+
+        /**
+         * @param val the value to count
+         * @return the number of elements equal to the value
+         */
+        size_type count(const val_type &val) const {
+            return static_cast<size_type>(scan_count(m_data, m_size, val));
         }
 
         /**
@@ -755,6 +893,7 @@ namespace wlp {
             m_data = move(list.m_data);
             m_size = move(list.m_size);
             m_capacity = move(list.m_capacity);
+            m_max_capacity = move(list.m_max_capacity);
             list.m_data = nullptr;
             list.m_size = 0;
             list.m_capacity = 0;
@@ -763,58 +902,64 @@ namespace wlp {
 
     };
 
-    template<typename T>
-    void array_list<T>::ensure_capacity() {
-        if (m_size < m_capacity) {
-            return;
-        }
-        size_type new_capacity = static_cast<size_type>(2 * m_capacity);
+    template<typename T, typename Growth>
+    bool array_list<T, Growth>::reallocate(size_type new_capacity) {
         val_type *new_data = create<val_type[]>(new_capacity);
+        if (!new_data) {
+            return false;
+        }
         for (size_type i = 0; i < m_size; i++) {
-            new_data[i] = m_data[i];
+            new_data[i] = move(m_data[i]);
         }
         destroy<val_type[]>(m_data);
         m_data = new_data;
         m_capacity = new_capacity;
+        return true;
+    }
+
+    template<typename T, typename Growth>
+    bool array_list<T, Growth>::ensure_capacity() {
+        if (m_size < m_capacity) {
+            return true;
+        }
+        if (m_capacity >= m_max_capacity) {
+            return false;
+        }
+        size_type new_capacity = Growth::grow(m_capacity, static_cast<size_type>(m_size + 1));
+        if (new_capacity > m_max_capacity || new_capacity <= m_capacity) {
+            new_capacity = m_max_capacity;
+        }
+        return reallocate(new_capacity);
     }
 
-    template<typename T>
-    void array_list<T>::reserve(size_type new_capacity) {
+    template<typename T, typename Growth>
+    void array_list<T, Growth>::reserve(size_type new_capacity) {
+        if (new_capacity > m_max_capacity) {
+            new_capacity = m_max_capacity;
+        }
         if (new_capacity <= m_capacity) {
             return;
         }
-        val_type *new_data = create<val_type[]>(new_capacity);
-        for (size_type i = 0; i < m_size; i++) {
-            new_data[i] = m_data[i];
-        }
-        destroy<val_type[]>(m_data);
-        m_data = new_data;
-        m_capacity = new_capacity;
+        reallocate(new_capacity);
     }
 
-    template<typename T>
-    void array_list<T>::shrink() {
+    template<typename T, typename Growth>
+    void array_list<T, Growth>::shrink() {
         if (m_size == m_capacity) {
             return;
         }
-        val_type *new_data = create<val_type[]>(m_size);
-        for (size_type i = 0; i < m_size; i++) {
-            new_data[i] = m_data[i];
-        }
-        destroy<val_type[]>(m_data);
-        m_data = new_data;
-        m_capacity = m_size;
+        reallocate(m_size);
     }
 
-    template<typename T>
-    inline void array_list<T>::shift_right(size_type i) {
+    template<typename T, typename Growth>
+    inline void array_list<T, Growth>::shift_right(size_type i) {
         for (size_type j = m_size; j > i; j--) {
             m_data[j] = m_data[j - 1];
         }
     }
 
-    template<typename T>
-    inline void array_list<T>::shift_left(size_type i) {
+    template<typename T, typename Growth>
+    inline void array_list<T, Growth>::shift_left(size_type i) {
         for (size_type j = i; j < m_size - 1; j++) {
             m_data[j] = m_data[j + 1];
         }
@@ -0,0 +1,538 @@
+/**
+ * @file ArrayScan.h
+ * @brief Linear scans over contiguous arrays.
+ *
+ * This file contains search and reduction functions over
+ * contiguous arrays: find, count, any_of, min, max, and sum.
+ * When the element type is arithmetic and the target supports
+ * SSE2 or AVX2, the scans are vectorized and process a full
+ * vector register of elements per step. Other element types and
+ * targets use the scalar implementation. Define @code WLIB_NO_SIMD @endcode
+ * to always use the scalar implementation.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_ARRAYSCAN_H
+#define EMBEDDEDCPLUSPLUS_ARRAYSCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/type_traits>
+
+#if !defined(WLIB_NO_SIMD) && defined(__AVX2__)
+#define __WLIB_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(WLIB_NO_SIMD) && defined(__SSE2__)
+#define __WLIB_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace wlp {
+
+    /**
+     * Vector lane operations for an element type. The base case
+     * has no vectorized implementation, so scans over the type
+     * fall back to the scalar loops.
+     *
+     * @tparam T element type
+     * @tparam Enable specialization hook
+     */
+    template<typename T, typename Enable = void>
+    struct SimdLane {
+        static constexpr bool enabled = false;
+        static constexpr bool has_min_max = false;
+    };
+
+#if defined(__WLIB_SIMD_AVX2) || defined(__WLIB_SIMD_SSE2)
+
+#if defined(__WLIB_SIMD_AVX2)
+    typedef __m256i simd_int_reg;
+    typedef __m256 simd_float_reg;
+    typedef __m256d simd_double_reg;
+#define __WLIB_SIMD(Op) _mm256_##Op
+#define __WLIB_SIMD_INT(Op) _mm256_##Op##_si256
+#else
+    typedef __m128i simd_int_reg;
+    typedef __m128 simd_float_reg;
+    typedef __m128d simd_double_reg;
+#define __WLIB_SIMD(Op) _mm_##Op
+#define __WLIB_SIMD_INT(Op) _mm_##Op##_si128
+#endif
+
+    /**
+     * Operations on integer lanes shared by all lane widths.
+     * Lane comparisons produce a register of all ones or all
+     * zeros per lane, and the movemask produces one bit per byte.
+     *
+     * @tparam T integer element type
+     */
+    template<typename T>
+    struct SimdIntLaneBase {
+        typedef simd_int_reg reg;
+        static constexpr bool enabled = true;
+        static constexpr size_t width = sizeof(reg) / sizeof(T);
+        static constexpr unsigned mask_bits = sizeof(T);
+
+        static reg load(const T *p) {
+            return __WLIB_SIMD_INT(loadu)(reinterpret_cast<const reg *>(p));
+        }
+
+        static void store(T *p, reg v) {
+            __WLIB_SIMD_INT(storeu)(reinterpret_cast<reg *>(p), v);
+        }
+
+        static unsigned mask(reg v) {
+            return static_cast<unsigned>(__WLIB_SIMD(movemask_epi8)(v));
+        }
+
+        static reg blend(reg m, reg a, reg b) {
+            return __WLIB_SIMD_INT(or)(__WLIB_SIMD_INT(and)(m, a), __WLIB_SIMD_INT(andnot)(m, b));
+        }
+    };
+
+    /**
+     * Integer lane operations specialized by lane width and
+     * signedness. Unsigned lanes are compared by flipping the
+     * sign bit and using the signed comparison.
+     *
+     * @tparam T integer element type
+     * @tparam Size the width of the element in bytes
+     */
+    template<typename T, size_t Size = sizeof(T)>
+    struct SimdIntLane;
+
+    template<typename T>
+    struct SimdIntLane<T, 1> : SimdIntLaneBase<T> {
+        typedef simd_int_reg reg;
+        static constexpr bool has_min_max = true;
+
+        static reg set1(T t) { return __WLIB_SIMD(set1_epi8)(static_cast<char>(t)); }
+        static reg eq(reg a, reg b) { return __WLIB_SIMD(cmpeq_epi8)(a, b); }
+        static reg add(reg a, reg b) { return __WLIB_SIMD(add_epi8)(a, b); }
+        static reg gt(reg a, reg b) {
+            if (is_signed<T>::value) {
+                return __WLIB_SIMD(cmpgt_epi8)(a, b);
+            }
+            reg bias = __WLIB_SIMD(set1_epi8)(static_cast<char>(0x80));
+            return __WLIB_SIMD(cmpgt_epi8)(__WLIB_SIMD_INT(xor)(a, bias), __WLIB_SIMD_INT(xor)(b, bias));
+        }
+    };
+
+    template<typename T>
+    struct SimdIntLane<T, 2> : SimdIntLaneBase<T> {
+        typedef simd_int_reg reg;
+        static constexpr bool has_min_max = true;
+
+        static reg set1(T t) { return __WLIB_SIMD(set1_epi16)(static_cast<short>(t)); }
+        static reg eq(reg a, reg b) { return __WLIB_SIMD(cmpeq_epi16)(a, b); }
+        static reg add(reg a, reg b) { return __WLIB_SIMD(add_epi16)(a, b); }
+        static reg gt(reg a, reg b) {
+            if (is_signed<T>::value) {
+                return __WLIB_SIMD(cmpgt_epi16)(a, b);
+            }
+            reg bias = __WLIB_SIMD(set1_epi16)(static_cast<short>(0x8000));
+            return __WLIB_SIMD(cmpgt_epi16)(__WLIB_SIMD_INT(xor)(a, bias), __WLIB_SIMD_INT(xor)(b, bias));
+        }
+    };
+
+    template<typename T>
+    struct SimdIntLane<T, 4> : SimdIntLaneBase<T> {
+        typedef simd_int_reg reg;
+        static constexpr bool has_min_max = true;
+
+        static reg set1(T t) { return __WLIB_SIMD(set1_epi32)(static_cast<int>(t)); }
+        static reg eq(reg a, reg b) { return __WLIB_SIMD(cmpeq_epi32)(a, b); }
+        static reg add(reg a, reg b) { return __WLIB_SIMD(add_epi32)(a, b); }
+        static reg gt(reg a, reg b) {
+            if (is_signed<T>::value) {
+                return __WLIB_SIMD(cmpgt_epi32)(a, b);
+            }
+            reg bias = __WLIB_SIMD(set1_epi32)(static_cast<int>(0x80000000u));
+            return __WLIB_SIMD(cmpgt_epi32)(__WLIB_SIMD_INT(xor)(a, bias), __WLIB_SIMD_INT(xor)(b, bias));
+        }
+    };
+
+    template<typename T>
+    struct SimdIntLane<T, 8> : SimdIntLaneBase<T> {
+        typedef simd_int_reg reg;
+#if defined(__WLIB_SIMD_AVX2)
+        static constexpr bool has_min_max = true;
+
+        static reg eq(reg a, reg b) { return _mm256_cmpeq_epi64(a, b); }
+        static reg gt(reg a, reg b) {
+            if (is_signed<T>::value) {
+                return _mm256_cmpgt_epi64(a, b);
+            }
+            reg bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+        }
+#else
+        // SSE2 has no 64-bit comparisons
+        static constexpr bool has_min_max = false;
+
+        static reg eq(reg a, reg b) {
+            reg halves = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, 0xb1));
+        }
+#endif
+
+        static reg set1(T t) { return __WLIB_SIMD(set1_epi64x)(static_cast<long long>(t)); }
+        static reg add(reg a, reg b) { return __WLIB_SIMD(add_epi64)(a, b); }
+    };
+
+    /**
+     * Vectorized integer types, excluding @code bool @endcode.
+     *
+     * @tparam T integer element type
+     */
+    template<typename T>
+    struct SimdLane<T, typename enable_if<
+            is_integral<T>::value && !is_same<T, bool>::value &&
+            (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+    >::type> : SimdIntLane<T> {
+    };
+
+    /**
+     * Vectorized single precision floats. The movemask produces
+     * one bit per lane.
+     */
+    template<>
+    struct SimdLane<float, void> {
+        typedef simd_float_reg reg;
+        static constexpr bool enabled = true;
+        static constexpr bool has_min_max = true;
+        static constexpr size_t width = sizeof(reg) / sizeof(float);
+        static constexpr unsigned mask_bits = 1;
+
+        static reg load(const float *p) { return __WLIB_SIMD(loadu_ps)(p); }
+        static void store(float *p, reg v) { __WLIB_SIMD(storeu_ps)(p, v); }
+        static reg set1(float t) { return __WLIB_SIMD(set1_ps)(t); }
+        static unsigned mask(reg v) { return static_cast<unsigned>(__WLIB_SIMD(movemask_ps)(v)); }
+        static reg add(reg a, reg b) { return __WLIB_SIMD(add_ps)(a, b); }
+        static reg min(reg a, reg b) { return __WLIB_SIMD(min_ps)(a, b); }
+        static reg max(reg a, reg b) { return __WLIB_SIMD(max_ps)(a, b); }
+#if defined(__WLIB_SIMD_AVX2)
+        static reg eq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+#else
+        static reg eq(reg a, reg b) { return _mm_cmpeq_ps(a, b); }
+#endif
+    };
+
+    /**
+     * Vectorized double precision floats.
+     */
+    template<>
+    struct SimdLane<double, void> {
+        typedef simd_double_reg reg;
+        static constexpr bool enabled = true;
+        static constexpr bool has_min_max = true;
+        static constexpr size_t width = sizeof(reg) / sizeof(double);
+        static constexpr unsigned mask_bits = 1;
+
+        static reg load(const double *p) { return __WLIB_SIMD(loadu_pd)(p); }
+        static void store(double *p, reg v) { __WLIB_SIMD(storeu_pd)(p, v); }
+        static reg set1(double t) { return __WLIB_SIMD(set1_pd)(t); }
+        static unsigned mask(reg v) { return static_cast<unsigned>(__WLIB_SIMD(movemask_pd)(v)); }
+        static reg add(reg a, reg b) { return __WLIB_SIMD(add_pd)(a, b); }
+        static reg min(reg a, reg b) { return __WLIB_SIMD(min_pd)(a, b); }
+        static reg max(reg a, reg b) { return __WLIB_SIMD(max_pd)(a, b); }
+#if defined(__WLIB_SIMD_AVX2)
+        static reg eq(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+#else
+        static reg eq(reg a, reg b) { return _mm_cmpeq_pd(a, b); }
+#endif
+    };
+
+#undef __WLIB_SIMD
+#undef __WLIB_SIMD_INT
+
+    /**
+     * Integer lanes compute minimum and maximum with a comparison
+     * followed by a blend, since direct instructions are not
+     * available for every lane width in SSE2.
+     *
+     * @tparam Lane integer lane operations
+     * @param a first register
+     * @param b second register
+     * @return lane-wise minimum
+     */
+    template<typename Lane>
+    inline typename Lane::reg __simd_min(typename Lane::reg a, typename Lane::reg b, true_type) {
+        return Lane::blend(Lane::gt(a, b), b, a);
+    }
+
+    template<typename Lane>
+    inline typename Lane::reg __simd_min(typename Lane::reg a, typename Lane::reg b, false_type) {
+        return Lane::min(a, b);
+    }
+
+    template<typename Lane>
+    inline typename Lane::reg __simd_max(typename Lane::reg a, typename Lane::reg b, true_type) {
+        return Lane::blend(Lane::gt(a, b), a, b);
+    }
+
+    template<typename Lane>
+    inline typename Lane::reg __simd_max(typename Lane::reg a, typename Lane::reg b, false_type) {
+        return Lane::max(a, b);
+    }
+
+#endif
+
+    /**
+     * Scalar scan kernels, used for non-arithmetic element types,
+     * targets without vector support, and the tail of a vectorized scan.
+     *
+     * @tparam T element type
+     */
+    template<typename T>
+    struct ScalarScan {
+        static size_t find(const T *data, size_t i, size_t n, const T &val) {
+            for (; i < n; ++i) {
+                if (val == data[i]) { return i; }
+            }
+            return n;
+        }
+
+        static size_t count(const T *data, size_t i, size_t n, const T &val) {
+            size_t c = 0;
+            for (; i < n; ++i) {
+                if (val == data[i]) { ++c; }
+            }
+            return c;
+        }
+
+        static T min(const T *data, size_t i, size_t n, T best) {
+            for (; i < n; ++i) {
+                if (data[i] < best) { best = data[i]; }
+            }
+            return best;
+        }
+
+        static T max(const T *data, size_t i, size_t n, T best) {
+            for (; i < n; ++i) {
+                if (best < data[i]) { best = data[i]; }
+            }
+            return best;
+        }
+
+        static T sum(const T *data, size_t i, size_t n, T acc) {
+            for (; i < n; ++i) {
+                acc = static_cast<T>(acc + data[i]);
+            }
+            return acc;
+        }
+    };
+
+    /**
+     * Scan dispatcher selects vectorized kernels for element types
+     * that have a vector lane implementation.
+     *
+     * @tparam T element type
+     * @tparam Vector whether the type is vectorized
+     * @tparam MinMax whether vectorized min and max are available
+     */
+    template<typename T, bool Vector = SimdLane<T>::enabled, bool MinMax = SimdLane<T>::has_min_max>
+    struct ArrayScan {
+        static size_t find(const T *data, size_t n, const T &val) {
+            return ScalarScan<T>::find(data, 0, n, val);
+        }
+
+        static size_t count(const T *data, size_t n, const T &val) {
+            return ScalarScan<T>::count(data, 0, n, val);
+        }
+
+        static T min(const T *data, size_t n) {
+            return ScalarScan<T>::min(data, 1, n, data[0]);
+        }
+
+        static T max(const T *data, size_t n) {
+            return ScalarScan<T>::max(data, 1, n, data[0]);
+        }
+
+        static T sum(const T *data, size_t n) {
+            return ScalarScan<T>::sum(data, 0, n, T());
+        }
+    };
+
+#if defined(__WLIB_SIMD_AVX2) || defined(__WLIB_SIMD_SSE2)
+
+    template<typename T, bool MinMax>
+    struct ArrayScan<T, true, MinMax> {
+        typedef SimdLane<T> lane;
+        typedef typename lane::reg reg;
+        static constexpr size_t width = lane::width;
+
+        static size_t find(const T *data, size_t n, const T &val) {
+            reg needle = lane::set1(val);
+            size_t i = 0;
+            for (; i + width <= n; i += width) {
+                unsigned m = lane::mask(lane::eq(lane::load(data + i), needle));
+                if (m) {
+                    return i + static_cast<size_t>(__builtin_ctz(m)) / lane::mask_bits;
+                }
+            }
+            return ScalarScan<T>::find(data, i, n, val);
+        }
+
+        static size_t count(const T *data, size_t n, const T &val) {
+            reg needle = lane::set1(val);
+            size_t c = 0;
+            size_t i = 0;
+            for (; i + width <= n; i += width) {
+                unsigned m = lane::mask(lane::eq(lane::load(data + i), needle));
+                c += static_cast<size_t>(__builtin_popcount(m)) / lane::mask_bits;
+            }
+            return c + ScalarScan<T>::count(data, i, n, val);
+        }
+
+        static T min(const T *data, size_t n) {
+            return reduce_min_max(data, n, true, integral_constant<bool, MinMax>());
+        }
+
+        static T max(const T *data, size_t n) {
+            return reduce_min_max(data, n, false, integral_constant<bool, MinMax>());
+        }
+
+        static T sum(const T *data, size_t n) {
+            if (n < width) {
+                return ScalarScan<T>::sum(data, 0, n, T());
+            }
+            reg acc = lane::load(data);
+            size_t i = width;
+            for (; i + width <= n; i += width) {
+                acc = lane::add(acc, lane::load(data + i));
+            }
+            T lanes[width];
+            lane::store(lanes, acc);
+            T total = ScalarScan<T>::sum(lanes, 0, width, T());
+            return ScalarScan<T>::sum(data, i, n, total);
+        }
+
+    private:
+        static T reduce_min_max(const T *data, size_t n, bool minimum, true_type) {
+            if (n < width) {
+                return minimum
+                       ? ScalarScan<T>::min(data, 1, n, data[0])
+                       : ScalarScan<T>::max(data, 1, n, data[0]);
+            }
+            typedef integral_constant<bool, is_integral<T>::value> int_lane;
+            reg acc = lane::load(data);
+            size_t i = width;
+            for (; i + width <= n; i += width) {
+                acc = minimum
+                      ? __simd_min<lane>(acc, lane::load(data + i), int_lane())
+                      : __simd_max<lane>(acc, lane::load(data + i), int_lane());
+            }
+            T lanes[width];
+            lane::store(lanes, acc);
+            return minimum
+                   ? ScalarScan<T>::min(data, i, n, ScalarScan<T>::min(lanes, 1, width, lanes[0]))
+                   : ScalarScan<T>::max(data, i, n, ScalarScan<T>::max(lanes, 1, width, lanes[0]));
+        }
+
+        static T reduce_min_max(const T *data, size_t n, bool minimum, false_type) {
+            return minimum
+                   ? ScalarScan<T>::min(data, 1, n, data[0])
+                   : ScalarScan<T>::max(data, 1, n, data[0]);
+        }
+    };
+
+#endif
+
+    /**
+     * Find the first element in an array equal to the given value.
+     *
+     * @tparam T element type
+     * @param data pointer to the first element
+     * @param n the number of elements
+     * @param val the value to find
+     * @return the index of the first occurrence, or @code n @endcode
+     * if the value is not found
+     */
+    template<typename T>
+    inline size_t scan_find(const T *data, size_t n, const T &val) {
+        return ArrayScan<T>::find(data, n, val);
+    }
+
+    /**
+     * Count the elements in an array equal to the given value.
+     *
+     * @tparam T element type
+     * @param data pointer to the first element
+     * @param n the number of elements
+     * @param val the value to count
+     * @return the number of occurrences
+     */
+    template<typename T>
+    inline size_t scan_count(const T *data, size_t n, const T &val) {
+        return ArrayScan<T>::count(data, n, val);
+    }
+
+    /**
+     * @tparam T element type
+     * @param data pointer to the first element
+     * @param n the number of elements
+     * @param val the value to find
+     * @return true if any element is equal to the value
+     */
+    template<typename T>
+    inline bool scan_any_of(const T *data, size_t n, const T &val) {
+        return ArrayScan<T>::find(data, n, val) != n;
+    }
+
+    /**
+     * Obtain the smallest element in an array. The result is
+     * unspecified for floating point arrays containing NaN.
+     *
+     * @pre the array is not empty
+     *
+     * @tparam T element type
+     * @param data pointer to the first element
+     * @param n the number of elements
+     * @return the smallest value
+     */
+    template<typename T>
+    inline T scan_min(const T *data, size_t n) {
+        return ArrayScan<T>::min(data, n);
+    }
+
+    /**
+     * Obtain the largest element in an array. The result is
+     * unspecified for floating point arrays containing NaN.
+     *
+     * @pre the array is not empty
+     *
+     * @tparam T element type
+     * @param data pointer to the first element
+     * @param n the number of elements
+     * @return the largest value
+     */
+    template<typename T>
+    inline T scan_max(const T *data, size_t n) {
+        return ArrayScan<T>::max(data, n);
+    }
+
+    /**
+     * Sum the elements in an array. Integer sums wrap around on
+     * overflow of the element type. Vectorized floating point sums
+     * add the elements in a different order than a sequential loop,
+     * so the result may differ in rounding.
+     *
+     * @tparam T element type
+     * @param data pointer to the first element
+     * @param n the number of elements
+     * @return the sum of the elements, or zero if empty
+     */
+    template<typename T>
+    inline T scan_sum(const T *data, size_t n) {
+        return ArrayScan<T>::sum(data, n);
+    }
+
+}
+
+#undef __WLIB_SIMD_AVX2
+#undef __WLIB_SIMD_SSE2
+
+#endif //EMBEDDEDCPLUSPLUS_ARRAYSCAN_H
@@ -0,0 +1,1104 @@
+/**
+ * @file BTree.h
+ * @brief B-tree implementation.
+ *
+ * Implements a B-tree for use in ordered associative containers.
+ * Each node stores a sorted run of elements sized to fill roughly
+ * @code NodeBytes @endcode bytes, so that a lookup touches one node
+ * per level of a shallow tree instead of one node per comparison.
+ * Insertion splits full nodes on the way down, as in CLRS, and
+ * erasure refills nodes that fall under half full from a sibling
+ * or merges them with one on the way back up.
+ *
+ * Elements are moved between nodes as the tree changes shape, so
+ * any insertion or erasure invalidates all iterators.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BTREE_H
+#define EMBEDDEDCPLUSPLUS_BTREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/memory>
+#include <wlib/utility>
+
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Pair.h>
+
+namespace wlp {
+
+    /**
+     * Number of elements stored per node to fill a node of the given
+     * size. The count is odd, as required by the splitting scheme,
+     * and at least three.
+     *
+     * @tparam Element   element type
+     * @tparam NodeBytes target node size in bytes
+     */
+    template<typename Element, size_t NodeBytes>
+    struct BTreeSlots {
+        static constexpr size_t header = sizeof(void *) + 2 * sizeof(uint16_t) + sizeof(bool);
+        static constexpr size_t fit = NodeBytes > header + 3 * sizeof(Element)
+                                      ? (NodeBytes - header) / sizeof(Element) : 3;
+        static constexpr size_t capped = fit > UINT16_MAX ? UINT16_MAX : fit;
+        static constexpr size_t value = capped % 2 == 0 ? capped - 1 : capped;
+    };
+
+    /**
+     * B-tree leaf node. Internal nodes extend leaf nodes with
+     * an array of child pointers.
+     *
+     * @tparam Element element type
+     * @tparam Slots   maximum number of elements in the node
+     */
+    template<typename Element, size_t Slots>
+    struct BTreeNode {
+        typedef BTreeNode<Element, Slots> node_type;
+        typedef Element element_type;
+        typedef uint16_t count_type;
+
+        /**
+         * Parent node, or null for the root.
+         */
+        node_type *m_parent;
+        /**
+         * Index of this node among the children of its parent.
+         */
+        count_type m_position;
+        /**
+         * Number of elements in the node.
+         */
+        count_type m_count;
+        /**
+         * Whether the node has no children.
+         */
+        bool m_leaf;
+        /**
+         * Sorted elements of the node.
+         */
+        element_type m_elements[Slots];
+
+        /**
+         * Obtain a child of an internal node.
+         *
+         * @param i index of the child, at most the element count
+         * @return reference to the child pointer
+         */
+        node_type *&child(size_t i);
+
+        /**
+         * @param node node from which to start
+         * @return the leftmost leaf under the node
+         */
+        static node_type *find_minimum(node_type *node) {
+            while (!node->m_leaf) {
+                node = node->child(0);
+            }
+            return node;
+        }
+
+        /**
+         * @param node node from which to start
+         * @return the rightmost leaf under the node
+         */
+        static node_type *find_maximum(node_type *node) {
+            while (!node->m_leaf) {
+                node = node->child(node->m_count);
+            }
+            return node;
+        }
+    };
+
+    /**
+     * B-tree internal node.
+     *
+     * @tparam Element element type
+     * @tparam Slots   maximum number of elements in the node
+     */
+    template<typename Element, size_t Slots>
+    struct BTreeInternalNode : public BTreeNode<Element, Slots> {
+        typedef BTreeNode<Element, Slots> node_type;
+
+        /**
+         * Child nodes, one more than the number of elements.
+         */
+        node_type *m_children[Slots + 1];
+    };
+
+    template<typename Element, size_t Slots>
+    inline BTreeNode<Element, Slots> *&BTreeNode<Element, Slots>::child(size_t i) {
+        return static_cast<BTreeInternalNode<Element, Slots> *>(this)->m_children[i];
+    }
+
+    /**
+     * B-tree iterator, which points to an element by its node and
+     * its index in the node. The pass-the-end iterator points one
+     * past the last element of the rightmost leaf.
+     *
+     * @tparam Element element type which contains the key and value
+     * @tparam Key     the element key type
+     * @tparam Val     the element value type
+     * @tparam Ref     reference to value type, which may be a constant reference
+     * @tparam Ptr     pointer to value type, which may be a constant pointer
+     * @tparam GetKey  struct which returns the key of an element
+     * @tparam GetVal  struct which returns the value of an element
+     * @tparam Slots   maximum number of elements in a node
+     */
+    template<typename Element,
+            typename Key,
+            typename Val,
+            typename Ref,
+            typename Ptr,
+            typename GetKey,
+            typename GetVal,
+            size_t Slots>
+    struct BTreeIterator {
+        typedef BTreeNode<Element, Slots> node_type;
+        typedef Key key_type;
+        typedef Ref reference;
+        typedef Ptr pointer;
+        typedef size_t size_type;
+        typedef Element element_type;
+        typedef GetKey get_key;
+        typedef GetVal get_value;
+
+    private:
+        typedef BTreeIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Slots> self_type;
+
+    public:
+        /**
+         * The node of the element pointed to by this iterator.
+         */
+        node_type *m_node;
+        /**
+         * The index of the element in its node.
+         */
+        size_type m_index;
+
+        /**
+         * Functor used to obtain key value.
+         */
+        get_key m_get_key{};
+        /**
+         * Functor used to obtain element value.
+         */
+        get_value m_get_value{};
+
+        /**
+         * Default constructor.
+         */
+        BTreeIterator()
+                : m_node(nullptr),
+                  m_index(0) {}
+
+        /**
+         * Constructor from node and index.
+         *
+         * @param node  the node of the element
+         * @param index the index of the element in the node
+         */
+        BTreeIterator(node_type *node, size_type index)
+                : m_node(node),
+                  m_index(index) {}
+
+        /**
+         * Copy constructor.
+         *
+         * @param it iterator to copy
+         */
+        BTreeIterator(const self_type &it)
+                : m_node(it.m_node),
+                  m_index(it.m_index) {}
+
+        /**
+         * Move the iterator to the next ordered element.
+         * The iterator does not move past the end.
+         */
+        void increment() {
+            if (!m_node || m_index >= m_node->m_count) {
+                return;
+            }
+            if (!m_node->m_leaf) {
+                m_node = node_type::find_minimum(m_node->child(m_index + 1));
+                m_index = 0;
+                return;
+            }
+            if (++m_index < m_node->m_count) {
+                return;
+            }
+            node_type *node = m_node;
+            size_type index = m_index;
+            while (node->m_parent && index == node->m_count) {
+                index = node->m_position;
+                node = node->m_parent;
+            }
+            // otherwise this was the last element and the
+            // iterator stays one past the end of the leaf
+            if (index < node->m_count) {
+                m_node = node;
+                m_index = index;
+            }
+        }
+
+        /**
+         * Move the iterator to the previous ordered element.
+         * The iterator does not move past the first element.
+         */
+        void decrement() {
+            if (!m_node->m_leaf) {
+                m_node = node_type::find_maximum(m_node->child(m_index));
+                m_index = static_cast<size_type>(m_node->m_count - 1);
+                return;
+            }
+            if (m_index > 0) {
+                --m_index;
+                return;
+            }
+            node_type *node = m_node;
+            while (node->m_parent && node->m_position == 0) {
+                node = node->m_parent;
+            }
+            if (node->m_parent) {
+                m_index = static_cast<size_type>(node->m_position - 1);
+                m_node = node->m_parent;
+            }
+        }
+
+        /**
+         * Iterator equality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to the same element
+         */
+        bool operator==(const self_type &it) const {
+            return m_node == it.m_node && m_index == it.m_index;
+        }
+
+        /**
+         * Iterator inequality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to different elements
+         */
+        bool operator!=(const self_type &it) const {
+            return m_node != it.m_node || m_index != it.m_index;
+        }
+
+        /**
+         * @return reference to the value of the element
+         */
+        reference operator*() const {
+            return m_get_value(m_node->m_elements[m_index]);
+        }
+
+        /**
+         * @return the key of the element
+         */
+        const key_type &key() const {
+            return m_get_key(m_node->m_elements[m_index]);
+        }
+
+        /**
+         * @return pointer to the value of the element
+         */
+        pointer operator->() const {
+            if (m_node == nullptr) {
+                return nullptr;
+            }
+            return &m_get_value(m_node->m_elements[m_index]);
+        }
+
+        /**
+         * Prefix increment operator.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator++() {
+            increment();
+            return *this;
+        }
+
+        /**
+         * Postfix increment operator.
+         *
+         * @return a copy of the iterator before the increment
+         */
+        self_type operator++(int) {
+            self_type tmp = *this;
+            increment();
+            return tmp;
+        }
+
+        /**
+         * Prefix decrement operator.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator--() {
+            decrement();
+            return *this;
+        }
+
+        /**
+         * Postfix decrement operator.
+         *
+         * @return a copy of the iterator before the decrement
+         */
+        self_type operator--(int) {
+            self_type tmp = *this;
+            decrement();
+            return tmp;
+        }
+
+        /**
+         * Copy assignment operator.
+         *
+         * @param it iterator to assign
+         * @return reference to this iterator
+         */
+        self_type &operator=(const self_type &it) {
+            m_node = it.m_node;
+            m_index = it.m_index;
+            return *this;
+        }
+    };
+
+    /**
+     * B-tree of unique keys, designed for use in associative containers
+     * in the same manner as @code tree @endcode.
+     *
+     * @tparam Element   element type which contains the key and val
+     * @tparam Key       element key type
+     * @tparam Val       element value type
+     * @tparam GetKey    functor type used to get element key
+     * @tparam GetVal    functor type used to get element value
+     * @tparam Cmp       key comparator type, which uses the default comparator
+     * @tparam NodeBytes target size of a leaf node in bytes
+     */
+    template<typename Element,
+            typename Key,
+            typename Val,
+            typename GetKey,
+            typename GetVal,
+            typename Cmp = wlp::comparator<Key>,
+            size_t NodeBytes = 256>
+    class btree {
+    public:
+        static constexpr size_t slots = BTreeSlots<Element, NodeBytes>::value;
+        static constexpr size_t min_count = slots / 2;
+
+        typedef Key key_type;
+        typedef Val val_type;
+        typedef Element element_type;
+        typedef Cmp comparator;
+        typedef size_t size_type;
+        typedef BTreeNode<Element, slots> node_type;
+        typedef BTreeInternalNode<Element, slots> internal_type;
+        typedef btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes> tree_type;
+        typedef BTreeIterator<Element, Key, Val, Val &, Val *, GetKey, GetVal, slots> iterator;
+        typedef BTreeIterator<Element, Key, Val, const Val &, const Val *, GetKey, GetVal, slots> const_iterator;
+        typedef GetKey get_key;
+        typedef GetVal get_val;
+
+    private:
+        typedef typename node_type::count_type count_type;
+
+        /**
+         * The root node, or null if the tree is empty.
+         */
+        node_type *m_root;
+        /**
+         * The leftmost leaf, which holds the first element.
+         */
+        node_type *m_leftmost;
+        /**
+         * The rightmost leaf, which holds the last element.
+         */
+        node_type *m_rightmost;
+        /**
+         * The number of elements in the tree.
+         */
+        size_type m_size;
+        /**
+         * Class comparator instance.
+         */
+        comparator m_cmp{};
+        /**
+         * Functor used to obtain element key.
+         */
+        get_key m_get_key{};
+
+    public:
+        /**
+         * Create an empty tree. No nodes are allocated
+         * until the first element is inserted.
+         */
+        btree()
+                : m_root(nullptr),
+                  m_leftmost(nullptr),
+                  m_rightmost(nullptr),
+                  m_size(0) {}
+
+        /**
+         * Disable copy construction.
+         */
+        btree(const tree_type &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param tree the tree to move
+         */
+        btree(tree_type &&tree)
+                : m_root(tree.m_root),
+                  m_leftmost(tree.m_leftmost),
+                  m_rightmost(tree.m_rightmost),
+                  m_size(tree.m_size) {
+            tree.m_root = nullptr;
+            tree.m_leftmost = nullptr;
+            tree.m_rightmost = nullptr;
+            tree.m_size = 0;
+        }
+
+        /**
+         * Deallocate all nodes.
+         */
+        ~btree() {
+            clear();
+        }
+
+        /**
+         * @return iterator to the first element
+         */
+        iterator begin() {
+            return iterator(m_leftmost, 0);
+        }
+
+        /**
+         * @return pass-the-end iterator
+         */
+        iterator end() {
+            return iterator(m_rightmost, m_rightmost ? m_rightmost->m_count : 0);
+        }
+
+        /**
+         * @return constant iterator to the first element
+         */
+        const_iterator begin() const {
+            return const_iterator(m_leftmost, 0);
+        }
+
+        /**
+         * @return constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(m_rightmost, m_rightmost ? m_rightmost->m_count : 0);
+        }
+
+        /**
+         * @return true if the tree is empty
+         */
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * @return the number of elements in the tree
+         */
+        size_type size() const {
+            return m_size;
+        }
+
+        /**
+         * @return the maximum number of elements in the tree
+         */
+        size_type capacity() const {
+            return static_cast<size_type>(-1);
+        }
+
+        /**
+         * Deallocate all nodes.
+         */
+        void clear() noexcept {
+            if (m_root) {
+                destroy_subtree(m_root);
+            }
+            m_root = nullptr;
+            m_leftmost = nullptr;
+            m_rightmost = nullptr;
+            m_size = 0;
+        }
+
+        /**
+         * Insert an element if its key is not already in the tree.
+         *
+         * @param element the element to insert
+         * @return a pair of an iterator to the inserted element or to the
+         * element with the same key, and whether the element was inserted;
+         * the iterator is pass-the-end if a node could not be allocated
+         */
+        template<typename E>
+        pair<iterator, bool> insert_unique(E &&element);
+
+        /**
+         * Erase the element at the given position.
+         *
+         * @param pos iterator to the element to erase
+         * @return iterator to the next element
+         */
+        iterator erase(const iterator &pos);
+
+        /**
+         * Erase the element with the given key.
+         *
+         * @param key the key to erase
+         * @return the number of erased elements
+         */
+        size_type erase(const key_type &key) {
+            iterator it = find(key);
+            if (it == end()) {
+                return 0;
+            }
+            erase(it);
+            return 1;
+        }
+
+        /**
+         * Erase the elements in a range.
+         *
+         * @param first iterator to the first element to erase
+         * @param last  iterator past the last element to erase
+         * @return the number of erased elements
+         */
+        size_type erase(const iterator &first, const iterator &last) {
+            if (first == begin() && last == end()) {
+                size_type count = m_size;
+                clear();
+                return count;
+            }
+            // erasing moves elements, so count the range first
+            size_type count = 0;
+            for (iterator it = first; it != last; ++it) {
+                ++count;
+            }
+            iterator it = first;
+            for (size_type i = 0; i < count; ++i) {
+                it = erase(it);
+            }
+            return count;
+        }
+
+        /**
+         * @param key the key to find
+         * @return iterator to the element with the key, or pass-the-end
+         */
+        iterator find(const key_type &key) {
+            node_type *node = m_root;
+            while (node) {
+                size_type i = lower_index(node, key);
+                if (i < node->m_count && !m_cmp.__lt__(key, m_get_key(node->m_elements[i]))) {
+                    return iterator(node, i);
+                }
+                node = node->m_leaf ? nullptr : node->child(i);
+            }
+            return end();
+        }
+
+        /**
+         * @param key the key to find
+         * @return constant iterator to the element with the key, or pass-the-end
+         */
+        const_iterator find(const key_type &key) const {
+            iterator it = const_cast<tree_type *>(this)->find(key);
+            return const_iterator(it.m_node, it.m_index);
+        }
+
+        /**
+         * @param key the key to count
+         * @return the number of elements with the key, which is zero or one
+         */
+        size_type count(const key_type &key) const {
+            return find(key) == end() ? 0 : 1;
+        }
+
+        /**
+         * @param key key to compare
+         * @return iterator to the first element whose key is not less than the key
+         */
+        iterator lower_bound(const key_type &key) {
+            iterator res = end();
+            node_type *node = m_root;
+            while (node) {
+                size_type i = lower_index(node, key);
+                if (i < node->m_count) {
+                    res = iterator(node, i);
+                }
+                node = node->m_leaf ? nullptr : node->child(i);
+            }
+            return res;
+        }
+
+        /**
+         * @param key key to compare
+         * @return constant iterator to the first element whose key is not less than the key
+         */
+        const_iterator lower_bound(const key_type &key) const {
+            iterator it = const_cast<tree_type *>(this)->lower_bound(key);
+            return const_iterator(it.m_node, it.m_index);
+        }
+
+        /**
+         * @param key key to compare
+         * @return iterator to the first element whose key is greater than the key
+         */
+        iterator upper_bound(const key_type &key) {
+            iterator res = end();
+            node_type *node = m_root;
+            while (node) {
+                size_type i = upper_index(node, key);
+                if (i < node->m_count) {
+                    res = iterator(node, i);
+                }
+                node = node->m_leaf ? nullptr : node->child(i);
+            }
+            return res;
+        }
+
+        /**
+         * @param key key to compare
+         * @return constant iterator to the first element whose key is greater than the key
+         */
+        const_iterator upper_bound(const key_type &key) const {
+            iterator it = const_cast<tree_type *>(this)->upper_bound(key);
+            return const_iterator(it.m_node, it.m_index);
+        }
+
+        /**
+         * @param key key to compare
+         * @return the range of elements with the key
+         */
+        pair<iterator, iterator> equal_range(const key_type &key) {
+            return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        /**
+         * @param key key to compare
+         * @return the constant range of elements with the key
+         */
+        pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this tree
+         */
+        tree_type &operator=(const tree_type &) = delete;
+
+        /**
+         * Move assignment operator. Elements in this tree are freed.
+         *
+         * @param tree the tree to move
+         * @return reference to this tree
+         */
+        tree_type &operator=(tree_type &&tree) {
+            clear();
+            m_root = tree.m_root;
+            m_leftmost = tree.m_leftmost;
+            m_rightmost = tree.m_rightmost;
+            m_size = tree.m_size;
+            tree.m_root = nullptr;
+            tree.m_leftmost = nullptr;
+            tree.m_rightmost = nullptr;
+            tree.m_size = 0;
+            return *this;
+        }
+
+    private:
+        /**
+         * @param leaf whether to allocate a leaf node
+         * @return a new empty node, or null if allocation failed
+         */
+        node_type *create_node(bool leaf) {
+            node_type *node = leaf
+                              ? create<node_type>()
+                              : static_cast<node_type *>(create<internal_type>());
+            if (node) {
+                node->m_parent = nullptr;
+                node->m_position = 0;
+                node->m_count = 0;
+                node->m_leaf = leaf;
+            }
+            return node;
+        }
+
+        /**
+         * Deallocate a node.
+         *
+         * @param node the node to deallocate
+         */
+        void destroy_node(node_type *node) {
+            if (node->m_leaf) {
+                destroy<node_type>(node);
+            } else {
+                destroy<internal_type>(static_cast<internal_type *>(node));
+            }
+        }
+
+        /**
+         * Deallocate a node and its descendants. The recursion
+         * depth is the height of the tree, which is small.
+         *
+         * @param node the subtree root
+         */
+        void destroy_subtree(node_type *node) {
+            if (!node->m_leaf) {
+                for (size_type i = 0; i <= node->m_count; ++i) {
+                    destroy_subtree(node->child(i));
+                }
+            }
+            destroy_node(node);
+        }
+
+        /**
+         * @param node the node to search
+         * @param key  key to compare
+         * @return index of the first element not less than the key
+         */
+        size_type lower_index(node_type *node, const key_type &key) const {
+            size_type lo = 0;
+            size_type hi = node->m_count;
+            while (lo < hi) {
+                size_type mid = (lo + hi) / 2;
+                if (m_cmp.__lt__(m_get_key(node->m_elements[mid]), key)) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+
+        /**
+         * @param node the node to search
+         * @param key  key to compare
+         * @return index of the first element greater than the key
+         */
+        size_type upper_index(node_type *node, const key_type &key) const {
+            size_type lo = 0;
+            size_type hi = node->m_count;
+            while (lo < hi) {
+                size_type mid = (lo + hi) / 2;
+                if (m_cmp.__lt__(key, m_get_key(node->m_elements[mid]))) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            return lo;
+        }
+
+        /**
+         * Set a child pointer of an internal node and
+         * update the child's parent and position.
+         *
+         * @param parent the internal node
+         * @param i      the child index
+         * @param child  the child node
+         */
+        static void set_child(node_type *parent, size_type i, node_type *child) {
+            parent->child(i) = child;
+            child->m_parent = parent;
+            child->m_position = static_cast<count_type>(i);
+        }
+
+        /**
+         * Split the full child of a node in two, moving
+         * the median element up into the node.
+         *
+         * @param parent a node that is not full
+         * @param i      the index of the full child
+         * @return false if the new node could not be allocated
+         */
+        bool split_child(node_type *parent, size_type i);
+
+        /**
+         * Move an element from the left sibling through the parent
+         * into the front of the right sibling.
+         *
+         * @param parent the parent node
+         * @param k      the index of the parent element between the siblings
+         */
+        void rotate_right(node_type *parent, size_type k);
+
+        /**
+         * Move an element from the right sibling through the parent
+         * into the back of the left sibling.
+         *
+         * @param parent the parent node
+         * @param k      the index of the parent element between the siblings
+         */
+        void rotate_left(node_type *parent, size_type k);
+
+        /**
+         * Merge two siblings and the parent element between them
+         * into the left sibling, deallocating the right sibling.
+         *
+         * @param parent the parent node
+         * @param k      the index of the parent element between the siblings
+         */
+        void merge_children(node_type *parent, size_type k);
+
+        /**
+         * Restore the minimum element count of a node after
+         * an erasure, proceeding upwards as nodes are merged.
+         *
+         * @param node the node that lost an element
+         */
+        void rebalance(node_type *node);
+    };
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    constexpr size_t btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>::slots;
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    constexpr size_t btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>::min_count;
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    bool btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::split_child(node_type *parent, size_type i) {
+        node_type *child = parent->child(i);
+        node_type *right = create_node(child->m_leaf);
+        if (!right) {
+            return false;
+        }
+        size_type mid = slots / 2;
+        size_type count = slots - mid - 1;
+        for (size_type j = 0; j < count; ++j) {
+            right->m_elements[j] = move(child->m_elements[mid + 1 + j]);
+        }
+        if (!child->m_leaf) {
+            for (size_type j = 0; j <= count; ++j) {
+                set_child(right, j, child->child(mid + 1 + j));
+            }
+        }
+        right->m_count = static_cast<count_type>(count);
+        child->m_count = static_cast<count_type>(mid);
+        for (size_type j = parent->m_count; j > i; --j) {
+            parent->m_elements[j] = move(parent->m_elements[j - 1]);
+        }
+        for (size_type j = parent->m_count + 1u; j > i + 1; --j) {
+            set_child(parent, j, parent->child(j - 1));
+        }
+        parent->m_elements[i] = move(child->m_elements[mid]);
+        set_child(parent, i + 1, right);
+        ++parent->m_count;
+        if (child == m_rightmost) {
+            m_rightmost = right;
+        }
+        return true;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    template<typename E>
+    pair<typename btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>::iterator, bool>
+    btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::insert_unique(E &&element) {
+        const key_type &key = m_get_key(element);
+        if (!m_root) {
+            m_root = create_node(true);
+            if (!m_root) {
+                return pair<iterator, bool>(end(), false);
+            }
+            m_leftmost = m_root;
+            m_rightmost = m_root;
+        }
+        if (m_root->m_count == slots) {
+            node_type *root = create_node(false);
+            if (!root) {
+                return pair<iterator, bool>(end(), false);
+            }
+            set_child(root, 0, m_root);
+            if (!split_child(root, 0)) {
+                m_root->m_parent = nullptr;
+                destroy_node(root);
+                return pair<iterator, bool>(end(), false);
+            }
+            m_root = root;
+        }
+        node_type *node = m_root;
+        while (true) {
+            size_type i = lower_index(node, key);
+            if (i < node->m_count && !m_cmp.__lt__(key, m_get_key(node->m_elements[i]))) {
+                return pair<iterator, bool>(iterator(node, i), false);
+            }
+            if (node->m_leaf) {
+                for (size_type j = node->m_count; j > i; --j) {
+                    node->m_elements[j] = move(node->m_elements[j - 1]);
+                }
+                node->m_elements[i] = forward<E>(element);
+                ++node->m_count;
+                ++m_size;
+                return pair<iterator, bool>(iterator(node, i), true);
+            }
+            if (node->child(i)->m_count == slots) {
+                if (!split_child(node, i)) {
+                    return pair<iterator, bool>(end(), false);
+                }
+                // the median moved up into this node
+                if (!m_cmp.__lt__(key, m_get_key(node->m_elements[i]))) {
+                    if (!m_cmp.__lt__(m_get_key(node->m_elements[i]), key)) {
+                        return pair<iterator, bool>(iterator(node, i), false);
+                    }
+                    ++i;
+                }
+            }
+            node = node->child(i);
+        }
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    void btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::rotate_right(node_type *parent, size_type k) {
+        node_type *left = parent->child(k);
+        node_type *right = parent->child(k + 1);
+        for (size_type j = right->m_count; j > 0; --j) {
+            right->m_elements[j] = move(right->m_elements[j - 1]);
+        }
+        right->m_elements[0] = move(parent->m_elements[k]);
+        parent->m_elements[k] = move(left->m_elements[left->m_count - 1]);
+        if (!right->m_leaf) {
+            for (size_type j = right->m_count + 1u; j > 0; --j) {
+                set_child(right, j, right->child(j - 1));
+            }
+            set_child(right, 0, left->child(left->m_count));
+        }
+        --left->m_count;
+        ++right->m_count;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    void btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::rotate_left(node_type *parent, size_type k) {
+        node_type *left = parent->child(k);
+        node_type *right = parent->child(k + 1);
+        left->m_elements[left->m_count] = move(parent->m_elements[k]);
+        parent->m_elements[k] = move(right->m_elements[0]);
+        for (size_type j = 1; j < right->m_count; ++j) {
+            right->m_elements[j - 1] = move(right->m_elements[j]);
+        }
+        if (!left->m_leaf) {
+            set_child(left, left->m_count + 1u, right->child(0));
+            for (size_type j = 1; j <= right->m_count; ++j) {
+                set_child(right, j - 1, right->child(j));
+            }
+        }
+        ++left->m_count;
+        --right->m_count;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    void btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::merge_children(node_type *parent, size_type k) {
+        node_type *left = parent->child(k);
+        node_type *right = parent->child(k + 1);
+        size_type base = left->m_count;
+        left->m_elements[base] = move(parent->m_elements[k]);
+        for (size_type j = 0; j < right->m_count; ++j) {
+            left->m_elements[base + 1 + j] = move(right->m_elements[j]);
+        }
+        if (!left->m_leaf) {
+            for (size_type j = 0; j <= right->m_count; ++j) {
+                set_child(left, base + 1 + j, right->child(j));
+            }
+        }
+        left->m_count = static_cast<count_type>(base + 1 + right->m_count);
+        for (size_type j = k + 1; j < parent->m_count; ++j) {
+            parent->m_elements[j - 1] = move(parent->m_elements[j]);
+        }
+        for (size_type j = k + 2; j <= parent->m_count; ++j) {
+            set_child(parent, j - 1, parent->child(j));
+        }
+        --parent->m_count;
+        if (right == m_rightmost) {
+            m_rightmost = left;
+        }
+        destroy_node(right);
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    void btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::rebalance(node_type *node) {
+        while (node != m_root && node->m_count < min_count) {
+            node_type *parent = node->m_parent;
+            size_type pos = node->m_position;
+            if (pos > 0 && parent->child(pos - 1)->m_count > min_count) {
+                rotate_right(parent, pos - 1);
+                return;
+            }
+            if (pos < parent->m_count && parent->child(pos + 1)->m_count > min_count) {
+                rotate_left(parent, pos);
+                return;
+            }
+            merge_children(parent, pos > 0 ? pos - 1 : pos);
+            node = parent;
+        }
+        if (m_root->m_count == 0) {
+            node_type *root = m_root;
+            if (root->m_leaf) {
+                m_root = nullptr;
+                m_leftmost = nullptr;
+                m_rightmost = nullptr;
+            } else {
+                m_root = root->child(0);
+                m_root->m_parent = nullptr;
+                m_root->m_position = 0;
+            }
+            destroy_node(root);
+        }
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, size_t NodeBytes>
+    typename btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>::iterator
+    btree<Element, Key, Val, GetKey, GetVal, Cmp, NodeBytes>
+    ::erase(const iterator &pos) {
+        node_type *node = pos.m_node;
+        size_type i = pos.m_index;
+        if (!node || i >= node->m_count) {
+            return end();
+        }
+        // keep the erased element to find its successor afterwards
+        element_type removed(move(node->m_elements[i]));
+        if (!node->m_leaf) {
+            // replace with the predecessor, which is in a leaf
+            node_type *leaf = node_type::find_maximum(node->child(i));
+            node->m_elements[i] = move(leaf->m_elements[leaf->m_count - 1]);
+            node = leaf;
+            i = static_cast<size_type>(leaf->m_count - 1);
+        }
+        for (size_type j = i + 1; j < node->m_count; ++j) {
+            node->m_elements[j - 1] = move(node->m_elements[j]);
+        }
+        --node->m_count;
+        node->m_elements[node->m_count] = element_type();
+        --m_size;
+        rebalance(node);
+        return lower_bound(m_get_key(removed));
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BTREE_H
@@ -0,0 +1,180 @@
+/**
+ * @file BTreeMap.h
+ * @brief Map implementation using a B-tree.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BTREEMAP_H
+#define EMBEDDEDCPLUSPLUS_BTREEMAP_H
+
+#include <wlib/stl/BTree.h>
+#include <wlib/stl/Table.h>
+#include <wlib/stl/Tuple.h>
+
+namespace wlp {
+
+    /**
+     * Map implementation using @code btree @endcode as the backing
+     * data structure, with the same interface as @code tree_map @endcode.
+     * Insertion and erasure invalidate all iterators.
+     *
+     * @see wlp::tree_map
+     * @see wlp::btree
+     *
+     * @tparam Key       key type
+     * @tparam Val       value type
+     * @tparam Cmp       key comparator type, which uses the default comparator
+     * @tparam NodeBytes target size of a tree node in bytes
+     */
+    template<typename Key, typename Val, typename Cmp = comparator<Key>, size_t NodeBytes = 256>
+    class btree_map {
+    public:
+        typedef btree_map<Key, Val, Cmp, NodeBytes> map_type;
+        typedef btree<tuple<Key, Val>,
+                Key, Val,
+                MapGetKey<Key, Val>, MapGetVal<Key, Val>,
+                Cmp, NodeBytes
+        > table_type;
+        typedef typename table_type::iterator iterator;
+        typedef typename table_type::const_iterator const_iterator;
+        typedef typename table_type::size_type size_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+    private:
+        table_type m_table;
+
+    public:
+        explicit btree_map()
+                : m_table() {
+        }
+
+        btree_map(const map_type &) = delete;
+
+        btree_map(map_type &&map)
+                : m_table(move(map.m_table)) {
+        }
+
+        size_type size() const {
+            return m_table.size();
+        }
+
+        size_type capacity() const {
+            return m_table.capacity();
+        }
+
+        bool empty() const {
+            return m_table.empty();
+        }
+
+        const table_type *get_backing_table() const {
+            return &m_table;
+        }
+
+        iterator begin() {
+            return m_table.begin();
+        }
+
+        const_iterator begin() const {
+            return m_table.begin();
+        }
+
+        iterator end() {
+            return m_table.end();
+        }
+
+        const_iterator end() const {
+            return m_table.end();
+        }
+
+        void clear() noexcept {
+            m_table.clear();
+        }
+
+        template<typename K, typename V>
+        pair<iterator, bool> insert(K &&key, V &&val) {
+            return m_table.insert_unique(make_tuple(forward<K>(key), forward<V>(val)));
+        };
+
+        template<typename K, typename V>
+        pair<iterator, bool> insert_or_assign(K &&key, V &&val) {
+            iterator it = m_table.find(key);
+            if (it == m_table.end()) {
+                return m_table.insert_unique(make_tuple(forward<K>(key), forward<V>(val)));
+            } else {
+                *it = forward<V>(val);
+                return pair<iterator, bool>(it, false);
+            }
+        };
+
+        iterator erase(const iterator &pos) {
+            return m_table.erase(pos);
+        }
+
+        bool erase(const key_type &key) {
+            return m_table.erase(key) > 0;
+        }
+
+        val_type &at(const key_type &key) {
+            return *m_table.find(key);
+        }
+
+        const val_type &at(const key_type &key) const {
+            return *m_table.find(key);
+        }
+
+        bool contains(const key_type &key) const {
+            return m_table.find(key) != m_table.end();
+        }
+
+        iterator find(const key_type &key) {
+            return m_table.find(key);
+        }
+
+        const_iterator find(const key_type &key) const {
+            return m_table.find(key);
+        }
+
+        iterator lower_bound(const key_type &key) {
+            return m_table.lower_bound(key);
+        }
+
+        const_iterator lower_bound(const key_type &key) const {
+            return m_table.lower_bound(key);
+        }
+
+        iterator upper_bound(const key_type &key) {
+            return m_table.upper_bound(key);
+        }
+
+        const_iterator upper_bound(const key_type &key) const {
+            return m_table.upper_bound(key);
+        }
+
+        pair<iterator, iterator> equal_range(const key_type &key) {
+            return m_table.equal_range(key);
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            return m_table.equal_range(key);
+        }
+
+        template<typename K>
+        val_type &operator[](K &&key) {
+            pair<iterator, bool> result = m_table.insert_unique(make_tuple(forward<K>(key), val_type()));
+            return *result.m_first;
+        }
+
+        map_type &operator=(const map_type &) = delete;
+
+        map_type &operator=(map_type &&map) {
+            m_table = move(map.m_table);
+            return *this;
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BTREEMAP_H
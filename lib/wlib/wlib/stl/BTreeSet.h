@@ -0,0 +1,153 @@
+/**
+ * @file BTreeSet.h
+ * @brief Set implementation using a B-tree.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BTREESET_H
+#define EMBEDDEDCPLUSPLUS_BTREESET_H
+
+#include <wlib/stl/BTree.h>
+#include <wlib/stl/Table.h>
+
+namespace wlp {
+
+    /**
+     * Set implementation using @code btree @endcode as the backing
+     * data structure, with the same interface as @code tree_set @endcode.
+     * Insertion and erasure invalidate all iterators.
+     *
+     * @see wlp::tree_set
+     * @see wlp::btree
+     *
+     * @tparam Key       stored value type
+     * @tparam Cmp       comparator for stored value, which uses the default comparator
+     * @tparam NodeBytes target size of a tree node in bytes
+     */
+    template<typename Key, typename Cmp = comparator<Key>, size_t NodeBytes = 256>
+    class btree_set {
+    public:
+        typedef btree_set<Key, Cmp, NodeBytes> set_type;
+        typedef btree<Key,
+                Key, Key,
+                SetGetKey<Key>, SetGetVal<Key>,
+                Cmp, NodeBytes
+        > table_type;
+        typedef typename table_type::iterator iterator;
+        typedef typename table_type::const_iterator const_iterator;
+        typedef typename table_type::size_type size_type;
+
+        typedef Key key_type;
+
+    private:
+        table_type m_table;
+
+    public:
+        explicit btree_set()
+                : m_table() {
+        }
+
+        btree_set(const set_type &) = delete;
+
+        btree_set(set_type &&set)
+                : m_table(move(set.m_table)) {
+        }
+
+        size_type size() const {
+            return m_table.size();
+        }
+
+        size_type capacity() const {
+            return m_table.capacity();
+        }
+
+        bool empty() const {
+            return m_table.empty();
+        }
+
+        const table_type *get_backing_table() const {
+            return &m_table;
+        }
+
+        iterator begin() {
+            return m_table.begin();
+        }
+
+        const_iterator begin() const {
+            return m_table.begin();
+        }
+
+        iterator end() {
+            return m_table.end();
+        }
+
+        const_iterator end() const {
+            return m_table.end();
+        }
+
+        void clear() noexcept {
+            m_table.clear();
+        }
+
+        template<typename K>
+        pair<iterator, bool> insert(K &&key) {
+            return m_table.insert_unique(forward<K>(key));
+        };
+
+        bool contains(const key_type &key) const {
+            return m_table.find(key) != m_table.end();
+        }
+
+        iterator find(const key_type &key) {
+            return m_table.find(key);
+        }
+
+        const_iterator find(const key_type &key) const {
+            return m_table.find(key);
+        }
+
+        iterator lower_bound(const key_type &key) {
+            return m_table.lower_bound(key);
+        }
+
+        const_iterator lower_bound(const key_type &key) const {
+            return m_table.lower_bound(key);
+        }
+
+        iterator upper_bound(const key_type &key) {
+            return m_table.upper_bound(key);
+        }
+
+        const_iterator upper_bound(const key_type &key) const {
+            return m_table.upper_bound(key);
+        }
+
+        pair<iterator, iterator> equal_range(const key_type &key) {
+            return m_table.equal_range(key);
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            return m_table.equal_range(key);
+        }
+
+        iterator erase(const iterator &pos) {
+            return m_table.erase(pos);
+        }
+
+        bool erase(const key_type &key) {
+            return m_table.erase(key) > 0;
+        }
+
+        set_type &operator=(const set_type &) = delete;
+
+        set_type &operator=(set_type &&set) {
+            m_table = move(set.m_table);
+            return *this;
+        }
+
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BTREESET_H
@@ -0,0 +1,108 @@
+/**
+ * @file BinarySearch.h
+ * @brief Binary search over sorted contiguous arrays.
+ *
+ * The searches halve the remaining range with a conditional move
+ * of the base pointer rather than a branch on the comparison, so
+ * that the loop runs the same number of iterations for every key
+ * and does not suffer branch mispredictions on random lookups.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_BINARYSEARCH_H
+#define EMBEDDEDCPLUSPLUS_BINARYSEARCH_H
+
+#include <stddef.h>
+
+#include <wlib/stl/Comparator.h>
+
+namespace wlp {
+
+    /**
+     * Find the first position in a sorted array whose element
+     * is not less than a key.
+     *
+     * @tparam T   element type
+     * @tparam Cmp comparator type
+     * @param data sorted array
+     * @param n    number of elements in the array
+     * @param key  key to search
+     * @param cmp  comparator
+     * @return the index of the first element not less than the key,
+     * or n if there is none
+     */
+    template<typename T, typename Cmp>
+    inline size_t lower_bound_index(const T *data, size_t n, const T &key, const Cmp &cmp) {
+        if (n == 0) {
+            return 0;
+        }
+        const T *base = data;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = cmp.__lt__(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_t>(base - data) + cmp.__lt__(*base, key);
+    }
+
+    /**
+     * Find the first position in a sorted array whose element
+     * is greater than a key.
+     *
+     * @tparam T   element type
+     * @tparam Cmp comparator type
+     * @param data sorted array
+     * @param n    number of elements in the array
+     * @param key  key to search
+     * @param cmp  comparator
+     * @return the index of the first element greater than the key,
+     * or n if there is none
+     */
+    template<typename T, typename Cmp>
+    inline size_t upper_bound_index(const T *data, size_t n, const T &key, const Cmp &cmp) {
+        if (n == 0) {
+            return 0;
+        }
+        const T *base = data;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = cmp.__lt__(key, base[half]) ? base : base + half;
+            n -= half;
+        }
+        return static_cast<size_t>(base - data) + !cmp.__lt__(key, *base);
+    }
+
+    /**
+     * Find the first position in a sorted array whose element
+     * is not less than a key, using the default comparator.
+     *
+     * @tparam T element type
+     * @param data sorted array
+     * @param n    number of elements in the array
+     * @param key  key to search
+     * @return the index of the first element not less than the key
+     */
+    template<typename T>
+    inline size_t lower_bound_index(const T *data, size_t n, const T &key) {
+        return lower_bound_index(data, n, key, comparator<T>());
+    }
+
+    /**
+     * Find the first position in a sorted array whose element
+     * is greater than a key, using the default comparator.
+     *
+     * @tparam T element type
+     * @param data sorted array
+     * @param n    number of elements in the array
+     * @param key  key to search
+     * @return the index of the first element greater than the key
+     */
+    template<typename T>
+    inline size_t upper_bound_index(const T *data, size_t n, const T &key) {
+        return upper_bound_index(data, n, key, comparator<T>());
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_BINARYSEARCH_H
@@ -145,6 +145,36 @@ namespace wlp {
         }
     };
 
+    /**
+     * Template specialization for string views.
+     */
+    template<>
+    struct comparator<string_view> {
+        bool __lt__(string_view s1, string_view s2) const {
+            return s1.compare(s2) < 0;
+        }
+
+        bool __le__(string_view s1, string_view s2) const {
+            return s1.compare(s2) <= 0;
+        }
+
+        bool __eq__(string_view s1, string_view s2) const {
+            return s1 == s2;
+        }
+
+        bool __ne__(string_view s1, string_view s2) const {
+            return s1 != s2;
+        }
+
+        bool __gt__(string_view s1, string_view s2) const {
+            return s1.compare(s2) > 0;
+        }
+
+        bool __ge__(string_view s1, string_view s2) const {
+            return s1.compare(s2) >= 0;
+        }
+    };
+
 }
 
 #endif //EMBEDDEDCPLUSPLUS_COMPARATOR_H
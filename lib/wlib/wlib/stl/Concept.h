@@ -432,8 +432,14 @@ namespace wlp {
                 HAS_FCN(T, insert, const iterator &, const val_type &, iterator),
                 HAS_FCN(T, erase, size_type, iterator),
                 HAS_FCN(T, erase, const iterator &, iterator),
-                HAS_FCN(T, push_back, const val_type &, void),
-                HAS_FCN(T, push_front, const val_type &, void),
+                typename or_<
+                        HAS_FCN(T, push_back, const val_type &, void),
+                        HAS_FCN(T, push_back, const val_type &, bool)
+                >::type,
+                typename or_<
+                        HAS_FCN(T, push_front, const val_type &, void),
+                        HAS_FCN(T, push_front, const val_type &, bool)
+                >::type,
                 HAS_FCN(T, pop_back, void),
                 HAS_FCN(T, pop_front, void),
                 HAS_FCN(const T, index_of, const val_type &, size_type),
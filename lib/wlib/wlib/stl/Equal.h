@@ -66,6 +66,16 @@ namespace wlp {
         }
     };
 
+    /**
+     * Template specialization for string views.
+     */
+    template<>
+    struct equals<string_view> {
+        bool operator()(string_view str1, string_view str2) const {
+            return str1 == str2;
+        }
+    };
+
     /**
      * Template specialization for character arrays.
      */
@@ -0,0 +1,677 @@
+/**
+ * @file FlatMap.h
+ * @brief Sorted map stored in contiguous arrays.
+ *
+ * A flat map keeps its keys and values sorted in two parallel
+ * array lists. Lookups are a binary search over the key array,
+ * which touches a small, contiguous region of memory, and
+ * iteration is a linear walk. Insertion and erasure shift the
+ * elements after the position, so the map suits tables that are
+ * built once, or in sorted batches, and then mostly read.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_FLATMAP_H
+#define EMBEDDEDCPLUSPLUS_FLATMAP_H
+
+#include <stddef.h>
+
+#include <wlib/utility>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/BinarySearch.h>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Pair.h>
+#include <wlib/stl/Tuple.h>
+
+namespace wlp {
+
+    /**
+     * Iterator over the elements of a flat map. The iterator
+     * holds a pointer into the key array and a pointer into the
+     * value array, and dereferences to the value.
+     *
+     * @tparam Key key type
+     * @tparam Val value type
+     * @tparam Ref reference to value type, which may be constant
+     * @tparam Ptr pointer to value type, which may be constant
+     */
+    template<typename Key, typename Val, typename Ref, typename Ptr>
+    struct FlatMapIterator {
+        typedef Key key_type;
+        typedef Val val_type;
+        typedef Ref reference;
+        typedef Ptr pointer;
+        typedef size_t size_type;
+        typedef ptrdiff_t diff_type;
+        typedef FlatMapIterator<Key, Val, Ref, Ptr> self_type;
+
+        /**
+         * Pointer to the key of the current element.
+         */
+        const key_type *m_key;
+        /**
+         * Pointer to the value of the current element.
+         */
+        pointer m_val;
+
+        /**
+         * Default constructor.
+         */
+        FlatMapIterator()
+                : m_key(nullptr),
+                  m_val(nullptr) {}
+
+        /**
+         * Create an iterator to an element.
+         *
+         * @param key pointer to the key of the element
+         * @param val pointer to the value of the element
+         */
+        FlatMapIterator(const key_type *key, pointer val)
+                : m_key(key),
+                  m_val(val) {}
+
+        /**
+         * Copy constructor.
+         *
+         * @param it iterator to copy
+         */
+        FlatMapIterator(const self_type &it)
+                : m_key(it.m_key),
+                  m_val(it.m_val) {}
+
+        /**
+         * @return the key of the current element
+         */
+        const key_type &key() const {
+            return *m_key;
+        }
+
+        /**
+         * @return reference to the value of the current element
+         */
+        reference operator*() const {
+            return *m_val;
+        }
+
+        /**
+         * @return pointer to the value of the current element
+         */
+        pointer operator->() const {
+            return m_val;
+        }
+
+        /**
+         * Move the iterator to the next element.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator++() {
+            ++m_key;
+            ++m_val;
+            return *this;
+        }
+
+        /**
+         * Post-fix increment operator.
+         *
+         * @return copy of the iterator before incrementing
+         */
+        self_type operator++(int) {
+            self_type clone(*this);
+            ++m_key;
+            ++m_val;
+            return clone;
+        }
+
+        /**
+         * Move the iterator to the previous element.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator--() {
+            --m_key;
+            --m_val;
+            return *this;
+        }
+
+        /**
+         * Post-fix decrement operator.
+         *
+         * @return copy of the iterator before decrementing
+         */
+        self_type operator--(int) {
+            self_type clone(*this);
+            --m_key;
+            --m_val;
+            return clone;
+        }
+
+        /**
+         * @param n number of elements to advance
+         * @return an iterator advanced by the given number of elements
+         */
+        self_type operator+(diff_type n) const {
+            return self_type(m_key + n, m_val + n);
+        }
+
+        /**
+         * @param n number of elements to retreat
+         * @return an iterator moved back by the given number of elements
+         */
+        self_type operator-(diff_type n) const {
+            return self_type(m_key - n, m_val - n);
+        }
+
+        /**
+         * @param it iterator into the same map
+         * @return the number of elements between the iterators
+         */
+        diff_type operator-(const self_type &it) const {
+            return m_key - it.m_key;
+        }
+
+        /**
+         * Equality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to the same element
+         */
+        bool operator==(const self_type &it) const {
+            return m_key == it.m_key;
+        }
+
+        /**
+         * Inequality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to different elements
+         */
+        bool operator!=(const self_type &it) const {
+            return m_key != it.m_key;
+        }
+
+        /**
+         * Assignment operator.
+         *
+         * @param it iterator to copy
+         * @return reference to this iterator
+         */
+        self_type &operator=(const self_type &it) {
+            m_key = it.m_key;
+            m_val = it.m_val;
+            return *this;
+        }
+    };
+
+    /**
+     * Map implementation over two sorted array lists, one for
+     * the keys and one for the values. Keys are unique. The key
+     * array is contiguous, so searches and key scans stay within
+     * cache lines that hold nothing but keys.
+     *
+     * @see wlp::tree_map
+     *
+     * @tparam Key key type
+     * @tparam Val value type
+     * @tparam Cmp key comparator type, which uses the default comparator
+     */
+    template<typename Key, typename Val, typename Cmp = comparator<Key>>
+    class flat_map {
+    public:
+        typedef flat_map<Key, Val, Cmp> map_type;
+        typedef array_list<Key> key_list;
+        typedef array_list<Val> val_list;
+        typedef FlatMapIterator<Key, Val, Val &, Val *> iterator;
+        typedef FlatMapIterator<Key, Val, const Val &, const Val *> const_iterator;
+        typedef size_t size_type;
+
+        typedef Key key_type;
+        typedef Val val_type;
+
+    private:
+        /**
+         * The sorted keys.
+         */
+        key_list m_keys;
+        /**
+         * The values, in the order of their keys.
+         */
+        val_list m_vals;
+        /**
+         * Key comparator.
+         */
+        Cmp m_cmp;
+
+        /**
+         * @param key key to search
+         * @return the index of the first key not less than the key
+         */
+        size_type lower_index(const key_type &key) const {
+            return lower_bound_index(m_keys.data(), m_keys.size(), key, m_cmp);
+        }
+
+        /**
+         * @param key key to search
+         * @return the index of the key, or the size of the map if absent
+         */
+        size_type find_index(const key_type &key) const {
+            size_type i = lower_index(key);
+            if (i == m_keys.size() || m_cmp.__lt__(key, m_keys.data()[i])) {
+                return m_keys.size();
+            }
+            return i;
+        }
+
+        /**
+         * Insert a key and value at a position, shifting the later
+         * elements. The arrays are left unchanged on failure.
+         *
+         * @param i   position at which to insert
+         * @param key key to insert
+         * @param val value to insert
+         * @return true if the element was inserted
+         */
+        template<typename K, typename V>
+        bool insert_at(size_type i, K &&key, V &&val) {
+            if (i == m_keys.size()) {
+                if (!m_keys.push_back(forward<K>(key))) {
+                    return false;
+                }
+                if (!m_vals.push_back(forward<V>(val))) {
+                    m_keys.pop_back();
+                    return false;
+                }
+                return true;
+            }
+            if (m_keys.insert(i, forward<K>(key)) == m_keys.end()) {
+                return false;
+            }
+            if (m_vals.insert(i, forward<V>(val)) == m_vals.end()) {
+                m_keys.erase(i);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @param i element index
+         * @return iterator to the element
+         */
+        iterator make_iterator(size_type i) {
+            return iterator(m_keys.data() + i, m_vals.data() + i);
+        }
+
+        /**
+         * @param i element index
+         * @return constant iterator to the element
+         */
+        const_iterator make_iterator(size_type i) const {
+            return const_iterator(m_keys.data() + i, m_vals.data() + i);
+        }
+
+    public:
+        /**
+         * Create an empty map.
+         *
+         * @param initial_capacity the initial size of the backing arrays
+         */
+        explicit flat_map(size_type initial_capacity = 12)
+                : m_keys(initial_capacity),
+                  m_vals(initial_capacity),
+                  m_cmp() {}
+
+        /**
+         * Create a map from a range of key and value tuples
+         * sorted by key.
+         *
+         * @tparam It forward iterator type
+         * @param first the first element
+         * @param last  pass-the-end of the range
+         */
+        template<typename It>
+        flat_map(It first, It last)
+                : m_keys(),
+                  m_vals(),
+                  m_cmp() {
+            insert_sorted(first, last);
+        }
+
+        flat_map(const map_type &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param map map whose arrays to transfer
+         */
+        flat_map(map_type &&map)
+                : m_keys(move(map.m_keys)),
+                  m_vals(move(map.m_vals)),
+                  m_cmp() {}
+
+        /**
+         * @return the number of elements in the map
+         */
+        size_type size() const {
+            return m_keys.size();
+        }
+
+        /**
+         * @return the number of elements the map holds before growing
+         */
+        size_type capacity() const {
+            return m_keys.capacity();
+        }
+
+        /**
+         * @return true if the map is empty
+         */
+        bool empty() const {
+            return m_keys.empty();
+        }
+
+        /**
+         * @return the sorted key array
+         */
+        const key_list &keys() const {
+            return m_keys;
+        }
+
+        /**
+         * @return the value array, in key order
+         */
+        const val_list &values() const {
+            return m_vals;
+        }
+
+        iterator begin() {
+            return make_iterator(0);
+        }
+
+        const_iterator begin() const {
+            return make_iterator(0);
+        }
+
+        iterator end() {
+            return make_iterator(m_keys.size());
+        }
+
+        const_iterator end() const {
+            return make_iterator(m_keys.size());
+        }
+
+        void clear() noexcept {
+            m_keys.clear();
+            m_vals.clear();
+        }
+
+        /**
+         * Grow the backing arrays to hold at least the given
+         * number of elements.
+         *
+         * @param new_capacity the number of elements to reserve
+         */
+        void reserve(size_type new_capacity) {
+            m_keys.reserve(new_capacity);
+            m_vals.reserve(new_capacity);
+        }
+
+        /**
+         * Shrink the backing arrays to the number of elements.
+         */
+        void shrink() {
+            m_keys.shrink();
+            m_vals.shrink();
+        }
+
+        /**
+         * Insert a range of key and value tuples sorted by key.
+         * The range is merged with the map in a single pass after
+         * growing the arrays once, rather than shifting the arrays
+         * for every element. Keys already in the map, and repeated
+         * keys in the range, keep the first value seen.
+         *
+         * @tparam It forward iterator type
+         * @param first the first element
+         * @param last  pass-the-end of the range
+         * @return the number of inserted elements, which is zero
+         * if the arrays could not grow
+         */
+        template<typename It>
+        size_type insert_sorted(It first, It last);
+
+        /**
+         * Replace the contents of the map with a range of key and
+         * value tuples sorted by key.
+         *
+         * @tparam It forward iterator type
+         * @param first the first element
+         * @param last  pass-the-end of the range
+         * @return false if the arrays could not grow
+         */
+        template<typename It>
+        bool assign_sorted(It first, It last) {
+            clear();
+            return insert_sorted(first, last) > 0 || first == last;
+        }
+
+        template<typename K, typename V>
+        pair<iterator, bool> insert(K &&key, V &&val) {
+            size_type i = lower_index(key);
+            if (i != m_keys.size() && !m_cmp.__lt__(key, m_keys.data()[i])) {
+                return pair<iterator, bool>(make_iterator(i), false);
+            }
+            if (!insert_at(i, forward<K>(key), forward<V>(val))) {
+                return pair<iterator, bool>(end(), false);
+            }
+            return pair<iterator, bool>(make_iterator(i), true);
+        };
+
+        template<typename K, typename V>
+        pair<iterator, bool> insert_or_assign(K &&key, V &&val) {
+            size_type i = lower_index(key);
+            if (i != m_keys.size() && !m_cmp.__lt__(key, m_keys.data()[i])) {
+                m_vals.data()[i] = forward<V>(val);
+                return pair<iterator, bool>(make_iterator(i), false);
+            }
+            if (!insert_at(i, forward<K>(key), forward<V>(val))) {
+                return pair<iterator, bool>(end(), false);
+            }
+            return pair<iterator, bool>(make_iterator(i), true);
+        };
+
+        iterator erase(const iterator &pos) {
+            size_type i = static_cast<size_type>(pos.m_key - m_keys.data());
+            if (i >= m_keys.size()) {
+                return end();
+            }
+            m_keys.erase(i);
+            m_vals.erase(i);
+            return make_iterator(i);
+        }
+
+        bool erase(const key_type &key) {
+            size_type i = find_index(key);
+            if (i == m_keys.size()) {
+                return false;
+            }
+            m_keys.erase(i);
+            m_vals.erase(i);
+            return true;
+        }
+
+        val_type &at(const key_type &key) {
+            return *find(key);
+        }
+
+        const val_type &at(const key_type &key) const {
+            return *find(key);
+        }
+
+        bool contains(const key_type &key) const {
+            return find_index(key) != m_keys.size();
+        }
+
+        iterator find(const key_type &key) {
+            return make_iterator(find_index(key));
+        }
+
+        const_iterator find(const key_type &key) const {
+            return make_iterator(find_index(key));
+        }
+
+        iterator lower_bound(const key_type &key) {
+            return make_iterator(lower_index(key));
+        }
+
+        const_iterator lower_bound(const key_type &key) const {
+            return make_iterator(lower_index(key));
+        }
+
+        iterator upper_bound(const key_type &key) {
+            return make_iterator(upper_bound_index(m_keys.data(), m_keys.size(), key, m_cmp));
+        }
+
+        const_iterator upper_bound(const key_type &key) const {
+            return make_iterator(upper_bound_index(m_keys.data(), m_keys.size(), key, m_cmp));
+        }
+
+        pair<iterator, iterator> equal_range(const key_type &key) {
+            size_type i = lower_index(key);
+            size_type j = i;
+            if (j != m_keys.size() && !m_cmp.__lt__(key, m_keys.data()[j])) {
+                ++j;
+            }
+            return pair<iterator, iterator>(make_iterator(i), make_iterator(j));
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            size_type i = lower_index(key);
+            size_type j = i;
+            if (j != m_keys.size() && !m_cmp.__lt__(key, m_keys.data()[j])) {
+                ++j;
+            }
+            return pair<const_iterator, const_iterator>(make_iterator(i), make_iterator(j));
+        }
+
+        /**
+         * @param k zero-based position in key order
+         * @return iterator to the element, or pass-the-end if out of range
+         */
+        iterator nth(size_type k) {
+            return k < m_keys.size() ? make_iterator(k) : end();
+        }
+
+        /**
+         * @param k zero-based position in key order
+         * @return iterator to the element, or pass-the-end if out of range
+         */
+        const_iterator nth(size_type k) const {
+            return k < m_keys.size() ? make_iterator(k) : end();
+        }
+
+        /**
+         * @param key key to rank
+         * @return the number of keys less than the key
+         */
+        size_type rank(const key_type &key) const {
+            return lower_index(key);
+        }
+
+        size_type distance(const iterator &first, const iterator &last) const {
+            return static_cast<size_type>(last - first);
+        }
+
+        size_type distance(const const_iterator &first, const const_iterator &last) const {
+            return static_cast<size_type>(last - first);
+        }
+
+        template<typename K>
+        val_type &operator[](K &&key) {
+            size_type i = lower_index(key);
+            if (i == m_keys.size() || m_cmp.__lt__(key, m_keys.data()[i])) {
+                insert_at(i, forward<K>(key), val_type());
+            }
+            return m_vals.data()[i];
+        }
+
+        map_type &operator=(const map_type &) = delete;
+
+        map_type &operator=(map_type &&map) {
+            m_keys = move(map.m_keys);
+            m_vals = move(map.m_vals);
+            return *this;
+        }
+    };
+
+    template<typename Key, typename Val, typename Cmp>
+    template<typename It>
+    typename flat_map<Key, Val, Cmp>::size_type
+    flat_map<Key, Val, Cmp>::insert_sorted(It first, It last) {
+        size_type n = m_keys.size();
+        // count the distinct keys of the range not in the map
+        size_type count = 0;
+        size_type j = 0;
+        It prev = last;
+        for (It it = first; it != last; ++it) {
+            const key_type &key = get<0>(*it);
+            if (prev != last && !m_cmp.__lt__(get<0>(*prev), key)) {
+                continue;
+            }
+            prev = it;
+            while (j < n && m_cmp.__lt__(m_keys.data()[j], key)) {
+                ++j;
+            }
+            if (j == n || m_cmp.__lt__(key, m_keys.data()[j])) {
+                ++count;
+            }
+        }
+        if (count == 0) {
+            return 0;
+        }
+        reserve(n + count);
+        if (m_keys.capacity() < n + count || m_vals.capacity() < n + count) {
+            return 0;
+        }
+        for (size_type i = 0; i < count; ++i) {
+            m_keys.push_back(key_type());
+            m_vals.push_back(val_type());
+        }
+        key_type *keys = m_keys.data();
+        val_type *vals = m_vals.data();
+        // move the existing elements to the back, then merge
+        // forward; the write position never passes the read position
+        for (size_type i = n; i > 0; --i) {
+            keys[i - 1 + count] = move(keys[i - 1]);
+            vals[i - 1 + count] = move(vals[i - 1]);
+        }
+        size_type w = 0;
+        size_type r = count;
+        size_type end = n + count;
+        prev = last;
+        for (It it = first; it != last && w != r; ++it) {
+            const key_type &key = get<0>(*it);
+            if (prev != last && !m_cmp.__lt__(get<0>(*prev), key)) {
+                continue;
+            }
+            prev = it;
+            while (r < end && m_cmp.__lt__(keys[r], key)) {
+                keys[w] = move(keys[r]);
+                vals[w] = move(vals[r]);
+                ++w;
+                ++r;
+            }
+            if (r < end && !m_cmp.__lt__(key, keys[r])) {
+                continue;
+            }
+            keys[w] = get<0>(*it);
+            vals[w] = get<1>(*it);
+            ++w;
+        }
+        return count;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_FLATMAP_H
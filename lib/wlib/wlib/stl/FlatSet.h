@@ -0,0 +1,346 @@
+/**
+ * @file FlatSet.h
+ * @brief Sorted set stored in a contiguous array.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_FLATSET_H
+#define EMBEDDEDCPLUSPLUS_FLATSET_H
+
+#include <stddef.h>
+
+#include <wlib/utility>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/BinarySearch.h>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Pair.h>
+
+namespace wlp {
+
+    /**
+     * Set implementation over a sorted array list. Keys are
+     * unique and may not be modified in place, so both iterator
+     * types are constant.
+     *
+     * @see wlp::flat_map
+     * @see wlp::tree_set
+     *
+     * @tparam Key stored value type
+     * @tparam Cmp comparator for stored value, which uses the default comparator
+     */
+    template<typename Key, typename Cmp = comparator<Key>>
+    class flat_set {
+    public:
+        typedef flat_set<Key, Cmp> set_type;
+        typedef array_list<Key> key_list;
+        typedef typename key_list::const_iterator iterator;
+        typedef typename key_list::const_iterator const_iterator;
+        typedef size_t size_type;
+
+        typedef Key key_type;
+
+    private:
+        /**
+         * The sorted keys.
+         */
+        key_list m_keys;
+        /**
+         * Key comparator.
+         */
+        Cmp m_cmp;
+
+        /**
+         * @param key key to search
+         * @return the index of the first key not less than the key
+         */
+        size_type lower_index(const key_type &key) const {
+            return lower_bound_index(m_keys.data(), m_keys.size(), key, m_cmp);
+        }
+
+        /**
+         * @param key key to search
+         * @return the index of the key, or the size of the set if absent
+         */
+        size_type find_index(const key_type &key) const {
+            size_type i = lower_index(key);
+            if (i == m_keys.size() || m_cmp.__lt__(key, m_keys.data()[i])) {
+                return m_keys.size();
+            }
+            return i;
+        }
+
+        /**
+         * @param i key index
+         * @return iterator to the key
+         */
+        const_iterator make_iterator(size_type i) const {
+            return const_iterator(i, &m_keys);
+        }
+
+    public:
+        /**
+         * Create an empty set.
+         *
+         * @param initial_capacity the initial size of the backing array
+         */
+        explicit flat_set(size_type initial_capacity = 12)
+                : m_keys(initial_capacity),
+                  m_cmp() {}
+
+        /**
+         * Create a set from a sorted range of keys.
+         *
+         * @tparam It forward iterator type
+         * @param first the first key
+         * @param last  pass-the-end of the range
+         */
+        template<typename It>
+        flat_set(It first, It last)
+                : m_keys(),
+                  m_cmp() {
+            insert_sorted(first, last);
+        }
+
+        flat_set(const set_type &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param set set whose array to transfer
+         */
+        flat_set(set_type &&set)
+                : m_keys(move(set.m_keys)),
+                  m_cmp() {}
+
+        /**
+         * @return the number of keys in the set
+         */
+        size_type size() const {
+            return m_keys.size();
+        }
+
+        /**
+         * @return the number of keys the set holds before growing
+         */
+        size_type capacity() const {
+            return m_keys.capacity();
+        }
+
+        /**
+         * @return true if the set is empty
+         */
+        bool empty() const {
+            return m_keys.empty();
+        }
+
+        /**
+         * @return the sorted key array
+         */
+        const key_list &keys() const {
+            return m_keys;
+        }
+
+        const_iterator begin() const {
+            return make_iterator(0);
+        }
+
+        const_iterator end() const {
+            return make_iterator(m_keys.size());
+        }
+
+        void clear() noexcept {
+            m_keys.clear();
+        }
+
+        /**
+         * Grow the backing array to hold at least the given
+         * number of keys.
+         *
+         * @param new_capacity the number of keys to reserve
+         */
+        void reserve(size_type new_capacity) {
+            m_keys.reserve(new_capacity);
+        }
+
+        /**
+         * Shrink the backing array to the number of keys.
+         */
+        void shrink() {
+            m_keys.shrink();
+        }
+
+        /**
+         * Insert a sorted range of keys, merging it with the set in
+         * a single pass after growing the array once. Keys already
+         * in the set and repeated keys in the range are skipped.
+         *
+         * @tparam It forward iterator type
+         * @param first the first key
+         * @param last  pass-the-end of the range
+         * @return the number of inserted keys, which is zero
+         * if the array could not grow
+         */
+        template<typename It>
+        size_type insert_sorted(It first, It last);
+
+        /**
+         * Replace the contents of the set with a sorted range of keys.
+         *
+         * @tparam It forward iterator type
+         * @param first the first key
+         * @param last  pass-the-end of the range
+         * @return false if the array could not grow
+         */
+        template<typename It>
+        bool assign_sorted(It first, It last) {
+            clear();
+            return insert_sorted(first, last) > 0 || first == last;
+        }
+
+        template<typename K>
+        pair<iterator, bool> insert(K &&key) {
+            size_type i = lower_index(key);
+            if (i != m_keys.size() && !m_cmp.__lt__(key, m_keys.data()[i])) {
+                return pair<iterator, bool>(make_iterator(i), false);
+            }
+            bool inserted = i == m_keys.size()
+                            ? m_keys.push_back(forward<K>(key))
+                            : m_keys.insert(i, forward<K>(key)) != m_keys.end();
+            if (!inserted) {
+                return pair<iterator, bool>(end(), false);
+            }
+            return pair<iterator, bool>(make_iterator(i), true);
+        }
+
+        bool contains(const key_type &key) const {
+            return find_index(key) != m_keys.size();
+        }
+
+        const_iterator find(const key_type &key) const {
+            return make_iterator(find_index(key));
+        }
+
+        const_iterator lower_bound(const key_type &key) const {
+            return make_iterator(lower_index(key));
+        }
+
+        const_iterator upper_bound(const key_type &key) const {
+            return make_iterator(upper_bound_index(m_keys.data(), m_keys.size(), key, m_cmp));
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            size_type i = lower_index(key);
+            size_type j = i;
+            if (j != m_keys.size() && !m_cmp.__lt__(key, m_keys.data()[j])) {
+                ++j;
+            }
+            return pair<const_iterator, const_iterator>(make_iterator(i), make_iterator(j));
+        }
+
+        /**
+         * @param k zero-based position in key order
+         * @return iterator to the key, or pass-the-end if out of range
+         */
+        const_iterator nth(size_type k) const {
+            return make_iterator(k);
+        }
+
+        /**
+         * @param key key to rank
+         * @return the number of keys less than the key
+         */
+        size_type rank(const key_type &key) const {
+            return lower_index(key);
+        }
+
+        size_type distance(const const_iterator &first, const const_iterator &last) const {
+            return static_cast<size_type>(last - first);
+        }
+
+        const_iterator erase(const const_iterator &pos) {
+            size_type i = static_cast<size_type>(pos - begin());
+            if (i >= m_keys.size()) {
+                return end();
+            }
+            m_keys.erase(i);
+            return make_iterator(i);
+        }
+
+        bool erase(const key_type &key) {
+            size_type i = find_index(key);
+            if (i == m_keys.size()) {
+                return false;
+            }
+            m_keys.erase(i);
+            return true;
+        }
+
+        set_type &operator=(const set_type &) = delete;
+
+        set_type &operator=(set_type &&set) {
+            m_keys = move(set.m_keys);
+            return *this;
+        }
+    };
+
+    template<typename Key, typename Cmp>
+    template<typename It>
+    typename flat_set<Key, Cmp>::size_type
+    flat_set<Key, Cmp>::insert_sorted(It first, It last) {
+        size_type n = m_keys.size();
+        // count the distinct keys of the range not in the set
+        size_type count = 0;
+        size_type j = 0;
+        It prev = last;
+        for (It it = first; it != last; ++it) {
+            if (prev != last && !m_cmp.__lt__(*prev, *it)) {
+                continue;
+            }
+            prev = it;
+            while (j < n && m_cmp.__lt__(m_keys.data()[j], *it)) {
+                ++j;
+            }
+            if (j == n || m_cmp.__lt__(*it, m_keys.data()[j])) {
+                ++count;
+            }
+        }
+        if (count == 0) {
+            return 0;
+        }
+        reserve(n + count);
+        if (m_keys.capacity() < n + count) {
+            return 0;
+        }
+        for (size_type i = 0; i < count; ++i) {
+            m_keys.push_back(key_type());
+        }
+        key_type *keys = m_keys.data();
+        // move the existing keys to the back, then merge forward;
+        // the write position never passes the read position
+        for (size_type i = n; i > 0; --i) {
+            keys[i - 1 + count] = move(keys[i - 1]);
+        }
+        size_type w = 0;
+        size_type r = count;
+        size_type end = n + count;
+        prev = last;
+        for (It it = first; it != last && w != r; ++it) {
+            if (prev != last && !m_cmp.__lt__(*prev, *it)) {
+                continue;
+            }
+            prev = it;
+            while (r < end && m_cmp.__lt__(keys[r], *it)) {
+                keys[w++] = move(keys[r++]);
+            }
+            if (r < end && !m_cmp.__lt__(*it, keys[r])) {
+                continue;
+            }
+            keys[w++] = *it;
+        }
+        return count;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_FLATSET_H
@@ -73,6 +73,24 @@ namespace wlp {
         return h;
     }
 
+    /**
+     * Hash a character array of known length the same way
+     * as a C string with the same characters.
+     *
+     * @tparam IntType the integer return type value
+     * @param s the characters to hash
+     * @param len the number of characters
+     * @return a hash code of the string
+     */
+    template<class IntType>
+    inline IntType hash_string(const char *s, size_t len) {
+        IntType h = 0;
+        for (size_t pos = 0; pos < len; ++pos) {
+            h = static_cast<IntType>(MUL_127(h) + s[pos]);
+        }
+        return h;
+    }
+
     /**
      * Template specialization for static stirng.
      *
@@ -89,7 +107,20 @@ namespace wlp {
     template<class IntType>
     struct hash<dynamic_string, IntType> {
         IntType operator()(const dynamic_string &str) const {
-            return hash_string<IntType>(str.c_str());
+            return hash_string<IntType>(str.c_str(), str.length());
+        }
+    };
+
+    /**
+     * Template specialization for string views, which hash
+     * equal to strings with the same characters.
+     *
+     * @tparam IntType hash code integer type
+     */
+    template<class IntType>
+    struct hash<string_view, IntType> {
+        IntType operator()(string_view str) const {
+            return hash_string<IntType>(str.data(), str.length());
         }
     };
 
@@ -0,0 +1,406 @@
+/**
+ * @file IndexedHeap.h
+ * @brief Priority queue with handles to its entries.
+ *
+ * An indexed heap returns a handle for every pushed value and
+ * keeps the heap position of each handle up to date as entries
+ * move, so that an entry can be reprioritized or removed in
+ * logarithmic time without searching the heap for it.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_INDEXEDHEAP_H
+#define EMBEDDEDCPLUSPLUS_INDEXEDHEAP_H
+
+#include <stddef.h>
+
+#include <wlib/utility>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/Comparator.h>
+
+namespace wlp {
+
+    /**
+     * Element of the heap array of an indexed heap: the value
+     * together with the handle that refers to it.
+     *
+     * @tparam T value type
+     */
+    template<typename T>
+    struct IndexedHeapEntry {
+        /**
+         * The stored value.
+         */
+        T m_value;
+        /**
+         * The handle of the entry.
+         */
+        size_t m_handle;
+    };
+
+    /**
+     * A heap in which every entry is addressed by a handle. The
+     * values live in the heap array next to their handles, and a
+     * position array maps each handle to its current index, so a
+     * sift compares adjacent values and writes one index per moved
+     * entry. Handles stay valid until their entry is popped or
+     * erased, after which they may be handed out again.
+     *
+     * @tparam T value type
+     * @tparam Cmp comparator type, which uses the default
+     * @tparam Arity number of children of each heap node
+     */
+    template<typename T, class Cmp = comparator<T>, size_t Arity = 2>
+    class indexed_heap {
+        static_assert(Arity >= 2, "Heap arity must be at least two");
+
+    public:
+        typedef Cmp comparator;
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef size_t handle_type;
+        typedef IndexedHeapEntry<T> entry_type;
+        typedef indexed_heap<T, Cmp, Arity> heap_t;
+
+        /**
+         * Handle value that refers to no entry.
+         */
+        static constexpr handle_type null_handle = static_cast<handle_type>(-1);
+
+    private:
+        /**
+         * The heap array of values and their handles.
+         */
+        array_list<entry_type> m_heap;
+        /**
+         * The heap index of each handle, or the null handle
+         * for handles that are not in use.
+         */
+        array_list<size_type> m_pos;
+        /**
+         * Released handles available for reuse.
+         */
+        array_list<handle_type> m_free;
+        /**
+         * The comparator instance.
+         */
+        comparator m_cmp;
+
+        /**
+         * Store an entry at a heap index and record its position.
+         *
+         * @param i     heap index
+         * @param entry entry to store
+         */
+        void place(size_type i, entry_type &&entry) {
+            entry_type *heap = m_heap.data();
+            heap[i] = move(entry);
+            m_pos.data()[heap[i].m_handle] = i;
+        }
+
+        /**
+         * Move the entry at an index towards the root until
+         * its parent is not less than it.
+         *
+         * @param i heap index of the entry
+         * @return the final index of the entry
+         */
+        size_type sift_up(size_type i) {
+            entry_type *heap = m_heap.data();
+            entry_type entry = move(heap[i]);
+            while (i > 0) {
+                size_type parent = (i - 1) / Arity;
+                if (!m_cmp.__lt__(heap[parent].m_value, entry.m_value)) {
+                    break;
+                }
+                place(i, move(heap[parent]));
+                i = parent;
+            }
+            place(i, move(entry));
+            return i;
+        }
+
+        /**
+         * Move the entry at an index towards the leaves until
+         * none of its children is greater than it.
+         *
+         * @param i heap index of the entry
+         */
+        void sift_down(size_type i) {
+            entry_type *heap = m_heap.data();
+            size_type n = m_heap.size();
+            entry_type entry = move(heap[i]);
+            for (;;) {
+                size_type child = Arity * i + 1;
+                if (child >= n) {
+                    break;
+                }
+                size_type last = child + Arity < n ? child + Arity : n;
+                size_type largest = child;
+                for (size_type c = child + 1; c < last; ++c) {
+                    if (m_cmp.__lt__(heap[largest].m_value, heap[c].m_value)) {
+                        largest = c;
+                    }
+                }
+                if (!m_cmp.__lt__(entry.m_value, heap[largest].m_value)) {
+                    break;
+                }
+                place(i, move(heap[largest]));
+                i = largest;
+            }
+            place(i, move(entry));
+        }
+
+        /**
+         * Restore the heap property around an entry whose value
+         * may have moved in either direction.
+         *
+         * @param i heap index of the entry
+         */
+        void restore(size_type i) {
+            if (sift_up(i) == i) {
+                sift_down(i);
+            }
+        }
+
+        /**
+         * @return an unused handle, or the null handle if
+         * the position array could not grow
+         */
+        handle_type acquire_handle() {
+            if (!m_free.empty()) {
+                handle_type handle = m_free.back();
+                m_free.pop_back();
+                return handle;
+            }
+            if (!m_pos.push_back(null_handle)) {
+                return null_handle;
+            }
+            return m_pos.size() - 1;
+        }
+
+        /**
+         * Mark a handle unused and make it available for reuse.
+         *
+         * @param handle handle to release
+         */
+        void release_handle(handle_type handle) {
+            m_pos.data()[handle] = null_handle;
+            m_free.push_back(handle);
+        }
+
+        /**
+         * Push an entry for a newly acquired handle.
+         *
+         * @param entry entry to push
+         * @return the handle, or the null handle if the heap is full
+         */
+        handle_type push_entry(entry_type &&entry) {
+            if (entry.m_handle == null_handle) {
+                return null_handle;
+            }
+            handle_type handle = entry.m_handle;
+            if (!m_heap.push_back(move(entry))) {
+                m_free.push_back(handle);
+                return null_handle;
+            }
+            sift_up(m_heap.size() - 1);
+            return handle;
+        }
+
+    public:
+        /**
+         * Constructor with a specified initial capacity for the
+         * backing arrays.
+         *
+         * @param initial_capacity initial capacity of the backing arrays
+         */
+        explicit indexed_heap(size_type initial_capacity = 12)
+                : m_heap(initial_capacity),
+                  m_pos(initial_capacity),
+                  m_free(initial_capacity),
+                  m_cmp(Cmp()) {
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        indexed_heap(const heap_t &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param heap indexed heap whose resources to transfer
+         */
+        indexed_heap(heap_t &&heap)
+                : m_heap(move(heap.m_heap)),
+                  m_pos(move(heap.m_pos)),
+                  m_free(move(heap.m_free)),
+                  m_cmp(move(heap.m_cmp)) {
+        }
+
+        /**
+         * Push a value onto the heap.
+         *
+         * @param value value to insert
+         * @return handle to the entry, or the null handle if the heap is full
+         */
+        handle_type push(const val_type &value) {
+            return push_entry(entry_type{value, acquire_handle()});
+        }
+
+        /**
+         * Push an rvalue onto the heap.
+         *
+         * @param value rvalue to insert
+         * @return handle to the entry, or the null handle if the heap is full
+         */
+        handle_type push(val_type &&value) {
+            return push_entry(entry_type{move(value), acquire_handle()});
+        }
+
+        /**
+         * Pop the top entry from the heap, releasing its handle.
+         */
+        void pop() {
+            if (!m_heap.empty()) {
+                erase(m_heap.data()[0].m_handle);
+            }
+        }
+
+        /**
+         * Get a reference to the top value on the heap.
+         * The heap must not be empty.
+         *
+         * @return reference to the top value
+         */
+        const val_type &top() const {
+            return m_heap.data()[0].m_value;
+        }
+
+        /**
+         * @return the handle of the top entry, or the null
+         * handle if the heap is empty
+         */
+        handle_type top_handle() const {
+            return m_heap.empty() ? null_handle : m_heap.data()[0].m_handle;
+        }
+
+        /**
+         * @param handle entry handle
+         * @return true if the handle refers to an entry in the heap
+         */
+        bool contains(handle_type handle) const {
+            return handle < m_pos.size() && m_pos.data()[handle] != null_handle;
+        }
+
+        /**
+         * Get the value of an entry. The handle must be in the heap.
+         *
+         * @param handle entry handle
+         * @return reference to the value of the entry
+         */
+        const val_type &get(handle_type handle) const {
+            return m_heap.data()[m_pos.data()[handle]].m_value;
+        }
+
+        /**
+         * Replace the value of an entry and move it to its new
+         * place in the heap, in either direction.
+         *
+         * @param handle entry handle
+         * @param value  new value
+         * @return false if the handle is not in the heap
+         */
+        template<typename V>
+        bool update(handle_type handle, V &&value) {
+            if (!contains(handle)) {
+                return false;
+            }
+            size_type i = m_pos.data()[handle];
+            m_heap.data()[i].m_value = forward<V>(value);
+            restore(i);
+            return true;
+        }
+
+        /**
+         * Remove an entry from the heap, releasing its handle.
+         *
+         * @param handle entry handle
+         * @return false if the handle is not in the heap
+         */
+        bool erase(handle_type handle) {
+            if (!contains(handle)) {
+                return false;
+            }
+            size_type i = m_pos.data()[handle];
+            size_type last = m_heap.size() - 1;
+            release_handle(handle);
+            if (i != last) {
+                place(i, move(m_heap.data()[last]));
+                m_heap.pop_back();
+                restore(i);
+            } else {
+                m_heap.pop_back();
+            }
+            return true;
+        }
+
+        /**
+         * Remove every entry, releasing all handles.
+         */
+        void clear() noexcept {
+            m_heap.clear();
+            m_pos.clear();
+            m_free.clear();
+        }
+
+        /**
+         * @return whether the heap is empty
+         */
+        bool empty() const {
+            return m_heap.empty();
+        }
+
+        /**
+         * @return the number of entries in the heap
+         */
+        size_type size() const {
+            return m_heap.size();
+        }
+
+        /**
+         * @return the size of the backing heap array
+         */
+        size_type capacity() const {
+            return m_heap.capacity();
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this heap
+         */
+        heap_t &operator=(const heap_t &) = delete;
+
+        /**
+         * Move assignment operator.
+         *
+         * @param heap indexed heap whose resources to transfer
+         * @return reference to this heap
+         */
+        heap_t &operator=(heap_t &&heap) {
+            m_heap = move(heap.m_heap);
+            m_pos = move(heap.m_pos);
+            m_free = move(heap.m_free);
+            return *this;
+        }
+    };
+
+    template<typename T, class Cmp, size_t Arity>
+    constexpr typename indexed_heap<T, Cmp, Arity>::handle_type indexed_heap<T, Cmp, Arity>::null_handle;
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_INDEXEDHEAP_H
@@ -0,0 +1,528 @@
+/**
+ * @file IntrusiveList.h
+ * @brief Doubly linked list whose links live inside the elements.
+ *
+ * An intrusive list does not own or copy its elements. Each element
+ * type embeds an @code intrusive_list_hook @endcode member and the
+ * list threads its links through that member, so that linking and
+ * unlinking never allocate. An object with several hooks may sit in
+ * several containers at the same time.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_INTRUSIVELIST_H
+#define EMBEDDEDCPLUSPLUS_INTRUSIVELIST_H
+
+#include <stddef.h>
+#include <string.h>
+
+namespace wlp {
+
+    /**
+     * Obtain the offset of a hook member within its owning type. The
+     * offset is read out of the member pointer itself, which the
+     * Itanium and ARM C++ ABIs represent as the byte offset of the
+     * member, so no object is created and the result is a constant.
+     * A pointer to a data member cannot name a member of a virtual
+     * base, so the offset is the same in every object of the type.
+     *
+     * @tparam T      owning type
+     * @tparam HookT  hook type
+     * @tparam Member pointer to the hook member
+     * @return the byte offset of the hook in the owner
+     */
+    template<typename T, typename HookT, HookT T::*Member>
+    inline ptrdiff_t __intrusive_offset() {
+        static_assert(sizeof(HookT T::*) == sizeof(ptrdiff_t), "Member pointers must be plain offsets");
+        HookT T::*member = Member;
+        ptrdiff_t offset;
+        memcpy(&offset, &member, sizeof(offset));
+        return offset;
+    }
+
+    /**
+     * Obtain the object that contains a hook.
+     *
+     * @tparam T      owning type
+     * @tparam HookT  hook type
+     * @tparam Member pointer to the hook member
+     * @param hook the hook of the object
+     * @return pointer to the owning object
+     */
+    template<typename T, typename HookT, HookT T::*Member>
+    inline T *__intrusive_owner(HookT *hook) {
+        return reinterpret_cast<T *>(reinterpret_cast<char *>(hook) - __intrusive_offset<T, HookT, Member>());
+    }
+
+    /**
+     * Link member embedded in objects placed in an intrusive list.
+     * A hook may be in at most one list at a time.
+     */
+    struct intrusive_list_hook {
+        /**
+         * Next hook in the list.
+         */
+        intrusive_list_hook *m_next = nullptr;
+        /**
+         * Previous hook in the list.
+         */
+        intrusive_list_hook *m_prev = nullptr;
+
+        /**
+         * @return true if the hook is currently in a list
+         */
+        bool is_linked() const {
+            return m_next != nullptr;
+        }
+    };
+
+    /**
+     * Iterator over the objects of an intrusive list.
+     *
+     * @tparam T    object type
+     * @tparam Hook pointer to the list hook member
+     * @tparam Ref  reference to object type, which may be constant
+     * @tparam Ptr  pointer to object type, which may be constant
+     */
+    template<typename T, intrusive_list_hook T::*Hook, typename Ref, typename Ptr>
+    struct IntrusiveListIterator {
+        typedef T val_type;
+        typedef Ref reference;
+        typedef Ptr pointer;
+        typedef size_t size_type;
+        typedef intrusive_list_hook hook_type;
+        typedef IntrusiveListIterator<T, Hook, Ref, Ptr> self_type;
+
+        /**
+         * The hook pointed to by this iterator.
+         */
+        hook_type *m_current;
+
+        /**
+         * Default constructor.
+         */
+        IntrusiveListIterator()
+                : m_current(nullptr) {}
+
+        /**
+         * Create an iterator to a list hook.
+         *
+         * @param hook list hook
+         */
+        explicit IntrusiveListIterator(hook_type *hook)
+                : m_current(hook) {}
+
+        /**
+         * Copy constructor.
+         *
+         * @param it iterator to copy
+         */
+        IntrusiveListIterator(const self_type &it)
+                : m_current(it.m_current) {}
+
+        /**
+         * @return reference to the object pointed to by the iterator
+         */
+        reference operator*() const {
+            return *__intrusive_owner<T, hook_type, Hook>(m_current);
+        }
+
+        /**
+         * @return pointer to the object pointed to by the iterator
+         */
+        pointer operator->() const {
+            return __intrusive_owner<T, hook_type, Hook>(m_current);
+        }
+
+        /**
+         * Move the iterator to the next object. Incrementing the
+         * last object gives the pass-the-end iterator.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator++() {
+            m_current = m_current->m_next;
+            return *this;
+        }
+
+        /**
+         * Post-fix increment operator.
+         *
+         * @return copy of the iterator before incrementing
+         */
+        self_type operator++(int) {
+            self_type clone(*this);
+            m_current = m_current->m_next;
+            return clone;
+        }
+
+        /**
+         * Move the iterator to the previous object.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator--() {
+            m_current = m_current->m_prev;
+            return *this;
+        }
+
+        /**
+         * Post-fix decrement operator.
+         *
+         * @return copy of the iterator before decrementing
+         */
+        self_type operator--(int) {
+            self_type clone(*this);
+            m_current = m_current->m_prev;
+            return clone;
+        }
+
+        /**
+         * Equality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to the same hook
+         */
+        bool operator==(const self_type &it) const {
+            return m_current == it.m_current;
+        }
+
+        /**
+         * Inequality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to different hooks
+         */
+        bool operator!=(const self_type &it) const {
+            return m_current != it.m_current;
+        }
+
+        /**
+         * Assignment operator.
+         *
+         * @param it iterator to copy
+         * @return reference to this iterator
+         */
+        self_type &operator=(const self_type &it) {
+            m_current = it.m_current;
+            return *this;
+        }
+    };
+
+    /**
+     * Circular doubly linked list of objects that embed an
+     * @code intrusive_list_hook @endcode. The list stores a
+     * sentinel hook and never allocates; objects must outlive
+     * their membership in the list.
+     *
+     * @tparam T    object type
+     * @tparam Hook pointer to the list hook member of the object
+     */
+    template<typename T, intrusive_list_hook T::*Hook>
+    class intrusive_list {
+    public:
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef intrusive_list_hook hook_type;
+        typedef intrusive_list<T, Hook> list_type;
+        typedef IntrusiveListIterator<T, Hook, T &, T *> iterator;
+        typedef IntrusiveListIterator<T, Hook, const T &, const T *> const_iterator;
+
+    private:
+        /**
+         * Sentinel hook, which links to the first and last objects.
+         */
+        hook_type m_head;
+        /**
+         * The number of objects in the list.
+         */
+        size_type m_size;
+
+        /**
+         * @param t object
+         * @return the list hook of the object
+         */
+        static hook_type *hook_of(T &t) {
+            return &(t.*Hook);
+        }
+
+        /**
+         * @return the sentinel hook
+         */
+        hook_type *sentinel() const {
+            return const_cast<hook_type *>(&m_head);
+        }
+
+        /**
+         * Link a hook before another hook.
+         *
+         * @param pos  hook before which to link
+         * @param hook hook to link
+         */
+        void link_before(hook_type *pos, hook_type *hook) {
+            hook->m_next = pos;
+            hook->m_prev = pos->m_prev;
+            pos->m_prev->m_next = hook;
+            pos->m_prev = hook;
+            ++m_size;
+        }
+
+        /**
+         * Unlink a hook and reset its links.
+         *
+         * @param hook hook to unlink
+         */
+        void unlink(hook_type *hook) {
+            hook->m_prev->m_next = hook->m_next;
+            hook->m_next->m_prev = hook->m_prev;
+            hook->m_next = nullptr;
+            hook->m_prev = nullptr;
+            --m_size;
+        }
+
+        /**
+         * Take the objects of another list, leaving it empty.
+         *
+         * @param list list whose objects to take
+         */
+        void take(list_type &list) {
+            if (list.m_size == 0) {
+                m_head.m_next = &m_head;
+                m_head.m_prev = &m_head;
+                m_size = 0;
+                return;
+            }
+            m_head.m_next = list.m_head.m_next;
+            m_head.m_prev = list.m_head.m_prev;
+            m_head.m_next->m_prev = &m_head;
+            m_head.m_prev->m_next = &m_head;
+            m_size = list.m_size;
+            list.m_head.m_next = &list.m_head;
+            list.m_head.m_prev = &list.m_head;
+            list.m_size = 0;
+        }
+
+    public:
+        /**
+         * Create an empty list.
+         */
+        intrusive_list()
+                : m_size(0) {
+            m_head.m_next = &m_head;
+            m_head.m_prev = &m_head;
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        intrusive_list(const list_type &) = delete;
+
+        /**
+         * Move constructor. The objects of the moved list are
+         * relinked to this list's sentinel.
+         *
+         * @param list list to move
+         */
+        intrusive_list(list_type &&list) {
+            take(list);
+        }
+
+        /**
+         * Unlink every object.
+         */
+        ~intrusive_list() {
+            clear();
+        }
+
+        /**
+         * @return the number of objects in the list
+         */
+        size_type size() const {
+            return m_size;
+        }
+
+        /**
+         * @return true if the list is empty
+         */
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * @return iterator to the first object
+         */
+        iterator begin() {
+            return iterator(m_head.m_next);
+        }
+
+        /**
+         * @return pass-the-end iterator
+         */
+        iterator end() {
+            return iterator(sentinel());
+        }
+
+        /**
+         * @return constant iterator to the first object
+         */
+        const_iterator begin() const {
+            return const_iterator(m_head.m_next);
+        }
+
+        /**
+         * @return constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(sentinel());
+        }
+
+        /**
+         * @return reference to the first object, the list must not be empty
+         */
+        T &front() {
+            return *begin();
+        }
+
+        /**
+         * @return reference to the first object, the list must not be empty
+         */
+        const T &front() const {
+            return *begin();
+        }
+
+        /**
+         * @return reference to the last object, the list must not be empty
+         */
+        T &back() {
+            return *iterator(m_head.m_prev);
+        }
+
+        /**
+         * @return reference to the last object, the list must not be empty
+         */
+        const T &back() const {
+            return *const_iterator(m_head.m_prev);
+        }
+
+        /**
+         * Obtain an iterator to an object in this list.
+         *
+         * @param t object in the list
+         * @return iterator to the object
+         */
+        iterator iterator_to(T &t) {
+            return iterator(hook_of(t));
+        }
+
+        /**
+         * Link an object at the front of the list.
+         *
+         * @param t object that is not in a list through this hook
+         */
+        void push_front(T &t) {
+            link_before(m_head.m_next, hook_of(t));
+        }
+
+        /**
+         * Link an object at the back of the list.
+         *
+         * @param t object that is not in a list through this hook
+         */
+        void push_back(T &t) {
+            link_before(&m_head, hook_of(t));
+        }
+
+        /**
+         * Unlink the first object, if any.
+         */
+        void pop_front() {
+            if (m_size) {
+                unlink(m_head.m_next);
+            }
+        }
+
+        /**
+         * Unlink the last object, if any.
+         */
+        void pop_back() {
+            if (m_size) {
+                unlink(m_head.m_prev);
+            }
+        }
+
+        /**
+         * Link an object before the given position.
+         *
+         * @param pos iterator before which to link
+         * @param t   object that is not in a list through this hook
+         * @return iterator to the linked object
+         */
+        iterator insert(const iterator &pos, T &t) {
+            link_before(pos.m_current, hook_of(t));
+            return iterator(hook_of(t));
+        }
+
+        /**
+         * Unlink the object at the given position.
+         *
+         * @param pos iterator to the object to unlink
+         * @return iterator to the following object
+         */
+        iterator erase(const iterator &pos) {
+            if (pos.m_current == &m_head) {
+                return end();
+            }
+            hook_type *next = pos.m_current->m_next;
+            unlink(pos.m_current);
+            return iterator(next);
+        }
+
+        /**
+         * Unlink an object from this list.
+         *
+         * @param t object in this list
+         */
+        void erase(T &t) {
+            unlink(hook_of(t));
+        }
+
+        /**
+         * Unlink every object, resetting their hooks.
+         */
+        void clear() {
+            hook_type *hook = m_head.m_next;
+            while (hook != &m_head) {
+                hook_type *next = hook->m_next;
+                hook->m_next = nullptr;
+                hook->m_prev = nullptr;
+                hook = next;
+            }
+            m_head.m_next = &m_head;
+            m_head.m_prev = &m_head;
+            m_size = 0;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this list
+         */
+        list_type &operator=(const list_type &) = delete;
+
+        /**
+         * Move assignment operator. Objects in this list are unlinked.
+         *
+         * @param list list to move
+         * @return reference to this list
+         */
+        list_type &operator=(list_type &&list) {
+            clear();
+            take(list);
+            return *this;
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_INTRUSIVELIST_H
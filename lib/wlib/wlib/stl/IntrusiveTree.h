@@ -0,0 +1,628 @@
+/**
+ * @file IntrusiveTree.h
+ * @brief Red black tree whose links live inside the elements.
+ *
+ * An intrusive tree orders objects that embed an
+ * @code intrusive_tree_hook @endcode member. The tree only links
+ * and unlinks hooks, reusing the rebalancing functions of the
+ * allocating red black tree, so insertion never allocates and the
+ * objects are never copied. An object with several hooks may sit
+ * in several containers at the same time.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_INTRUSIVETREE_H
+#define EMBEDDEDCPLUSPLUS_INTRUSIVETREE_H
+
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/IntrusiveList.h>
+#include <wlib/stl/Pair.h>
+#include <wlib/stl/RedBlackTree.h>
+
+namespace wlp {
+
+    /**
+     * Link member embedded in objects placed in an intrusive tree.
+     * A hook may be in at most one tree at a time. Its color is
+     * kept in the parent link, so a hook is three pointers wide.
+     */
+    struct intrusive_tree_hook : public RedBlackTreeParentColor<intrusive_tree_hook> {
+        /**
+         * Left child hook.
+         */
+        intrusive_tree_hook *m_left = nullptr;
+        /**
+         * Right child hook.
+         */
+        intrusive_tree_hook *m_right = nullptr;
+
+        /**
+         * @return true if the hook is currently in a tree
+         */
+        bool is_linked() const {
+            return parent() != nullptr;
+        }
+    };
+
+    /**
+     * Iterator over the objects of an intrusive tree, in order.
+     *
+     * @tparam T    object type
+     * @tparam Hook pointer to the tree hook member
+     * @tparam Ref  reference to object type, which may be constant
+     * @tparam Ptr  pointer to object type, which may be constant
+     */
+    template<typename T, intrusive_tree_hook T::*Hook, typename Ref, typename Ptr>
+    struct IntrusiveTreeIterator {
+        typedef T val_type;
+        typedef Ref reference;
+        typedef Ptr pointer;
+        typedef intrusive_tree_hook hook_type;
+        typedef IntrusiveTreeIterator<T, Hook, Ref, Ptr> self_type;
+
+        /**
+         * The hook pointed to by this iterator.
+         */
+        hook_type *m_node;
+
+        /**
+         * Default constructor.
+         */
+        IntrusiveTreeIterator()
+                : m_node(nullptr) {}
+
+        /**
+         * Constructor from hook.
+         *
+         * @param hook to point to
+         */
+        explicit IntrusiveTreeIterator(hook_type *hook)
+                : m_node(hook) {}
+
+        /**
+         * Copy constructor.
+         *
+         * @param it iterator to copy
+         */
+        IntrusiveTreeIterator(const self_type &it)
+                : m_node(it.m_node) {}
+
+        /**
+         * @return reference to the object pointed to by the iterator
+         */
+        reference operator*() const {
+            return *__intrusive_owner<T, hook_type, Hook>(m_node);
+        }
+
+        /**
+         * @return pointer to the object pointed to by the iterator
+         */
+        pointer operator->() const {
+            return __intrusive_owner<T, hook_type, Hook>(m_node);
+        }
+
+        /**
+         * Move to the next ordered object.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator++() {
+            m_node = __rb_increment(m_node);
+            return *this;
+        }
+
+        /**
+         * Post-fix increment operator.
+         *
+         * @return copy of the iterator before incrementing
+         */
+        self_type operator++(int) {
+            self_type clone(*this);
+            m_node = __rb_increment(m_node);
+            return clone;
+        }
+
+        /**
+         * Move to the previous ordered object.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator--() {
+            m_node = __rb_decrement(m_node);
+            return *this;
+        }
+
+        /**
+         * Post-fix decrement operator.
+         *
+         * @return copy of the iterator before decrementing
+         */
+        self_type operator--(int) {
+            self_type clone(*this);
+            m_node = __rb_decrement(m_node);
+            return clone;
+        }
+
+        /**
+         * Iterator equality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to the same hook
+         */
+        bool operator==(const self_type &it) const {
+            return m_node == it.m_node;
+        }
+
+        /**
+         * Iterator inequality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to different hooks
+         */
+        bool operator!=(const self_type &it) const {
+            return m_node != it.m_node;
+        }
+
+        /**
+         * Assignment operator.
+         *
+         * @param it iterator to copy
+         * @return reference to this iterator
+         */
+        self_type &operator=(const self_type &it) {
+            m_node = it.m_node;
+            return *this;
+        }
+    };
+
+    /**
+     * Red black tree of objects that embed an @code intrusive_tree_hook @endcode.
+     * The tree keeps an embedded header hook whose parent is the root
+     * and whose left and right are the leftmost and rightmost hooks.
+     *
+     * Lookups accept any key type for which the comparator defines
+     * @code __lt__ @endcode against the object type in both orders,
+     * so that objects can be found by their key alone.
+     *
+     * @tparam T    object type
+     * @tparam Hook pointer to the tree hook member of the object
+     * @tparam Cmp  object comparator
+     */
+    template<typename T, intrusive_tree_hook T::*Hook, typename Cmp = comparator<T>>
+    class intrusive_tree {
+    public:
+        typedef T val_type;
+        typedef Cmp comparator;
+        typedef size_t size_type;
+        typedef intrusive_tree_hook hook_type;
+        typedef intrusive_tree<T, Hook, Cmp> tree_type;
+        typedef IntrusiveTreeIterator<T, Hook, T &, T *> iterator;
+        typedef IntrusiveTreeIterator<T, Hook, const T &, const T *> const_iterator;
+
+    private:
+        typedef RedBlackTreeColor color;
+
+        /**
+         * Header hook, which maintains reference to the leftmost hook,
+         * the rightmost hook, and the root hook.
+         */
+        hook_type m_header;
+        /**
+         * The number of objects in the tree.
+         */
+        size_type m_size;
+        /**
+         * Class comparator instance.
+         */
+        comparator m_cmp{};
+
+        /**
+         * @param t object
+         * @return the tree hook of the object
+         */
+        static hook_type *hook_of(T &t) {
+            return &(t.*Hook);
+        }
+
+        /**
+         * @param hook linked hook
+         * @return the object owning the hook
+         */
+        static const T &owner(const hook_type *hook) {
+            return *__intrusive_owner<T, hook_type, Hook>(const_cast<hook_type *>(hook));
+        }
+
+        /**
+         * @return the header hook
+         */
+        hook_type *header() const {
+            return const_cast<hook_type *>(&m_header);
+        }
+
+        /**
+         * Reset the header to represent an empty tree.
+         */
+        void empty_initialize() {
+            m_header.set_color(color::RED);
+            m_header.set_parent(nullptr);
+            m_header.m_left = &m_header;
+            m_header.m_right = &m_header;
+            m_size = 0;
+        }
+
+        /**
+         * Link a hook as a child of the given parent.
+         *
+         * @param hook   the hook to link
+         * @param parent the parent hook, or the header if the tree is empty
+         * @param left   whether to link as the left child
+         * @return iterator to the linked object
+         */
+        iterator link(hook_type *hook, hook_type *parent, bool left) {
+            if (left) {
+                parent->m_left = hook;
+                if (parent == &m_header) {
+                    m_header.set_parent(hook);
+                    m_header.m_right = hook;
+                } else if (parent == m_header.m_left) {
+                    m_header.m_left = hook;
+                }
+            } else {
+                parent->m_right = hook;
+                if (parent == m_header.m_right) {
+                    m_header.m_right = hook;
+                }
+            }
+            hook->set_parent(parent);
+            hook->m_left = nullptr;
+            hook->m_right = nullptr;
+            hook_type *root = m_header.parent();
+            __rb_insert_rebalance(hook, root);
+            m_header.set_parent(root);
+            ++m_size;
+            return iterator(hook);
+        }
+
+        /**
+         * Take the objects of another tree, leaving it empty.
+         *
+         * @param tree tree whose objects to take
+         */
+        void take(tree_type &tree) {
+            if (tree.m_size == 0) {
+                empty_initialize();
+                return;
+            }
+            m_header.set_color(color::RED);
+            m_header.set_parent(tree.m_header.parent());
+            m_header.m_left = tree.m_header.m_left;
+            m_header.m_right = tree.m_header.m_right;
+            m_header.parent()->set_parent(&m_header);
+            m_size = tree.m_size;
+            tree.empty_initialize();
+        }
+
+    public:
+        /**
+         * Create an empty tree.
+         */
+        intrusive_tree() {
+            empty_initialize();
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        intrusive_tree(const tree_type &) = delete;
+
+        /**
+         * Move constructor. The root of the moved tree is
+         * relinked to this tree's header.
+         *
+         * @param tree tree to move
+         */
+        intrusive_tree(tree_type &&tree) {
+            take(tree);
+        }
+
+        /**
+         * Unlink every object.
+         */
+        ~intrusive_tree() {
+            clear();
+        }
+
+        /**
+         * @return the number of objects in the tree
+         */
+        size_type size() const {
+            return m_size;
+        }
+
+        /**
+         * @return true if the tree is empty
+         */
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * @return iterator to the smallest object
+         */
+        iterator begin() {
+            return iterator(m_header.m_left);
+        }
+
+        /**
+         * @return pass-the-end iterator
+         */
+        iterator end() {
+            return iterator(&m_header);
+        }
+
+        /**
+         * @return constant iterator to the smallest object
+         */
+        const_iterator begin() const {
+            return const_iterator(m_header.m_left);
+        }
+
+        /**
+         * @return constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(header());
+        }
+
+        /**
+         * Obtain an iterator to an object in this tree.
+         *
+         * @param t object in the tree
+         * @return iterator to the object
+         */
+        iterator iterator_to(T &t) {
+            return iterator(hook_of(t));
+        }
+
+        /**
+         * Link an object if no equivalent object is in the tree.
+         *
+         * @param t object that is not in a tree through this hook
+         * @return a pair of an iterator to the linked object or to the
+         * equivalent object, and whether the object was linked
+         */
+        pair<iterator, bool> insert_unique(T &t) {
+            hook_type *carry = &m_header;
+            hook_type *cur = m_header.parent();
+            bool compare = true;
+            while (cur) {
+                carry = cur;
+                compare = m_cmp.__lt__(t, owner(cur));
+                cur = compare ? cur->m_left : cur->m_right;
+            }
+            iterator tmp = iterator(carry);
+            if (compare) {
+                if (tmp == begin()) {
+                    return pair<iterator, bool>(link(hook_of(t), carry, true), true);
+                }
+                --tmp;
+            }
+            if (m_cmp.__lt__(owner(tmp.m_node), t)) {
+                return pair<iterator, bool>(link(hook_of(t), carry, compare), true);
+            }
+            return pair<iterator, bool>(tmp, false);
+        }
+
+        /**
+         * Link an object after any equivalent objects in the tree.
+         *
+         * @param t object that is not in a tree through this hook
+         * @return iterator to the linked object
+         */
+        iterator insert_equal(T &t) {
+            hook_type *carry = &m_header;
+            hook_type *cur = m_header.parent();
+            bool compare = true;
+            while (cur) {
+                carry = cur;
+                compare = m_cmp.__lt__(t, owner(cur));
+                cur = compare ? cur->m_left : cur->m_right;
+            }
+            return link(hook_of(t), carry, compare);
+        }
+
+        /**
+         * Unlink the object at the given position.
+         *
+         * @param pos iterator to the object to unlink
+         * @return iterator to the following object
+         */
+        iterator erase(const iterator &pos) {
+            if (pos.m_node == &m_header) {
+                return end();
+            }
+            iterator next = pos;
+            ++next;
+            hook_type *root = m_header.parent();
+            hook_type *hook = __rb_erase_rebalance(pos.m_node, root, m_header.m_left, m_header.m_right);
+            m_header.set_parent(root);
+            hook->set_parent(nullptr);
+            hook->m_left = nullptr;
+            hook->m_right = nullptr;
+            --m_size;
+            return next;
+        }
+
+        /**
+         * Unlink an object from this tree.
+         *
+         * @param t object in this tree
+         */
+        void erase(T &t) {
+            erase(iterator(hook_of(t)));
+        }
+
+        /**
+         * Find an object equivalent to the key.
+         *
+         * @tparam K key type
+         * @param key key to find
+         * @return iterator to the object, or the pass-the-end iterator
+         */
+        template<typename K>
+        iterator find(const K &key) {
+            iterator it = lower_bound(key);
+            return (it == end() || m_cmp.__lt__(key, *it)) ? end() : it;
+        }
+
+        /**
+         * Find an object equivalent to the key.
+         *
+         * @tparam K key type
+         * @param key key to find
+         * @return constant iterator to the object, or the pass-the-end iterator
+         */
+        template<typename K>
+        const_iterator find(const K &key) const {
+            const_iterator it = lower_bound(key);
+            return (it == end() || m_cmp.__lt__(key, *it)) ? end() : it;
+        }
+
+        /**
+         * @tparam K key type
+         * @param key key to count
+         * @return the number of objects equivalent to the key
+         */
+        template<typename K>
+        size_type count(const K &key) const {
+            const_iterator it = lower_bound(key);
+            const_iterator last = upper_bound(key);
+            size_type count = 0;
+            while (it != last) {
+                ++it;
+                ++count;
+            }
+            return count;
+        }
+
+        /**
+         * @tparam K key type
+         * @param key key to compare
+         * @return iterator to the first object not less than the key
+         */
+        template<typename K>
+        iterator lower_bound(const K &key) {
+            hook_type *carry = &m_header;
+            hook_type *cur = m_header.parent();
+            while (cur) {
+                if (!m_cmp.__lt__(owner(cur), key)) {
+                    carry = cur;
+                    cur = cur->m_left;
+                } else {
+                    cur = cur->m_right;
+                }
+            }
+            return iterator(carry);
+        }
+
+        /**
+         * @tparam K key type
+         * @param key key to compare
+         * @return constant iterator to the first object not less than the key
+         */
+        template<typename K>
+        const_iterator lower_bound(const K &key) const {
+            return const_iterator(const_cast<tree_type *>(this)->lower_bound(key).m_node);
+        }
+
+        /**
+         * @tparam K key type
+         * @param key key to compare
+         * @return iterator to the first object greater than the key
+         */
+        template<typename K>
+        iterator upper_bound(const K &key) {
+            hook_type *carry = &m_header;
+            hook_type *cur = m_header.parent();
+            while (cur) {
+                if (m_cmp.__lt__(key, owner(cur))) {
+                    carry = cur;
+                    cur = cur->m_left;
+                } else {
+                    cur = cur->m_right;
+                }
+            }
+            return iterator(carry);
+        }
+
+        /**
+         * @tparam K key type
+         * @param key key to compare
+         * @return constant iterator to the first object greater than the key
+         */
+        template<typename K>
+        const_iterator upper_bound(const K &key) const {
+            return const_iterator(const_cast<tree_type *>(this)->upper_bound(key).m_node);
+        }
+
+        /**
+         * @tparam K key type
+         * @param key key to compare
+         * @return the range of objects equivalent to the key
+         */
+        template<typename K>
+        pair<iterator, iterator> equal_range(const K &key) {
+            return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        /**
+         * Unlink every object, resetting their hooks.
+         */
+        void clear() {
+            hook_type *cur = m_header.parent();
+            while (cur) {
+                if (cur->m_left) {
+                    cur = cur->m_left;
+                } else if (cur->m_right) {
+                    cur = cur->m_right;
+                } else {
+                    hook_type *parent = cur->parent();
+                    cur->set_parent(nullptr);
+                    if (parent == &m_header) {
+                        break;
+                    }
+                    if (parent->m_left == cur) {
+                        parent->m_left = nullptr;
+                    } else {
+                        parent->m_right = nullptr;
+                    }
+                    cur = parent;
+                }
+            }
+            empty_initialize();
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this tree
+         */
+        tree_type &operator=(const tree_type &) = delete;
+
+        /**
+         * Move assignment operator. Objects in this tree are unlinked.
+         *
+         * @param tree tree to move
+         * @return reference to this tree
+         */
+        tree_type &operator=(tree_type &&tree) {
+            clear();
+            take(tree);
+            return *this;
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_INTRUSIVETREE_H
@@ -16,6 +16,9 @@
 
 #include <wlib/memory>
 
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/NodePool.h>
+
 namespace wlp {
 
     template<typename T>
@@ -198,6 +201,7 @@ namespace wlp {
         typedef LinkedListNode<T> node_type;
         typedef LinkedListIterator<T, T &, T *> iterator;
         typedef LinkedListIterator<T, const T &, const T *> const_iterator;
+        typedef node_pool<node_type, &node_type::m_next> pool_type;
 
     private:
         /**
@@ -212,6 +216,11 @@ namespace wlp {
          * The number of elements in the list.
          */
         size_type m_size;
+        /**
+         * Pool from which nodes are obtained, or null
+         * if nodes are individually allocated.
+         */
+        pool_type *m_pool;
 
         friend struct LinkedListIterator<T, T &, T *>;
         friend struct LinkedListIterator<T, const T &, const T *>;
@@ -223,7 +232,21 @@ namespace wlp {
         linked_list()
                 : m_head(nullptr),
                   m_tail(nullptr),
-                  m_size(0) {}
+                  m_size(0),
+                  m_pool(nullptr) {}
+
+        /**
+         * Create an empty list whose nodes come from a pool, which
+         * may be shared with other lists. The pool must outlive
+         * the list.
+         *
+         * @param pool the node pool to use
+         */
+        explicit linked_list(pool_type *pool)
+                : m_head(nullptr),
+                  m_tail(nullptr),
+                  m_size(0),
+                  m_pool(pool) {}
 
         /**
          * Disable copy construction.
@@ -240,7 +263,8 @@ namespace wlp {
         linked_list(list_type &&list) :
             m_head(move(list.m_head)),
             m_tail(move(list.m_tail)),
-            m_size(move(list.m_size)) {
+            m_size(move(list.m_size)),
+            m_pool(list.m_pool) {
             list.m_size = 0;
             list.m_head = nullptr;
             list.m_tail = nullptr;
@@ -274,6 +298,13 @@ namespace wlp {
             return static_cast<size_type>(-1);
         }
 
+        /**
+         * @return the node pool used by this list, or null
+         */
+        pool_type *pool() const {
+            return m_pool;
+        }
+
         /**
          * Return a reference to the value stored at the `index`
          *
@@ -341,7 +372,9 @@ namespace wlp {
         }
 
         /**
-         * Removes all the elements in the list.
+         * Removes all the elements in the list. If the list uses
+         * a node pool, the whole chain of nodes is returned to it
+         * in one step.
          */
         void clear() noexcept;
 
@@ -390,7 +423,7 @@ namespace wlp {
         iterator insert(size_type i, V &&val) {
             if (!m_size) { i = 0; }
             else { i %= m_size; }
-            node_type *node = create<node_type>();
+            node_type *node = create_node();
             node->m_val = forward<V>(val);
             if (m_head == nullptr) {
                 node->m_next = nullptr;
@@ -426,7 +459,7 @@ namespace wlp {
                 push_back(forward<V>(val));
                 return iterator(m_tail, this);
             }
-            node_type *node = create<node_type>();
+            node_type *node = create_node();
             node->m_val = forward<V>(val);
             node->m_next = it.m_current;
             node->m_prev = it.m_current->m_prev;
@@ -467,7 +500,7 @@ namespace wlp {
                 m_tail = pTmp->m_prev;
             }
             node_type *next = pTmp->m_next;
-            destroy<node_type>(pTmp);
+            destroy_node(pTmp);
             --m_size;
             return iterator(next, this);
         }
@@ -479,7 +512,7 @@ namespace wlp {
          */
         template<typename V>
         void push_back(V &&val) {
-            node_type *node = create<node_type>();
+            node_type *node = create_node();
             node->m_val = forward<V>(val);
             node->m_next = nullptr;
             if (m_head == nullptr) {
@@ -500,7 +533,7 @@ namespace wlp {
          */
         template<typename V>
         void push_front(V &&val) {
-            node_type *node = create<node_type>();
+            node_type *node = create_node();
             node->m_val = forward<V>(val);
             node->m_prev = nullptr;
 
@@ -529,7 +562,7 @@ namespace wlp {
             } else {
                 m_head = nullptr;
             }
-            destroy<node_type>(pTmp);
+            destroy_node(pTmp);
             m_size--;
         }
 
@@ -547,7 +580,7 @@ namespace wlp {
             } else {
                 m_tail = nullptr;
             }
-            destroy<node_type>(pTmp);
+            destroy_node(pTmp);
             m_size--;
         }
 
@@ -597,6 +630,103 @@ namespace wlp {
             return end();
         }
 
+        /**
+         * Move all the nodes of another list into this list before
+         * the given position. No nodes are allocated or copied and
+         * the other list is left empty. Both lists must use the same
+         * node pool, or none, otherwise nothing happens.
+         *
+         * @param pos iterator to the element before which to insert,
+         *            or pass-the-end to append
+         * @param list the list whose nodes to transfer
+         * @return false if the lists cannot exchange nodes
+         */
+        bool splice(const iterator &pos, list_type &list) {
+            if (list.m_pool != m_pool) {
+                return false;
+            }
+            if (&list == this || list.m_head == nullptr) {
+                return true;
+            }
+            link_before(pos.m_current, list.m_head, list.m_tail);
+            m_size += list.m_size;
+            list.m_head = nullptr;
+            list.m_tail = nullptr;
+            list.m_size = 0;
+            return true;
+        }
+
+        /**
+         * Move a single node from another list, which may be this
+         * list, into this list before the given position. Both lists
+         * must use the same node pool, or none.
+         *
+         * @param pos iterator to the element before which to insert,
+         *            or pass-the-end to append
+         * @param list the list that owns the node
+         * @param it iterator to the node to transfer
+         * @return false if the lists cannot exchange nodes or the
+         * iterator is pass-the-end, in which case nothing happens
+         */
+        bool splice(const iterator &pos, list_type &list, const iterator &it) {
+            node_type *node = it.m_current;
+            if (node == nullptr || list.m_pool != m_pool) {
+                return false;
+            }
+            if (&list == this && (node == pos.m_current || node->m_next == pos.m_current)) {
+                return true;
+            }
+            list.unlink(node);
+            --list.m_size;
+            link_before(pos.m_current, node, node);
+            ++m_size;
+            return true;
+        }
+
+        /**
+         * Merge another sorted list into this sorted list by relinking
+         * nodes. The merge is stable: equal elements from this list
+         * precede those from the other list. The other list is left empty.
+         * Both lists must use the same node pool, or none, otherwise
+         * nothing happens.
+         *
+         * @tparam Cmp comparator type
+         * @param list the sorted list to merge
+         * @param cmp comparator to use
+         * @return false if the lists cannot exchange nodes
+         */
+        template<typename Cmp>
+        bool merge(list_type &list, Cmp cmp);
+
+        /**
+         * Merge another sorted list into this sorted list using
+         * the elements' default ordering.
+         *
+         * @param list the sorted list to merge
+         * @return false if the lists cannot exchange nodes
+         */
+        bool merge(list_type &list) {
+            return merge(list, comparator<val_type>());
+        }
+
+        /**
+         * Sort the list with a bottom-up merge sort that relinks
+         * nodes rather than moving values. The sort is stable, runs
+         * in O(n log n) time, and allocates nothing.
+         *
+         * @tparam Cmp comparator type
+         * @param cmp comparator to use
+         */
+        template<typename Cmp>
+        void sort(Cmp cmp);
+
+        /**
+         * Sort the list using the elements' default ordering.
+         */
+        void sort() {
+            sort(comparator<val_type>());
+        }
+
         /**
          * Delete copy assignment.
          *
@@ -615,20 +745,176 @@ namespace wlp {
             m_size = list.m_size;
             m_head = list.m_head;
             m_tail = list.m_tail;
+            m_pool = list.m_pool;
             list.m_size = 0;
             list.m_head = nullptr;
             list.m_tail = nullptr;
             return *this;
         }
+
+    private:
+        /**
+         * @return a new node from the pool, or individually allocated
+         */
+        node_type *create_node() {
+            return m_pool ? m_pool->allocate() : create<node_type>();
+        }
+
+        /**
+         * Return a node to the pool, resetting its value, or free it.
+         *
+         * @param node the node to release
+         */
+        void destroy_node(node_type *node) {
+            if (m_pool) {
+                node->m_val = val_type();
+                m_pool->deallocate(node);
+            } else {
+                destroy<node_type>(node);
+            }
+        }
+
+        /**
+         * Link a chain of nodes into this list before a node.
+         *
+         * @param pos the node before which to link, or null to append
+         * @param first the first node in the chain
+         * @param last the last node in the chain
+         */
+        void link_before(node_type *pos, node_type *first, node_type *last) {
+            node_type *prev = pos ? pos->m_prev : m_tail;
+            first->m_prev = prev;
+            last->m_next = pos;
+            if (prev) { prev->m_next = first; }
+            else { m_head = first; }
+            if (pos) { pos->m_prev = last; }
+            else { m_tail = last; }
+        }
+
+        /**
+         * Unlink a node from this list without destroying it.
+         *
+         * @param node the node to unlink
+         */
+        void unlink(node_type *node) {
+            if (node->m_prev) { node->m_prev->m_next = node->m_next; }
+            else { m_head = node->m_next; }
+            if (node->m_next) { node->m_next->m_prev = node->m_prev; }
+            else { m_tail = node->m_prev; }
+        }
+
+        /**
+         * Restore the previous pointers and the tail of the list
+         * after the nodes have been relinked through their next
+         * pointers only.
+         *
+         * @param head the new first node
+         */
+        void relink(node_type *head) {
+            node_type *prev = nullptr;
+            for (node_type *node = head; node; node = node->m_next) {
+                node->m_prev = prev;
+                prev = node;
+            }
+            m_head = head;
+            m_tail = prev;
+        }
+
+        /**
+         * Merge two sorted null-terminated chains through their next
+         * pointers. Equal elements are taken from the first chain first.
+         *
+         * @tparam Cmp comparator type
+         * @param a the first chain
+         * @param b the second chain
+         * @param cmp comparator to use
+         * @return the head of the merged chain
+         */
+        template<typename Cmp>
+        static node_type *merge_nodes(node_type *a, node_type *b, Cmp &cmp) {
+            node_type *head = nullptr;
+            node_type **tail = &head;
+            while (a && b) {
+                if (cmp.__lt__(b->m_val, a->m_val)) {
+                    *tail = b;
+                    b = b->m_next;
+                } else {
+                    *tail = a;
+                    a = a->m_next;
+                }
+                tail = &(*tail)->m_next;
+            }
+            *tail = a ? a : b;
+            return head;
+        }
     };
 
+    template<typename T>
+    template<typename Cmp>
+    bool linked_list<T>::merge(list_type &list, Cmp cmp) {
+        if (list.m_pool != m_pool) {
+            return false;
+        }
+        if (&list == this || list.m_head == nullptr) {
+            return true;
+        }
+        relink(merge_nodes(m_head, list.m_head, cmp));
+        m_size += list.m_size;
+        list.m_head = nullptr;
+        list.m_tail = nullptr;
+        list.m_size = 0;
+        return true;
+    }
+
+    template<typename T>
+    template<typename Cmp>
+    void linked_list<T>::sort(Cmp cmp) {
+        if (m_size < 2) {
+            return;
+        }
+        // runs[i] is null or a sorted run of 2^i nodes,
+        // with higher bins holding earlier elements
+        node_type *runs[sizeof(size_type) * 8];
+        size_type filled = 0;
+        node_type *node = m_head;
+        while (node) {
+            node_type *run = node;
+            node = node->m_next;
+            run->m_next = nullptr;
+            size_type i = 0;
+            for (; i < filled && runs[i]; ++i) {
+                run = merge_nodes(runs[i], run, cmp);
+                runs[i] = nullptr;
+            }
+            runs[i] = run;
+            if (i == filled) {
+                ++filled;
+            }
+        }
+        node_type *head = nullptr;
+        for (size_type i = 0; i < filled; ++i) {
+            if (runs[i]) {
+                head = merge_nodes(runs[i], head, cmp);
+            }
+        }
+        relink(head);
+    }
+
     template<typename T>
     inline void linked_list<T>::clear() noexcept {
+        if (m_pool && m_head) {
+            // the nodes are already chained, so return them all at once
+            for (node_type *node = m_head; node; node = node->m_next) {
+                node->m_val = val_type();
+            }
+            m_pool->deallocate(m_head, m_tail, m_size);
+            m_head = nullptr;
+        }
         node_type *pTmp;
         while (m_head != nullptr) {
             pTmp = m_head;
             m_head = m_head->m_next;
-            destroy<node_type>(pTmp);
+            destroy_node(pTmp);
         }
         m_size = 0;
         m_tail = nullptr;
@@ -659,7 +945,7 @@ namespace wlp {
             m_tail = pTmp->m_prev;
         }
         node_type *next = pTmp->m_next;
-        destroy<node_type>(pTmp);
+        destroy_node(pTmp);
         m_size--;
         return iterator(next, this);
     }
@@ -0,0 +1,588 @@
+/**
+ * @file MinMaxHeap.h
+ * @brief Double-ended priority queue as a min-max heap.
+ *
+ * A min-max heap is a complete binary tree stored in an array whose
+ * levels alternate between min levels and max levels: an element on
+ * a min level is no greater than any of its descendants, and one on
+ * a max level is no less. The root is then the smallest element and
+ * the larger of its children the greatest, so both ends are read in
+ * constant time and either can be popped in logarithmic time.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_MINMAXHEAP_H
+#define EMBEDDEDCPLUSPLUS_MINMAXHEAP_H
+
+#include <wlib/utility>
+
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Concept.h>
+#include <wlib/stl/TypeTraits.h>
+
+namespace wlp {
+
+    /**
+     * Comparator adapter that reverses the order of another
+     * comparator. Max levels of the heap are handled by the
+     * min level routines through this adapter.
+     *
+     * @tparam Cmp comparator type
+     */
+    template<typename Cmp>
+    struct MinMaxHeapReverse {
+        const Cmp &m_cmp;
+
+        template<typename T>
+        bool __lt__(const T &a, const T &b) const {
+            return m_cmp.__lt__(b, a);
+        }
+    };
+
+    /**
+     * @tparam SizeType integer size type
+     * @param i index in the heap
+     * @return true if the index is on a min level
+     */
+    template<typename SizeType>
+    inline bool __min_max_is_min_level(SizeType i) {
+        bool min_level = true;
+        for (SizeType n = static_cast<SizeType>(i + 1); n > 1; n >>= 1) {
+            min_level = !min_level;
+        }
+        return min_level;
+    }
+
+    /**
+     * Move the element at an index up through its grandparents
+     * while it precedes them in the given order.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Less ordering of the level the element is on
+     * @param first iterator to the first element in the heap
+     * @param i index of the element
+     * @param less ordering to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Less>
+    void __min_max_push_up_grand(RandomAccessIterator first, SizeType i, const Less &less) {
+        while (i > 2) {
+            SizeType grandparent = static_cast<SizeType>(((i - 1) / 2 - 1) / 2);
+            if (!less.__lt__(*(first + i), *(first + grandparent))) {
+                return;
+            }
+            swap(*(first + i), *(first + grandparent));
+            i = grandparent;
+        }
+    }
+
+    /**
+     * Restore the heap after the element at an index has been
+     * added as the last element of the heap.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the heap
+     * @param i index of the added element
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    void __min_max_push_up(RandomAccessIterator first, SizeType i, const Cmp &cmp) {
+        if (i == 0) {
+            return;
+        }
+        MinMaxHeapReverse<Cmp> reverse{cmp};
+        SizeType parent = static_cast<SizeType>((i - 1) / 2);
+        if (__min_max_is_min_level(i)) {
+            if (cmp.__lt__(*(first + parent), *(first + i))) {
+                swap(*(first + i), *(first + parent));
+                __min_max_push_up_grand(first, parent, reverse);
+            } else {
+                __min_max_push_up_grand(first, i, cmp);
+            }
+        } else {
+            if (cmp.__lt__(*(first + i), *(first + parent))) {
+                swap(*(first + i), *(first + parent));
+                __min_max_push_up_grand(first, parent, cmp);
+            } else {
+                __min_max_push_up_grand(first, i, reverse);
+            }
+        }
+    }
+
+    /**
+     * Move the element at an index down until it precedes its
+     * children and grandchildren in the given order. The element
+     * skips a level at a time, swapping with its new parent when
+     * that parent, on a level of the opposite order, is out of place.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Less ordering of the level the element is on
+     * @param first iterator to the first element in the heap
+     * @param i index of the element
+     * @param length number of elements in the heap
+     * @param less ordering to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Less>
+    void __min_max_trickle_down(RandomAccessIterator first, SizeType i, SizeType length, const Less &less) {
+        for (;;) {
+            SizeType child = static_cast<SizeType>(2 * i + 1);
+            if (child >= length) {
+                return;
+            }
+            SizeType m = child;
+            if (child + 1 < length && less.__lt__(*(first + child + 1), *(first + m))) {
+                m = static_cast<SizeType>(child + 1);
+            }
+            SizeType grandchild = static_cast<SizeType>(4 * i + 3);
+            SizeType end = grandchild + 4 < length ? static_cast<SizeType>(grandchild + 4) : length;
+            for (SizeType j = grandchild; j < end; ++j) {
+                if (less.__lt__(*(first + j), *(first + m))) {
+                    m = j;
+                }
+            }
+            if (!less.__lt__(*(first + m), *(first + i))) {
+                return;
+            }
+            swap(*(first + m), *(first + i));
+            if (m < grandchild) {
+                return;
+            }
+            SizeType parent = static_cast<SizeType>((m - 1) / 2);
+            if (less.__lt__(*(first + parent), *(first + m))) {
+                swap(*(first + m), *(first + parent));
+            }
+            i = m;
+        }
+    }
+
+    /**
+     * Restore the heap below an index whose element has been replaced.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the heap
+     * @param i index of the replaced element
+     * @param length number of elements in the heap
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    void __min_max_adjust(RandomAccessIterator first, SizeType i, SizeType length, const Cmp &cmp) {
+        if (__min_max_is_min_level(i)) {
+            __min_max_trickle_down(first, i, length, cmp);
+        } else {
+            __min_max_trickle_down(first, i, length, MinMaxHeapReverse<Cmp>{cmp});
+        }
+    }
+
+    /**
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the heap
+     * @param length number of elements in the heap, at least one
+     * @param cmp comparator to use
+     * @return the index of the greatest element
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    SizeType __min_max_max_index(RandomAccessIterator first, SizeType length, const Cmp &cmp) {
+        if (length < 3) {
+            return static_cast<SizeType>(length - 1);
+        }
+        return cmp.__lt__(*(first + 1), *(first + 2)) ? (SizeType) 2 : (SizeType) 1;
+    }
+
+    /**
+     * Remove the element at an index from a heap of the given length
+     * by moving it to the last position.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the heap
+     * @param i index of the element to remove
+     * @param length number of elements in the heap
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    void __min_max_pop(RandomAccessIterator first, SizeType i, SizeType length, const Cmp &cmp) {
+        SizeType last = static_cast<SizeType>(length - 1);
+        if (i == last) {
+            return;
+        }
+        swap(*(first + i), *(first + last));
+        __min_max_adjust(first, i, last, cmp);
+    }
+
+    /**
+     * Insert the element at the end of @code [first, last) @endcode
+     * into the min-max heap @code [first, last - 1) @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType integer size type, acquired from the iterator type
+     * @param first iterator to the first element in the heap
+     * @param last iterator one past the inserted element
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, typename obtain_val_type<RandomAccessIterator>::type>()
+            >::type
+    >
+    void push_min_max_heap(RandomAccessIterator first, RandomAccessIterator last, Cmp cmp) {
+        __min_max_push_up(first, static_cast<SizeType>(last - first - 1), cmp);
+    }
+
+    /**
+     * Move the smallest element of the min-max heap @code [first, last) @endcode
+     * to @code last - 1 @endcode, leaving a heap of @code [first, last - 1) @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType integer size type, acquired from the iterator type
+     * @param first iterator to the first element in the heap
+     * @param last iterator one past the last element in the heap
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, typename obtain_val_type<RandomAccessIterator>::type>()
+            >::type
+    >
+    void pop_min_max_heap_min(RandomAccessIterator first, RandomAccessIterator last, Cmp cmp) {
+        SizeType length = static_cast<SizeType>(last - first);
+        if (length > 0) {
+            __min_max_pop(first, (SizeType) 0, length, cmp);
+        }
+    }
+
+    /**
+     * Move the greatest element of the min-max heap @code [first, last) @endcode
+     * to @code last - 1 @endcode, leaving a heap of @code [first, last - 1) @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType integer size type, acquired from the iterator type
+     * @param first iterator to the first element in the heap
+     * @param last iterator one past the last element in the heap
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, typename obtain_val_type<RandomAccessIterator>::type>()
+            >::type
+    >
+    void pop_min_max_heap_max(RandomAccessIterator first, RandomAccessIterator last, Cmp cmp) {
+        SizeType length = static_cast<SizeType>(last - first);
+        if (length > 0) {
+            __min_max_pop(first, __min_max_max_index(first, length, cmp), length, cmp);
+        }
+    }
+
+    /**
+     * Arrange @code [first, last) @endcode into a min-max heap
+     * in linear time.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType integer size type, acquired from the iterator type
+     * @param first iterator to the first element in the range
+     * @param last iterator one past the last element in the range
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, typename obtain_val_type<RandomAccessIterator>::type>()
+            >::type
+    >
+    void make_min_max_heap(RandomAccessIterator first, RandomAccessIterator last, Cmp cmp) {
+        SizeType length = static_cast<SizeType>(last - first);
+        for (SizeType i = static_cast<SizeType>(length / 2); i > 0;) {
+            --i;
+            __min_max_adjust(first, i, length, cmp);
+        }
+    }
+
+    /**
+     * Insert the element at the end of @code [first, last) @endcode
+     * into the min-max heap @code [first, last - 1) @endcode using
+     * the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from the iterator type
+     * @param first iterator to the first element in the heap
+     * @param last iterator one past the inserted element
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void push_min_max_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        push_min_max_heap(first, last, comparator<ValType>());
+    }
+
+    /**
+     * Move the smallest element of the min-max heap @code [first, last) @endcode
+     * to @code last - 1 @endcode using the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from the iterator type
+     * @param first iterator to the first element in the heap
+     * @param last iterator one past the last element in the heap
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void pop_min_max_heap_min(RandomAccessIterator first, RandomAccessIterator last) {
+        pop_min_max_heap_min(first, last, comparator<ValType>());
+    }
+
+    /**
+     * Move the greatest element of the min-max heap @code [first, last) @endcode
+     * to @code last - 1 @endcode using the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from the iterator type
+     * @param first iterator to the first element in the heap
+     * @param last iterator one past the last element in the heap
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void pop_min_max_heap_max(RandomAccessIterator first, RandomAccessIterator last) {
+        pop_min_max_heap_max(first, last, comparator<ValType>());
+    }
+
+    /**
+     * Arrange @code [first, last) @endcode into a min-max heap
+     * using the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from the iterator type
+     * @param first iterator to the first element in the range
+     * @param last iterator one past the last element in the range
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void make_min_max_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        make_min_max_heap(first, last, comparator<ValType>());
+    }
+
+    /**
+     * Double-ended priority queue using @code ArrayList @endcode as
+     * the backing structure. The heap operates on the backing array
+     * directly rather than through iterators.
+     *
+     * @tparam T data type
+     * @tparam Cmp comparator type, which uses the default
+     */
+    template<typename T, class Cmp = comparator<T>>
+    class min_max_heap {
+    public:
+        typedef Cmp comparator;
+        typedef min_max_heap<T, Cmp> heap_t;
+        typedef typename array_list<T>::val_type val_type;
+        typedef typename array_list<T>::size_type size_type;
+        typedef typename array_list<T>::list_type array_list_t;
+
+    private:
+        /**
+         * The backing array list.
+         */
+        array_list_t m_list;
+        /**
+         * The comparator instance.
+         */
+        comparator m_cmp;
+
+    public:
+        /**
+         * Constructor with a specified initial capacity for the
+         * backing array list.
+         *
+         * @param initial_capacity initial capacity of the backing array
+         */
+        explicit min_max_heap(size_type initial_capacity = 12)
+                : m_list(initial_capacity),
+                  m_cmp(Cmp()) {
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        min_max_heap(const heap_t &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param heap heap whose resources to transfer
+         */
+        min_max_heap(heap_t &&heap)
+                : m_list(move(heap.m_list)),
+                  m_cmp(move(heap.m_cmp)) {
+        }
+
+        /**
+         * Push an element onto the heap.
+         *
+         * @param value value to insert
+         * @return false if the backing array is full
+         */
+        bool push(const val_type &value) {
+            if (!m_list.push_back(value)) {
+                return false;
+            }
+            __min_max_push_up(m_list.data(), m_list.size() - 1, m_cmp);
+            return true;
+        }
+
+        /**
+         * Push an rvalue onto the heap.
+         *
+         * @param value rvalue to insert
+         * @return false if the backing array is full
+         */
+        bool push(val_type &&value) {
+            if (!m_list.push_back(forward<val_type>(value))) {
+                return false;
+            }
+            __min_max_push_up(m_list.data(), m_list.size() - 1, m_cmp);
+            return true;
+        }
+
+        /**
+         * Get the smallest element. The heap must not be empty.
+         *
+         * @return reference to the smallest element
+         */
+        const val_type &min() const {
+            return *m_list.data();
+        }
+
+        /**
+         * Get the greatest element. The heap must not be empty.
+         *
+         * @return reference to the greatest element
+         */
+        const val_type &max() const {
+            return m_list.data()[__min_max_max_index(m_list.data(), m_list.size(), m_cmp)];
+        }
+
+        /**
+         * Pop the smallest element from the heap.
+         */
+        void pop_min() {
+            if (m_list.empty()) {
+                return;
+            }
+            __min_max_pop(m_list.data(), (size_type) 0, m_list.size(), m_cmp);
+            m_list.pop_back();
+        }
+
+        /**
+         * Pop the greatest element from the heap.
+         */
+        void pop_max() {
+            if (m_list.empty()) {
+                return;
+            }
+            __min_max_pop(m_list.data(), __min_max_max_index(m_list.data(), m_list.size(), m_cmp),
+                          m_list.size(), m_cmp);
+            m_list.pop_back();
+        }
+
+        /**
+         * Remove every element.
+         */
+        void clear() noexcept {
+            m_list.clear();
+        }
+
+        /**
+         * @return whether the heap is empty
+         */
+        bool empty() const {
+            return m_list.empty();
+        }
+
+        /**
+         * @return the number of elements in the heap
+         */
+        size_type size() const {
+            return m_list.size();
+        }
+
+        /**
+         * @return the size of the backing array
+         */
+        size_type capacity() const {
+            return m_list.capacity();
+        }
+
+        /**
+         * @return a pointer to the backing array list
+         */
+        array_list_t *get_array_list() {
+            return &m_list;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this heap
+         */
+        heap_t &operator=(const heap_t &) = delete;
+
+        /**
+         * Move assignment operator.
+         *
+         * @param heap heap whose resources to transfer
+         * @return reference to this heap
+         */
+        heap_t &operator=(heap_t &&heap) {
+            m_list = move(heap.m_list);
+            return *this;
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_MINMAXHEAP_H
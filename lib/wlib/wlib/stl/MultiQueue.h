@@ -0,0 +1,385 @@
+/**
+ * @file MultiQueue.h
+ * @brief Relaxed priority queue for many producers and consumers.
+ *
+ * A multi-queue spreads its elements over several independently
+ * locked heaps. Pushes go to a random heap and pops take the better
+ * of the tops of two random heaps, so threads rarely contend for the
+ * same lock. The price is a relaxed order: a pop returns an element
+ * close to, but not necessarily, the greatest one in the queue.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_MULTIQUEUE_H
+#define EMBEDDEDCPLUSPLUS_MULTIQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/utility>
+#include <wlib/stl/ArrayHeap.h>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/SpinLock.h>
+
+/**
+ * Size in bytes of a cache line, to which the shards of
+ * a multi-queue are padded so that threads working on
+ * different shards do not invalidate each other's caches.
+ */
+#ifndef WLIB_CACHE_LINE_SIZE
+#define WLIB_CACHE_LINE_SIZE 64
+#endif
+
+namespace wlp {
+
+    /**
+     * A heap of a multi-queue together with its lock.
+     *
+     * @tparam T    value type
+     * @tparam Cmp  comparator type
+     * @tparam Lock lock policy type
+     */
+    template<typename T, class Cmp, class Lock>
+    struct MultiQueueShardBase {
+        /**
+         * The lock guarding the heap.
+         */
+        Lock m_lock;
+        /**
+         * The number of elements in the heap. It is written with
+         * the lock held and may be read without it.
+         */
+        size_t m_count;
+        /**
+         * The elements of the shard.
+         */
+        array_heap<T, Cmp> m_heap;
+
+        MultiQueueShardBase()
+                : m_count(0) {
+        }
+    };
+
+    /**
+     * Unused bytes that fill out a shard.
+     *
+     * @tparam Bytes number of bytes
+     */
+    template<size_t Bytes>
+    struct MultiQueuePadding {
+        char m_padding[Bytes];
+    };
+
+    template<>
+    struct MultiQueuePadding<0> {
+    };
+
+    /**
+     * A shard padded to a whole number of cache lines. The
+     * alignment of the shard is not raised, because allocators
+     * need not honour alignments beyond that of the fundamental
+     * types, so the shards of a queue that starts on a cache line
+     * share none, and otherwise neighbours share at most one.
+     *
+     * @tparam T    value type
+     * @tparam Cmp  comparator type
+     * @tparam Lock lock policy type
+     */
+    template<typename T, class Cmp, class Lock>
+    struct MultiQueueShard
+            : MultiQueueShardBase<T, Cmp, Lock>,
+              MultiQueuePadding<(WLIB_CACHE_LINE_SIZE -
+                                 sizeof(MultiQueueShardBase<T, Cmp, Lock>) % WLIB_CACHE_LINE_SIZE) %
+                                WLIB_CACHE_LINE_SIZE> {
+    };
+
+    /**
+     * Concurrent priority queue made of locked heap shards. Every
+     * operation draws shard indices from a xorshift generator whose
+     * state is either passed in by the caller, typically one per
+     * thread, or seeded from a shared counter. Shards are only ever
+     * acquired with @code try_lock @endcode while another is held,
+     * so operations cannot deadlock. With about twice as many shards
+     * as threads, pops seldom wait on each other.
+     *
+     * @tparam T      value type
+     * @tparam Cmp    comparator type, which uses the default
+     * @tparam Shards number of heaps
+     * @tparam Lock   lock policy type
+     */
+    template<typename T, class Cmp = comparator<T>, size_t Shards = 8, class Lock = spin_lock>
+    class multi_queue {
+        static_assert(Shards >= 2, "Multi-queue must have at least two shards");
+
+    public:
+        typedef Cmp comparator;
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef uint32_t random_state;
+        typedef Lock lock_type;
+        typedef MultiQueueShard<T, Cmp, Lock> shard_type;
+        typedef multi_queue<T, Cmp, Shards, Lock> queue_t;
+
+        static constexpr size_type shards = Shards;
+
+    private:
+        /**
+         * The heap shards.
+         */
+        shard_type m_shards[Shards];
+        /**
+         * The comparator instance.
+         */
+        comparator m_cmp;
+        /**
+         * Counter from which to seed operations without state.
+         */
+        random_state m_seed;
+
+        /**
+         * @return a new nonzero generator state
+         */
+        random_state seed() {
+            random_state x = __atomic_add_fetch(&m_seed, 0x9e3779b9u, __ATOMIC_RELAXED);
+            x ^= x >> 16;
+            x *= 0x85ebca6bu;
+            x ^= x >> 13;
+            return x ? x : 1;
+        }
+
+        /**
+         * @param shard a shard of this queue
+         * @return the number of elements the shard was last seen with
+         */
+        static size_type count(const shard_type *shard) {
+            return __atomic_load_n(&shard->m_count, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * Publish the size of a locked shard.
+         *
+         * @param shard shard whose lock is held
+         */
+        static void update_count(shard_type *shard) {
+            __atomic_store_n(&shard->m_count, shard->m_heap.size(), __ATOMIC_RELAXED);
+        }
+
+        /**
+         * @param state generator state to advance
+         * @return the next random number
+         */
+        static random_state next(random_state &state) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        /**
+         * @param state generator state to advance
+         * @return a random shard
+         */
+        shard_type *pick(random_state &state) {
+            return &m_shards[next(state) % Shards];
+        }
+
+        /**
+         * @param state generator state to advance
+         * @param other a shard of this queue
+         * @return a random shard other than the given one
+         */
+        shard_type *pick_other(random_state &state, shard_type *other) {
+            size_type i = static_cast<size_type>(other - m_shards) + 1 + next(state) % (Shards - 1);
+            return &m_shards[i % Shards];
+        }
+
+        /**
+         * Move the top element out of a locked shard.
+         *
+         * @param shard shard whose lock is held
+         * @param out   location to which to move the element
+         * @return false if the shard is empty
+         */
+        bool take(shard_type *shard, val_type &out) {
+            if (shard->m_heap.empty()) {
+                return false;
+            }
+            out = move(shard->m_heap.get_array_list()->front());
+            shard->m_heap.pop();
+            update_count(shard);
+            return true;
+        }
+
+    public:
+        /**
+         * Create an empty queue.
+         */
+        multi_queue()
+                : m_cmp(Cmp()),
+                  m_seed(0) {
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        multi_queue(const queue_t &) = delete;
+
+        /**
+         * Push a value into a random shard.
+         *
+         * @param value value to insert
+         * @param state generator state of the calling thread
+         * @return false if the shard could not grow
+         */
+        template<typename V>
+        bool push(V &&value, random_state &state) {
+            shard_type *shard = pick(state);
+            while (!shard->m_lock.try_lock()) {
+                shard = pick(state);
+            }
+            bool pushed = shard->m_heap.push(forward<V>(value));
+            update_count(shard);
+            shard->m_lock.unlock();
+            return pushed;
+        }
+
+        /**
+         * Push a value into a random shard, seeding the
+         * generator from the shared counter. Every call
+         * writes the counter, so threads that push often
+         * should keep their own state.
+         *
+         * @param value value to insert
+         * @return false if the shard could not grow
+         */
+        template<typename V>
+        bool push(V &&value) {
+            random_state state = seed();
+            return push(forward<V>(value), state);
+        }
+
+        /**
+         * Pop the greater of the tops of two random shards. Pairs
+         * that both appear empty are skipped without locking. When
+         * repeated samples find only busy or empty shards, every
+         * shard is visited in turn, and the pop fails only if each
+         * shard was seen empty during that sweep.
+         *
+         * @param out   location to which to move the popped element
+         * @param state generator state of the calling thread
+         * @return false if the queue was seen empty
+         */
+        bool pop(val_type &out, random_state &state) {
+            for (size_type attempt = 0; attempt < 2 * Shards; ++attempt) {
+                shard_type *a = pick(state);
+                shard_type *b = pick_other(state, a);
+                if (!count(a) && !count(b)) {
+                    continue;
+                }
+                if (!a->m_lock.try_lock()) {
+                    continue;
+                }
+                if (!b->m_lock.try_lock()) {
+                    bool found = take(a, out);
+                    a->m_lock.unlock();
+                    if (found) {
+                        return true;
+                    }
+                    continue;
+                }
+                shard_type *best = a;
+                if (a->m_heap.empty() ||
+                    (!b->m_heap.empty() && m_cmp.__lt__(a->m_heap.top(), b->m_heap.top()))) {
+                    best = b;
+                }
+                bool found = take(best, out);
+                b->m_lock.unlock();
+                a->m_lock.unlock();
+                if (found) {
+                    return true;
+                }
+            }
+            for (size_type i = 0; i < Shards; ++i) {
+                if (!count(&m_shards[i])) {
+                    continue;
+                }
+                m_shards[i].m_lock.lock();
+                bool found = take(&m_shards[i], out);
+                m_shards[i].m_lock.unlock();
+                if (found) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Pop the greater of the tops of two random shards,
+         * seeding the generator from the shared counter.
+         * Every call writes the counter, so threads that
+         * pop often should keep their own state.
+         *
+         * @param out location to which to move the popped element
+         * @return false if the queue was seen empty
+         */
+        bool pop(val_type &out) {
+            random_state state = seed();
+            return pop(out, state);
+        }
+
+        /**
+         * Remove every element. Concurrent pushes may
+         * leave elements behind.
+         */
+        void clear() {
+            for (size_type i = 0; i < Shards; ++i) {
+                m_shards[i].m_lock.lock();
+                m_shards[i].m_heap.get_array_list()->clear();
+                update_count(&m_shards[i]);
+                m_shards[i].m_lock.unlock();
+            }
+        }
+
+        /**
+         * Sum the sizes of the shards without locking them. While
+         * other threads modify the queue the result is approximate,
+         * as the shards are not all read at the same instant.
+         *
+         * @return the approximate number of elements
+         */
+        size_type size() const {
+            size_type n = 0;
+            for (size_type i = 0; i < Shards; ++i) {
+                n += count(&m_shards[i]);
+            }
+            return n;
+        }
+
+        /**
+         * @return true if every shard appears empty, which
+         * is approximate while other threads modify the queue
+         */
+        bool empty() const {
+            for (size_type i = 0; i < Shards; ++i) {
+                if (count(&m_shards[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this queue
+         */
+        queue_t &operator=(const queue_t &) = delete;
+    };
+
+    template<typename T, class Cmp, size_t Shards, class Lock>
+    constexpr typename multi_queue<T, Cmp, Shards, Lock>::size_type multi_queue<T, Cmp, Shards, Lock>::shards;
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_MULTIQUEUE_H
@@ -0,0 +1,232 @@
+/**
+ * @file NodePool.h
+ * @brief Block allocator for container nodes.
+ *
+ * A node pool allocates container nodes in blocks and keeps
+ * released nodes in an intrusive free list, threaded through a
+ * pointer member of the node itself. Allocating and releasing a
+ * node is then a pointer swap in the common case, and the
+ * underlying allocator is called once per block. A pool may be
+ * shared between several containers of the same node type.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_NODEPOOL_H
+#define EMBEDDEDCPLUSPLUS_NODEPOOL_H
+
+#include <stddef.h>
+
+#include <wlib/memory>
+
+namespace wlp {
+
+    /**
+     * Node pool that hands out default constructed nodes from
+     * blocks of @code BlockSize @endcode nodes. Nodes are not
+     * destroyed when released; they keep their contents until
+     * they are reused or the pool frees its blocks.
+     *
+     * @tparam Node node type
+     * @tparam Link pointer member of the node used to link free nodes
+     * @tparam BlockSize number of nodes allocated at a time
+     */
+    template<typename Node, Node *Node::*Link, size_t BlockSize = 16>
+    class node_pool {
+        static_assert(BlockSize > 0, "Block size must be positive");
+
+    public:
+        typedef Node node_type;
+        typedef size_t size_type;
+        typedef node_pool<Node, Link, BlockSize> pool_type;
+
+        static constexpr size_type block_size = BlockSize;
+
+    private:
+        /**
+         * A block of nodes, chained to the other blocks of the pool.
+         */
+        struct Block {
+            Block *m_next;
+            node_type m_nodes[BlockSize];
+        };
+
+        /**
+         * The most recently allocated block.
+         */
+        Block *m_blocks;
+        /**
+         * The first free node.
+         */
+        node_type *m_free;
+        /**
+         * The number of allocated blocks.
+         */
+        size_type m_num_blocks;
+        /**
+         * The number of nodes in the free list.
+         */
+        size_type m_num_free;
+
+    public:
+        /**
+         * Create an empty pool. No blocks are allocated
+         * until the first node is requested.
+         */
+        node_pool()
+                : m_blocks(nullptr),
+                  m_free(nullptr),
+                  m_num_blocks(0),
+                  m_num_free(0) {}
+
+        /**
+         * Disable copy construction.
+         */
+        node_pool(const pool_type &) = delete;
+
+        /**
+         * Move constructor.
+         *
+         * @param pool node pool whose blocks to transfer
+         */
+        node_pool(pool_type &&pool)
+                : m_blocks(pool.m_blocks),
+                  m_free(pool.m_free),
+                  m_num_blocks(pool.m_num_blocks),
+                  m_num_free(pool.m_num_free) {
+            pool.m_blocks = nullptr;
+            pool.m_free = nullptr;
+            pool.m_num_blocks = 0;
+            pool.m_num_free = 0;
+        }
+
+        /**
+         * Free every block. Nodes still in use become invalid.
+         */
+        ~node_pool() {
+            free_blocks();
+        }
+
+    private:
+        /**
+         * Free every block and reset the pool.
+         */
+        void free_blocks() {
+            while (m_blocks) {
+                Block *next = m_blocks->m_next;
+                destroy<Block>(m_blocks);
+                m_blocks = next;
+            }
+            m_free = nullptr;
+            m_num_blocks = 0;
+            m_num_free = 0;
+        }
+
+    public:
+        /**
+         * @return the number of nodes allocated in blocks
+         */
+        size_type capacity() const {
+            return m_num_blocks * BlockSize;
+        }
+
+        /**
+         * @return the number of nodes available without allocating
+         */
+        size_type available() const {
+            return m_num_free;
+        }
+
+        /**
+         * @return the number of nodes handed out and not yet released
+         */
+        size_type in_use() const {
+            return capacity() - m_num_free;
+        }
+
+        /**
+         * @return the number of allocated blocks
+         */
+        size_type blocks() const {
+            return m_num_blocks;
+        }
+
+        /**
+         * Obtain a node, allocating a new block if none are free.
+         *
+         * @return a node, or null if allocation failed
+         */
+        node_type *allocate() {
+            if (!m_free) {
+                Block *block = create<Block>();
+                if (!block) {
+                    return nullptr;
+                }
+                block->m_next = m_blocks;
+                m_blocks = block;
+                ++m_num_blocks;
+                for (size_type i = BlockSize; i > 0; --i) {
+                    block->m_nodes[i - 1].*Link = m_free;
+                    m_free = &block->m_nodes[i - 1];
+                }
+                m_num_free += BlockSize;
+            }
+            node_type *node = m_free;
+            m_free = node->*Link;
+            --m_num_free;
+            return node;
+        }
+
+        /**
+         * Return a node to the pool.
+         *
+         * @param node a node obtained from this pool
+         */
+        void deallocate(node_type *node) {
+            node->*Link = m_free;
+            m_free = node;
+            ++m_num_free;
+        }
+
+        /**
+         * Return a chain of nodes to the pool at once. The nodes
+         * must already be linked from first to last through the
+         * link member.
+         *
+         * @param first the first node in the chain
+         * @param last the last node in the chain
+         * @param count the number of nodes in the chain
+         */
+        void deallocate(node_type *first, node_type *last, size_type count) {
+            last->*Link = m_free;
+            m_free = first;
+            m_num_free += count;
+        }
+
+        /**
+         * Free every block if no nodes are in use.
+         *
+         * @return false if nodes are still in use and nothing was freed
+         */
+        bool release() {
+            if (in_use() != 0) {
+                return false;
+            }
+            free_blocks();
+            return true;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this pool
+         */
+        pool_type &operator=(const pool_type &) = delete;
+    };
+
+    template<typename Node, Node *Node::*Link, size_t BlockSize>
+    constexpr typename node_pool<Node, Link, BlockSize>::size_type node_pool<Node, Link, BlockSize>::block_size;
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_NODEPOOL_H
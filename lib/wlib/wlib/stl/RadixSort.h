@@ -0,0 +1,256 @@
+/**
+ * @file RadixSort.h
+ * @brief Least significant digit radix sort.
+ *
+ * This file contains a byte-wise LSD radix sort for contiguous
+ * ranges and array lists. Elements are ordered by an unsigned
+ * integer key obtained from a key extraction functor. Functors
+ * are supplied for integers, IEEE floating point numbers, and
+ * static string prefixes. The sort is stable and runs in linear
+ * time, performing one pass per key byte. Passes in which every
+ * element has the same byte are skipped.
+ *
+ * A key extraction functor defines @code key_type @endcode, an
+ * unsigned integer type, and @code key_type operator()(const T &) const @endcode.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_RADIXSORT_H
+#define EMBEDDEDCPLUSPLUS_RADIXSORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <wlib/memory>
+#include <wlib/type_traits>
+#include <wlib/utility>
+
+#include <wlib/stl/ArrayList.h>
+#include <wlib/strings/String.h>
+
+namespace wlp {
+
+    /**
+     * Unsigned integer type of the given width in bytes.
+     *
+     * @tparam Size width in bytes
+     */
+    template<size_t Size>
+    struct radix_uint;
+
+    template<>
+    struct radix_uint<1> {
+        typedef uint8_t type;
+    };
+
+    template<>
+    struct radix_uint<2> {
+        typedef uint16_t type;
+    };
+
+    template<>
+    struct radix_uint<4> {
+        typedef uint32_t type;
+    };
+
+    template<>
+    struct radix_uint<8> {
+        typedef uint64_t type;
+    };
+
+    /**
+     * Default key extraction functor. Only the specializations
+     * below are defined.
+     *
+     * @tparam T element type
+     */
+    template<typename T, typename Enable = void>
+    struct radix_key;
+
+    /**
+     * Integer keys. Signed integers have their sign bit flipped
+     * so that negative values order before positive values.
+     *
+     * @tparam T integer type
+     */
+    template<typename T>
+    struct radix_key<T, typename enable_if<is_integral<T>::value>::type> {
+        typedef typename radix_uint<sizeof(T)>::type key_type;
+
+        key_type operator()(const T &t) const {
+            key_type key = static_cast<key_type>(t);
+            if (is_signed<T>::value) {
+                key = static_cast<key_type>(key ^ (static_cast<key_type>(1) << (sizeof(T) * 8 - 1)));
+            }
+            return key;
+        }
+    };
+
+    /**
+     * Floating point keys. Negative values have all their bits
+     * flipped and positive values have their sign bit set, so that
+     * the bit patterns order the same way as the values. Negative
+     * zero orders before positive zero, and NaN orders before all
+     * other values if its sign bit is set and after them otherwise.
+     *
+     * @tparam T IEEE floating point type
+     */
+    template<typename T>
+    struct radix_key<T, typename enable_if<is_floating_point<T>::value>::type> {
+        typedef typename radix_uint<sizeof(T)>::type key_type;
+
+        key_type operator()(const T &t) const {
+            static constexpr key_type sign = static_cast<key_type>(1) << (sizeof(T) * 8 - 1);
+            key_type bits;
+            memcpy(&bits, &t, sizeof(T));
+            return static_cast<key_type>((bits & sign) ? ~bits : (bits | sign));
+        }
+    };
+
+    /**
+     * Static string keys use the first bytes of the string, up to
+     * eight, such that strings are ordered lexicographically by
+     * their prefix. Strings with equal prefixes keep their relative
+     * order; finish with a comparison sort if a full ordering is needed.
+     *
+     * @tparam tSize static string capacity
+     */
+    template<size_t tSize>
+    struct radix_key<static_string<tSize>, void> {
+        static constexpr size_t prefix = tSize < 8 ? (tSize < 4 ? (tSize < 2 ? 1 : (tSize < 3 ? 2 : 4)) : 8) : 8;
+        typedef typename radix_uint<prefix>::type key_type;
+
+        key_type operator()(const static_string<tSize> &str) const {
+            size_t length = str.length();
+            const char *chars = str.c_str();
+            key_type key = 0;
+            for (size_t i = 0; i < prefix; ++i) {
+                key = static_cast<key_type>(key << 8);
+                if (i < length) {
+                    key = static_cast<key_type>(key | static_cast<uint8_t>(chars[i]));
+                }
+            }
+            return key;
+        }
+    };
+
+    /**
+     * Radix sort the elements in @code [first, last) @endcode by
+     * the keys obtained from the supplied functor. Allocates a buffer
+     * the size of the range and a histogram table of 256 counters
+     * per key byte.
+     *
+     * @tparam T element type
+     * @tparam Key key extraction functor type
+     * @param first pointer to the first element
+     * @param last pointer one past the last element
+     * @param key key extraction functor
+     * @return false if the buffers could not be allocated, in
+     * which case the range is unchanged
+     */
+    template<typename T, typename Key>
+    bool radix_sort(T *first, T *last, Key key) {
+        typedef typename Key::key_type key_type;
+        static constexpr size_t passes = sizeof(key_type);
+        size_t n = static_cast<size_t>(last - first);
+        if (n < 2) {
+            return true;
+        }
+        size_t *counts = create<size_t[]>(passes * 256);
+        if (!counts) {
+            return false;
+        }
+        T *buffer = create<T[]>(n);
+        if (!buffer) {
+            destroy<size_t[]>(counts);
+            return false;
+        }
+        for (size_t i = 0; i < passes * 256; ++i) {
+            counts[i] = 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            key_type k = key(first[i]);
+            for (size_t p = 0; p < passes; ++p) {
+                ++counts[p * 256 + static_cast<uint8_t>(k >> (p * 8))];
+            }
+        }
+        T *src = first;
+        T *dst = buffer;
+        for (size_t p = 0; p < passes; ++p) {
+            size_t *count = counts + p * 256;
+            // all elements share this byte, so the pass would not reorder
+            if (count[static_cast<uint8_t>(key(src[0]) >> (p * 8))] == n) {
+                continue;
+            }
+            size_t offset = 0;
+            for (size_t b = 0; b < 256; ++b) {
+                size_t c = count[b];
+                count[b] = offset;
+                offset += c;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                dst[count[static_cast<uint8_t>(key(src[i]) >> (p * 8))]++] = move(src[i]);
+            }
+            T *tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+        if (src != first) {
+            for (size_t i = 0; i < n; ++i) {
+                first[i] = move(src[i]);
+            }
+        }
+        destroy<T[]>(buffer);
+        destroy<size_t[]>(counts);
+        return true;
+    }
+
+    /**
+     * Radix sort the elements in @code [first, last) @endcode using
+     * the default key for the element type.
+     *
+     * @tparam T element type
+     * @param first pointer to the first element
+     * @param last pointer one past the last element
+     * @return false if the buffers could not be allocated
+     */
+    template<typename T>
+    bool radix_sort(T *first, T *last) {
+        return radix_sort(first, last, radix_key<T>());
+    }
+
+    /**
+     * Radix sort an array list by the keys obtained
+     * from the supplied functor.
+     *
+     * @tparam T list element type, inferred from array list
+     * @tparam Growth list growth policy, inferred from array list
+     * @tparam Key key extraction functor type
+     * @param list array list to sort
+     * @param key key extraction functor
+     * @return false if the buffers could not be allocated
+     */
+    template<typename T, typename Growth, typename Key>
+    bool radix_sort(array_list<T, Growth> &list, Key key) {
+        return radix_sort(list.data(), list.data() + list.size(), key);
+    }
+
+    /**
+     * Radix sort an array list using the default key
+     * for the element type.
+     *
+     * @tparam T list element type, inferred from array list
+     * @tparam Growth list growth policy, inferred from array list
+     * @param list array list to sort
+     * @return false if the buffers could not be allocated
+     */
+    template<typename T, typename Growth>
+    bool radix_sort(array_list<T, Growth> &list) {
+        return radix_sort(list, radix_key<T>());
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_RADIXSORT_H
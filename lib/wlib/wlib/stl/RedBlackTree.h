@@ -13,7 +13,10 @@
 #ifndef EMBEDDEDCPLUSPLUS_REDBLACKTREE_H
 #define EMBEDDEDCPLUSPLUS_REDBLACKTREE_H
 
+#include <stdint.h>
+
 #include <wlib/stl/Comparator.h>
+#include <wlib/stl/NodePool.h>
 #include <wlib/stl/Pair.h>
 #include <wlib/memory>
 
@@ -38,25 +41,96 @@ namespace wlp {
     };
 
     /**
-     * Tree node contains the node key and value.
+     * Parent link and color of a red-black tree node. The color is
+     * stored in the lowest bit of the parent pointer, which is always
+     * clear because nodes are aligned to at least a pointer, so that
+     * the color takes no space of its own. Deriving node types declare
+     * their child links @code m_left @endcode and @code m_right @endcode,
+     * and the parent and color are accessed through @code parent() @endcode,
+     * @code set_parent() @endcode, @code color() @endcode, and
+     * @code set_color() @endcode.
      *
-     * @tparam Element element type contained by the node, which must
-     * provide the functions @code get_key() @endcode and @code get_val() @endcode.
+     * @tparam Node the node type deriving from this type
      */
-    template<typename Element>
-    struct RedBlackTreeNode {
-        typedef RedBlackTreeNode<Element> node_type;
-        typedef Element element_type;
+    template<typename Node>
+    struct RedBlackTreeParentColor {
+        typedef RedBlackTreeColor::type color_type;
 
-    private:
-        typedef RedBlackTreeColor::type color;
+        /**
+         * Parent node, with the node color in the lowest bit.
+         */
+        uintptr_t m_parent_color = 0;
 
+        /**
+         * @return the parent node
+         */
+        Node *parent() const {
+            return reinterpret_cast<Node *>(m_parent_color & ~static_cast<uintptr_t>(1));
+        }
 
-    public:
         /**
-         * Node parent.
+         * Set the parent node, keeping the color.
+         *
+         * @param parent the new parent node
          */
-        node_type *m_parent = nullptr;
+        void set_parent(Node *parent) {
+            static_assert(alignof(Node) > 1, "Node alignment must leave the lowest pointer bit free");
+            m_parent_color = reinterpret_cast<uintptr_t>(parent) | (m_parent_color & 1);
+        }
+
+        /**
+         * @return the node color
+         */
+        color_type color() const {
+            return (m_parent_color & 1) != 0;
+        }
+
+        /**
+         * Set the node color, keeping the parent.
+         *
+         * @param color the new color
+         */
+        void set_color(color_type color) {
+            m_parent_color = (m_parent_color & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(color);
+        }
+    };
+
+    /**
+     * Optional subtree node count of a tree node. Uncounted
+     * nodes carry no extra member.
+     *
+     * @tparam Counted whether the node keeps a subtree count
+     */
+    template<bool Counted>
+    struct RedBlackTreeCount {
+    };
+
+    /**
+     * Counted tree nodes keep the number of nodes in the
+     * subtree rooted at the node, including itself.
+     */
+    template<>
+    struct RedBlackTreeCount<true> {
+        /**
+         * The number of nodes in the subtree.
+         */
+        size_t m_count = 1;
+    };
+
+    /**
+     * Tree node contains the node key and value.
+     *
+     * @tparam Element element type contained by the node, which must
+     * provide the functions @code get_key() @endcode and @code get_val() @endcode.
+     * @tparam Counted whether the node keeps the size of its subtree
+     */
+    template<typename Element, bool Counted = false>
+    struct RedBlackTreeNode
+            : public RedBlackTreeParentColor<RedBlackTreeNode<Element, Counted>>,
+              public RedBlackTreeCount<Counted> {
+        typedef RedBlackTreeNode<Element, Counted> node_type;
+        typedef Element element_type;
+
         /**
          * Left child node.
          */
@@ -73,11 +147,6 @@ namespace wlp {
          */
         element_type m_element;
 
-        /**
-         * The node color.
-         */
-        color m_color;
-
         /**
          * Obtain the minimum key node starting from the given node.
          *
@@ -105,6 +174,611 @@ namespace wlp {
         }
     };
 
+    /**
+     * Maintains subtree counts while a tree is restructured. The
+     * general case is for nodes without counts, where every
+     * operation does nothing and counts are reported as zero.
+     *
+     * @tparam Node tree node type
+     */
+    template<typename Node>
+    struct RedBlackTreeCounter {
+        static constexpr bool counted = false;
+
+        static size_t count(const Node *) {
+            return 0;
+        }
+
+        static void link(Node *, Node *) {}
+
+        static void unlink(Node *, Node *) {}
+
+        static void replace(Node *, Node *) {}
+
+        static void rotate(Node *, Node *) {}
+
+        static void recount(Node *) {}
+
+        static void recount_path(Node *, Node *) {}
+    };
+
+    /**
+     * Subtree count maintenance for counted tree nodes.
+     *
+     * @tparam Element node element type
+     */
+    template<typename Element>
+    struct RedBlackTreeCounter<RedBlackTreeNode<Element, true>> {
+        typedef RedBlackTreeNode<Element, true> node_type;
+
+        static constexpr bool counted = true;
+
+        /**
+         * @param node a node, which may be null
+         * @return the number of nodes in the subtree of the node
+         */
+        static size_t count(const node_type *node) {
+            return node ? node->m_count : 0;
+        }
+
+        /**
+         * Count a newly linked leaf in each of its ancestors.
+         *
+         * @param node the linked node
+         * @param root the tree root
+         */
+        static void link(node_type *node, node_type *root) {
+            node->m_count = 1;
+            while (node != root) {
+                node = node->parent();
+                ++node->m_count;
+            }
+        }
+
+        /**
+         * Remove a node about to be unlinked from the
+         * counts of each of its ancestors.
+         *
+         * @param node the node to unlink
+         * @param root the tree root
+         */
+        static void unlink(node_type *node, node_type *root) {
+            while (node != root) {
+                node = node->parent();
+                --node->m_count;
+            }
+        }
+
+        /**
+         * Give a node the count of the node it replaces.
+         *
+         * @param node     the replacing node
+         * @param replaced the replaced node
+         */
+        static void replace(node_type *node, node_type *replaced) {
+            node->m_count = replaced->m_count;
+        }
+
+        /**
+         * Fix the counts after a rotation.
+         *
+         * @param node  the rotated node
+         * @param carry the node that took its place
+         */
+        static void rotate(node_type *node, node_type *carry) {
+            carry->m_count = node->m_count;
+            node->m_count = 1 + count(node->m_left) + count(node->m_right);
+        }
+
+        /**
+         * Compute the count of a node from its children.
+         *
+         * @param node the node to recount
+         */
+        static void recount(node_type *node) {
+            node->m_count = 1 + count(node->m_left) + count(node->m_right);
+        }
+
+        /**
+         * Recompute the counts of a node and each of its ancestors.
+         *
+         * @param node the lowest changed node
+         * @param root the tree root
+         */
+        static void recount_path(node_type *node, node_type *root) {
+            recount(node);
+            while (node != root) {
+                node = node->parent();
+                recount(node);
+            }
+        }
+    };
+
+    template<typename Node>
+    constexpr bool RedBlackTreeCounter<Node>::counted;
+
+    template<typename Element>
+    constexpr bool RedBlackTreeCounter<RedBlackTreeNode<Element, true>>::counted;
+
+    /**
+     * Perform red-black tree left rotation of the specified node
+     * about the specified root. The functions below operate on any
+     * node type derived from @code RedBlackTreeParentColor @endcode,
+     * so that both allocating and intrusive trees share them.
+     *
+     * @tparam Node tree node type
+     * @param node the node to rotate
+     * @param root the rotate root node
+     */
+    template<typename Node>
+    inline void __rb_rotate_left(Node *node, Node *&root) {
+        Node *carry = node->m_right;
+        node->m_right = carry->m_left;
+        if (carry->m_left) {
+            carry->m_left->set_parent(node);
+        }
+        carry->set_parent(node->parent());
+        if (node == root) {
+            root = carry;
+        } else if (node == node->parent()->m_left) {
+            node->parent()->m_left = carry;
+        } else {
+            node->parent()->m_right = carry;
+        }
+        carry->m_left = node;
+        node->set_parent(carry);
+        RedBlackTreeCounter<Node>::rotate(node, carry);
+    }
+
+    /**
+     * Perform red-black tree right rotation of the specified
+     * node about the specified root.
+     *
+     * @tparam Node tree node type
+     * @param node the node to rotate
+     * @param root the rotate root node
+     */
+    template<typename Node>
+    inline void __rb_rotate_right(Node *node, Node *&root) {
+        Node *carry = node->m_left;
+        node->m_left = carry->m_right;
+        if (carry->m_right) {
+            carry->m_right->set_parent(node);
+        }
+        carry->set_parent(node->parent());
+        if (node == root) {
+            root = carry;
+        } else if (node == node->parent()->m_right) {
+            node->parent()->m_right = carry;
+        } else {
+            node->parent()->m_left = carry;
+        }
+        carry->m_right = node;
+        node->set_parent(carry);
+        RedBlackTreeCounter<Node>::rotate(node, carry);
+    }
+
+    /**
+     * Restore the red-black properties after a red node has been
+     * linked below a possibly red parent.
+     *
+     * @tparam Node tree node type
+     * @param node the red node
+     * @param root the rebalance root node
+     * @return true if the black height of the tree grew by one
+     */
+    template<typename Node>
+    bool __rb_insert_fixup(Node *node, Node *&root) {
+        typedef RedBlackTreeColor color;
+        while (node != root && node->parent()->color() == color::RED) {
+            if (node->parent() == node->parent()->parent()->m_left) {
+                Node *carry = node->parent()->parent()->m_right;
+                if (carry && carry->color() == color::RED) {
+                    node->parent()->set_color(color::BLACK);
+                    carry->set_color(color::BLACK);
+                    node->parent()->parent()->set_color(color::RED);
+                    node = node->parent()->parent();
+                } else {
+                    if (node == node->parent()->m_right) {
+                        node = node->parent();
+                        __rb_rotate_left(node, root);
+                    }
+                    node->parent()->set_color(color::BLACK);
+                    node->parent()->parent()->set_color(color::RED);
+                    __rb_rotate_right(node->parent()->parent(), root);
+                }
+            } else {
+                Node *carry = node->parent()->parent()->m_left;
+                if (carry && carry->color() == color::RED) {
+                    node->parent()->set_color(color::BLACK);
+                    carry->set_color(color::BLACK);
+                    node->parent()->parent()->set_color(color::RED);
+                    node = node->parent()->parent();
+                } else {
+                    if (node == node->parent()->m_left) {
+                        node = node->parent();
+                        __rb_rotate_right(node, root);
+                    }
+                    node->parent()->set_color(color::BLACK);
+                    node->parent()->parent()->set_color(color::RED);
+                    __rb_rotate_left(node->parent()->parent(), root);
+                }
+            }
+        }
+        // the root turns red only when recoloring reaches it
+        bool grew = root->color() == color::RED;
+        root->set_color(color::BLACK);
+        return grew;
+    }
+
+    /**
+     * Perform red-black tree rebalance of a newly linked
+     * node starting from the given root.
+     *
+     * @tparam Node tree node type
+     * @param node the node to rebalance
+     * @param root the rebalance root node
+     */
+    template<typename Node>
+    inline void __rb_insert_rebalance(Node *node, Node *&root) {
+        RedBlackTreeCounter<Node>::link(node, root);
+        node->set_color(RedBlackTreeColor::RED);
+        __rb_insert_fixup(node, root);
+    }
+
+    /**
+     * Rebalance for erasure the given node. The node is eliminated
+     * from the tree during the rebalance and is prepared for deletion.
+     *
+     * @tparam Node tree node type
+     * @param node      the node to delete
+     * @param root      the root node in the tree
+     * @param leftmost  the leftmost node in the tree
+     * @param rightmost the right most node in the tree
+     * @return a pointer to the node that can be deleted
+     */
+    template<typename Node>
+    Node *__rb_erase_rebalance(Node *node, Node *&root, Node *&leftmost, Node *&rightmost) {
+        typedef RedBlackTreeColor color;
+        Node *carry = node;
+        Node *cur = 0;
+        Node *cur_parent = 0;
+        if (!carry->m_left) {
+            // node has at most one non-null child
+            // carry == node and cur might be null
+            cur = carry->m_right;
+        } else if (!carry->m_right) {
+            // node has exactly one non-null child
+            // carry == node and cur is not null
+            cur = carry->m_left;
+        } else {
+            // node has two non-null children
+            // set cur to node's successor and cur might be null
+            carry = carry->m_right;
+            while (carry->m_left) {
+                carry = carry->m_left;
+            }
+            cur = carry->m_right;
+        }
+        // carry is the node that leaves its position
+        RedBlackTreeCounter<Node>::unlink(carry, root);
+        if (carry != node) {
+            // Relink cur in place of node
+            // cur is node's successor
+            node->m_left->set_parent(carry);
+            carry->m_left = node->m_left;
+            if (carry != node->m_right) {
+                cur_parent = carry->parent();
+                if (cur) {
+                    // carry must be a child of m_left
+                    cur->set_parent(carry->parent());
+                }
+                carry->parent()->m_left = cur;
+                carry->m_right = node->m_right;
+                node->m_right->set_parent(carry);
+            } else {
+                cur_parent = carry;
+            }
+            if (root == node) {
+                root = carry;
+            } else if (node->parent()->m_left == node) {
+                node->parent()->m_left = carry;
+            } else {
+                node->parent()->m_right = carry;
+            }
+            carry->set_parent(node->parent());
+            RedBlackTreeCounter<Node>::replace(carry, node);
+            typename Node::color_type carry_color = carry->color();
+            carry->set_color(node->color());
+            node->set_color(carry_color);
+            // carry now points to node that is deleted
+            carry = node;
+        } else {
+            // here carry == node
+            cur_parent = carry->parent();
+            if (cur) {
+                cur->set_parent(carry->parent());
+            }
+            if (root == node) {
+                root = cur;
+            } else if (node->parent()->m_left == node) {
+                node->parent()->m_left = cur;
+            } else {
+                node->parent()->m_right = cur;
+            }
+            if (leftmost == node) {
+                // node->m_left might also be null
+                if (!node->m_right) {
+                    // makes leftmost == header if node == root
+                    leftmost = node->parent();
+                } else {
+                    leftmost = cur;
+                    while (leftmost->m_left) {
+                        leftmost = leftmost->m_left;
+                    }
+                }
+            }
+            if (rightmost == node) {
+                // node->m_rught might also be null
+                if (!node->m_left) {
+                    // makes rightmost == header if node == root
+                    rightmost = node->parent();
+                } else {
+                    // cur == node->m_left
+                    rightmost = cur;
+                    while (rightmost->m_right) {
+                        rightmost = rightmost->m_right;
+                    }
+                }
+            }
+        }
+        if (carry->color() != color::RED) {
+            while (cur != root && (!cur || cur->color() == color::BLACK)) {
+                if (cur == cur_parent->m_left) {
+                    Node *aux = cur_parent->m_right;
+                    if (aux->color() == color::RED) {
+                        aux->set_color(color::BLACK);
+                        cur_parent->set_color(color::RED);
+                        __rb_rotate_left(cur_parent, root);
+                        aux = cur_parent->m_right;
+                    }
+                    if ((!aux->m_left || aux->m_left->color() == color::BLACK) &&
+                        (!aux->m_right || aux->m_right->color() == color::BLACK)) {
+                        aux->set_color(color::RED);
+                        cur = cur_parent;
+                        cur_parent = cur_parent->parent();
+                    } else {
+                        if (!aux->m_right || aux->m_right->color() == color::BLACK) {
+                            if (aux->m_left) {
+                                aux->m_left->set_color(color::BLACK);
+                            }
+                            aux->set_color(color::RED);
+                            __rb_rotate_right(aux, root);
+                            aux = cur_parent->m_right;
+                        }
+                        aux->set_color(cur_parent->color());
+                        cur_parent->set_color(color::BLACK);
+                        if (aux->m_right) {
+                            aux->m_right->set_color(color::BLACK);
+                        }
+                        __rb_rotate_left(cur_parent, root);
+                        break;
+                    }
+                } else {
+                    // same as above but with left and right switched
+                    Node *aux = cur_parent->m_left;
+                    if (aux->color() == color::RED) {
+                        aux->set_color(color::BLACK);
+                        cur_parent->set_color(color::RED);
+                        __rb_rotate_right(cur_parent, root);
+                        aux = cur_parent->m_left;
+                    }
+                    if ((!aux->m_right || aux->m_right->color() == color::BLACK) &&
+                        (!aux->m_left || aux->m_left->color() == color::BLACK)) {
+                        aux->set_color(color::RED);
+                        cur = cur_parent;
+                        cur_parent = cur_parent->parent();
+                    } else {
+                        if (!aux->m_left || aux->m_left->color() == color::BLACK) {
+                            if (aux->m_right) {
+                                aux->m_right->set_color(color::BLACK);
+                            }
+                            aux->set_color(color::RED);
+                            __rb_rotate_left(aux, root);
+                            aux = cur_parent->m_left;
+                        }
+                        aux->set_color(cur_parent->color());
+                        cur_parent->set_color(color::BLACK);
+                        if (aux->m_left) {
+                            aux->m_left->set_color(color::BLACK);
+                        }
+                        __rb_rotate_right(cur_parent, root);
+                        break;
+                    }
+                }
+            }
+            if (cur) {
+                cur->set_color(color::BLACK);
+            }
+        }
+        return carry;
+    }
+
+    /**
+     * Obtain the next ordered node in the tree. The successor
+     * of the rightmost node is the header node.
+     *
+     * @tparam Node tree node type
+     * @param node the current node
+     * @return the next node
+     */
+    template<typename Node>
+    Node *__rb_increment(Node *node) {
+        if (node->m_right) {
+            node = node->m_right;
+            while (node->m_left) {
+                node = node->m_left;
+            }
+        } else {
+            Node *parent = node->parent();
+            while (node == parent->m_right) {
+                node = parent;
+                parent = parent->parent();
+            }
+            if (node->m_right != parent) {
+                node = parent;
+            }
+        }
+        return node;
+    }
+
+    /**
+     * Obtain the previous ordered node in the tree. The
+     * predecessor of the header node is the rightmost node.
+     *
+     * @tparam Node tree node type
+     * @param node the current node
+     * @return the previous node
+     */
+    template<typename Node>
+    Node *__rb_decrement(Node *node) {
+        typedef RedBlackTreeColor color;
+        if (node->color() == color::RED && node->parent()->parent() == node) {
+            node = node->m_right;
+        } else if (node->m_left) {
+            Node *child = node->m_left;
+            while (child->m_right) {
+                child = child->m_right;
+            }
+            node = child;
+        } else {
+            Node *parent = node->parent();
+            while (node == parent->m_left) {
+                node = parent;
+                parent = parent->parent();
+            }
+            node = parent;
+        }
+        return node;
+    }
+
+    /**
+     * Obtain the black height of a subtree, the number of
+     * black nodes on any path from its root down to a leaf.
+     *
+     * @tparam Node tree node type
+     * @param node the subtree root, which may be null
+     * @return the black height of the subtree
+     */
+    template<typename Node>
+    size_t __rb_black_height(Node *node) {
+        size_t height = 0;
+        while (node) {
+            if (node->color() == RedBlackTreeColor::BLACK) {
+                ++height;
+            }
+            node = node->m_left;
+        }
+        return height;
+    }
+
+    /**
+     * Join two red-black trees with a middle node, where every
+     * node of the left tree is ordered before the middle node and
+     * every node of the right tree after it. The middle node is
+     * linked where the black heights of both sides meet, so the
+     * cost is proportional to the difference in their heights.
+     * The heights are passed in rather than measured, so that
+     * repeated joins do not walk the trees again. The parent of
+     * the returned root is left unchanged.
+     *
+     * @tparam Node tree node type
+     * @param left         root of the left tree, which may be null
+     * @param left_height  black height of the left tree with its root black
+     * @param mid          the middle node, not in either tree
+     * @param right        root of the right tree, which may be null
+     * @param right_height black height of the right tree with its root black
+     * @param height       set to the black height of the joined tree
+     * @return root of the joined tree
+     */
+    template<typename Node>
+    Node *__rb_join(Node *left, size_t left_height, Node *mid,
+                    Node *right, size_t right_height, size_t &height) {
+        typedef RedBlackTreeColor color;
+        // roots of subtrees may be red
+        if (left) {
+            left->set_color(color::BLACK);
+        }
+        if (right) {
+            right->set_color(color::BLACK);
+        }
+        if (left_height == right_height) {
+            mid->m_left = left;
+            mid->m_right = right;
+            if (left) {
+                left->set_parent(mid);
+            }
+            if (right) {
+                right->set_parent(mid);
+            }
+            mid->set_color(color::BLACK);
+            RedBlackTreeCounter<Node>::recount(mid);
+            height = left_height + 1;
+            return mid;
+        }
+        Node *root;
+        Node *parent = nullptr;
+        Node *cur;
+        if (left_height > right_height) {
+            // descend the right spine of the left tree to a black
+            // node with the same black height as the right tree
+            root = left;
+            cur = left;
+            size_t height = left_height;
+            while (height > right_height || (cur && cur->color() == color::RED)) {
+                if (cur->color() == color::BLACK) {
+                    --height;
+                }
+                parent = cur;
+                cur = cur->m_right;
+            }
+            mid->m_left = cur;
+            mid->m_right = right;
+            parent->m_right = mid;
+            if (right) {
+                right->set_parent(mid);
+            }
+        } else {
+            root = right;
+            cur = right;
+            size_t height = right_height;
+            while (height > left_height || (cur && cur->color() == color::RED)) {
+                if (cur->color() == color::BLACK) {
+                    --height;
+                }
+                parent = cur;
+                cur = cur->m_left;
+            }
+            mid->m_left = left;
+            mid->m_right = cur;
+            parent->m_left = mid;
+            if (left) {
+                left->set_parent(mid);
+            }
+        }
+        if (cur) {
+            cur->set_parent(mid);
+        }
+        mid->set_parent(parent);
+        mid->set_color(color::RED);
+        RedBlackTreeCounter<Node>::recount_path(mid, root);
+        height = left_height > right_height ? left_height : right_height;
+        if (__rb_insert_fixup(mid, root)) {
+            ++height;
+        }
+        return root;
+    }
+
     /**
      * Tree iterator class, templated to enable constant and non-constant
      * derived types. This class should not be used directly.
@@ -114,6 +788,7 @@ namespace wlp {
      * @tparam Ref     reference to value type, which may be a constant reference
      * @tparam Ptr     pointer to value type, which may be a constant pointer
      * @tparam GetVal  struct which returns the value of an element
+     * @tparam Counted whether tree nodes keep subtree counts
      */
     template<typename Element,
         typename Key,
@@ -121,9 +796,10 @@ namespace wlp {
         typename Ref,
         typename Ptr,
         typename GetKey,
-        typename GetVal>
+        typename GetVal,
+        bool Counted = false>
     struct RedBlackTreeIterator {
-        typedef RedBlackTreeNode<Element> node_type;
+        typedef RedBlackTreeNode<Element, Counted> node_type;
         typedef RedBlackTreeColor color;
         typedef Key key_type;
         typedef Ref reference;
@@ -133,7 +809,7 @@ namespace wlp {
         typedef GetVal get_value;
 
     private:
-        typedef RedBlackTreeIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal> self_type;
+        typedef RedBlackTreeIterator<Element, Key, Val, Ref, Ptr, GetKey, GetVal, Counted> self_type;
 
     public:
         /**
@@ -180,43 +856,14 @@ namespace wlp {
          * Move the iterator to the next ordered node in the tree.
          */
         void increment() {
-            if (m_node->m_right) {
-                m_node = m_node->m_right;
-                while (m_node->m_left) {
-                    m_node = m_node->m_left;
-                }
-            } else {
-                node_type *parent = m_node->m_parent;
-                while (m_node == parent->m_right) {
-                    m_node = parent;
-                    parent = parent->m_parent;
-                }
-                if (m_node->m_right != parent) {
-                    m_node = parent;
-                }
-            }
+            m_node = __rb_increment(m_node);
         }
 
         /**
          * Move the iterator to the previous ordered node in the tree.
          */
         void decrement() {
-            if (m_node->m_color == color::RED && m_node->m_parent->m_parent == m_node) {
-                m_node = m_node->m_right;
-            } else if (m_node->m_left) {
-                node_type *child = m_node->m_left;
-                while (child->m_right) {
-                    child = child->m_right;
-                }
-                m_node = child;
-            } else {
-                node_type *parent = m_node->m_parent;
-                while (m_node == parent->m_left) {
-                    m_node = parent;
-                    parent = parent->m_parent;
-                }
-                m_node = parent;
-            }
+            m_node = __rb_decrement(m_node);
         }
 
         /**
@@ -344,28 +991,34 @@ namespace wlp {
      * @tparam Cmp     key comparator type, which uses the default comparator
      * @tparam GetKey  functor type used to get element key
      * @tparam GetVal  functor type used to get element value
+     * @tparam Counted whether nodes keep the size of their subtree, which
+     *                 makes positional queries logarithmic at the cost of
+     *                 one count per node
      */
     template<typename Element,
             typename Key,
             typename Val,
             typename GetKey,
             typename GetVal,
-            typename Cmp = wlp::comparator<Key>>
+            typename Cmp = wlp::comparator<Key>,
+            bool Counted = false>
     class tree {
     public:
         typedef Key key_type;
         typedef Val val_type;
         typedef Cmp comparator;
         typedef size_t size_type;
-        typedef RedBlackTreeNode<Element> node_type;
-        typedef tree<Element, Key, Val, GetKey, GetVal, Cmp> tree_type;
-        typedef RedBlackTreeIterator<Element, Key, Val, Val &, Val *, GetKey, GetVal> iterator;
-        typedef RedBlackTreeIterator<Element, Key, Val, const Val &, const Val *, GetKey, GetVal> const_iterator;
+        typedef RedBlackTreeNode<Element, Counted> node_type;
+        typedef tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted> tree_type;
+        typedef RedBlackTreeIterator<Element, Key, Val, Val &, Val *, GetKey, GetVal, Counted> iterator;
+        typedef RedBlackTreeIterator<Element, Key, Val, const Val &, const Val *, GetKey, GetVal, Counted> const_iterator;
         typedef GetKey get_key;
         typedef GetVal get_val;
+        typedef node_pool<node_type, &node_type::m_left> pool_type;
 
     protected:
         typedef RedBlackTreeColor color;
+        typedef RedBlackTreeCounter<node_type> counter;
 
         /**
          * Header node, which maintains reference to the leftmost node,
@@ -384,14 +1037,28 @@ namespace wlp {
          * Functor used to obtain element key.
          */
         get_key m_get_key{};
+        /**
+         * Pool from which nodes are obtained, or null
+         * if nodes are individually allocated.
+         */
+        pool_type *m_pool;
 
         /**
-         * Allocate a new node.
+         * Allocate a new node, from the pool if there is one.
          *
          * @return pointer to the new node
          */
         node_type *create_node() {
-            return create<node_type>();
+            if (!m_pool) {
+                return create<node_type>();
+            }
+            node_type *node = m_pool->allocate();
+            if (node) {
+                node->set_parent(nullptr);
+                node->m_left = nullptr;
+                node->m_right = nullptr;
+            }
+            return node;
         }
 
         /**
@@ -403,19 +1070,26 @@ namespace wlp {
         node_type *copy_node(node_type *node) {
             node_type *copy = create_node();
             copy->m_element = node->m_element;
-            copy->m_color = node->m_color;
+            copy->set_color(node->color());
             copy->m_left = node->m_left;
             copy->m_right = node->m_right;
+            RedBlackTreeCounter<node_type>::replace(copy, node);
             return copy;
         }
 
         /**
-         * Deallocate the given node.
+         * Return a node to the pool, resetting its element,
+         * or deallocate the node.
          *
          * @param node node to deallocate
          */
         void destroy_node(node_type *node) {
-            destroy<node_type>(node);
+            if (m_pool) {
+                node->m_element = Element();
+                m_pool->deallocate(node);
+            } else {
+                destroy<node_type>(node);
+            }
         }
 
         /**
@@ -462,6 +1136,20 @@ namespace wlp {
                 node_type *&rightmost
         );
 
+        /**
+         * Unlink a node from the tree without deallocating it.
+         *
+         * @param node the node to unlink
+         * @return the unlinked node
+         */
+        node_type *unlink_node(node_type *node) {
+            node_type *root = m_header->parent();
+            node_type *carry = erase_rebalance(node, root, m_header->m_left, m_header->m_right);
+            m_header->set_parent(root);
+            --m_size;
+            return carry;
+        }
+
         /**
          * Insert a given node at the pivot position, which will become
          * the parent node of the inserted node.
@@ -475,6 +1163,56 @@ namespace wlp {
         template<typename E>
         iterator insert(node_type *cur, node_type *carry, E &&element);
 
+        /**
+         * Link an existing node below the pivot position and
+         * rebalance the tree.
+         *
+         * @param cur   the insertion position, which is null
+         * @param carry the insertion pivot node
+         * @param node  the node to link
+         * @return iterator to the linked node
+         */
+        iterator link_node(node_type *cur, node_type *carry, node_type *node);
+
+        /**
+         * Find where a key would be linked if keys are unique.
+         *
+         * @param key   the key to link
+         * @param carry set to the pivot node below which to link
+         * @return the node with an equal key, or null if there is none
+         */
+        node_type *unique_position(const key_type &key, node_type *&carry);
+
+        /**
+         * Find where a key would be linked if keys may repeat.
+         *
+         * @param key the key to link
+         * @return the pivot node below which to link
+         */
+        node_type *equal_position(const key_type &key);
+
+        /**
+         * Set the root of the tree, updating the header links.
+         *
+         * @param root the new root, which may be null
+         * @param size the number of nodes under the root
+         */
+        void adopt_root(node_type *root, size_type size);
+
+        /**
+         * Exchange the nodes of two trees.
+         *
+         * @param tree the tree with which to exchange nodes
+         */
+        void exchange(tree_type &tree) {
+            node_type *header = m_header;
+            size_type size = m_size;
+            m_header = tree.m_header;
+            m_size = tree.m_size;
+            tree.m_header = header;
+            tree.m_size = size;
+        }
+
         /**
          * Delete the supplied node from the tree and all
          * nodes beneath it.
@@ -483,13 +1221,64 @@ namespace wlp {
          */
         void erase(node_type *root);
 
+        /**
+         * Release a node during subtree deletion. Without a pool the
+         * node is deallocated; with a pool its element is reset and
+         * it is chained through its left link, so that the whole
+         * chain is returned to the pool at once.
+         *
+         * @param node     the node to release
+         * @param released the most recently chained node
+         * @param last     the first chained node, which ends the chain
+         * @param count    the number of chained nodes
+         */
+        void release_node(node_type *node, node_type *&released, node_type *&last, size_type &count) {
+            if (!m_pool) {
+                destroy<node_type>(node);
+                return;
+            }
+            node->m_element = Element();
+            node->m_left = released;
+            released = node;
+            if (!last) {
+                last = node;
+            }
+            ++count;
+        }
+
+        /**
+         * Build a balanced subtree from a chain of preallocated nodes,
+         * filling elements in order from the iterator. Nodes deeper
+         * than the black depth are colored red, so that every path
+         * has the same number of black nodes.
+         *
+         * @param it         iterator to the next element, advanced
+         * @param free       chain of free nodes linked through their left links
+         * @param count      the number of nodes in the subtree
+         * @param depth      the depth of the subtree root
+         * @param red_depth  the depth at which nodes are red
+         * @return the subtree root, or null if the count is zero
+         */
+        template<typename It>
+        node_type *build_sorted(It &it, node_type *&free, size_type count, size_type depth, size_type red_depth);
+
+        /**
+         * Obtain the position of a node in the natural order of
+         * the tree, climbing to the root if the tree is counted
+         * and counting from the leftmost node otherwise.
+         *
+         * @param node a node in this tree or the header node
+         * @return the zero-based position of the node
+         */
+        size_type node_position(node_type *node) const;
+
         /**
          * Initialize the tree as empty, where the header
          * node children are itself and the parent is null.
          */
         void empty_initialize() {
-            m_header->m_color = color::RED;
-            m_header->m_parent = nullptr;
+            m_header->set_color(color::RED);
+            m_header->set_parent(nullptr);
             m_header->m_left = m_header;
             m_header->m_right = m_header;
         }
@@ -502,8 +1291,25 @@ namespace wlp {
          */
         explicit tree()
                 : m_header(nullptr),
-                  m_size(0) {
-            m_header = create_node();
+                  m_size(0),
+                  m_pool(nullptr) {
+            m_header = create<node_type>();
+            empty_initialize();
+        }
+
+        /**
+         * Create an empty red black tree whose nodes come from a
+         * pool, which may be shared with other trees. Nodes taken
+         * from a pool in sequence sit next to each other in its
+         * blocks. The pool must outlive the tree.
+         *
+         * @param pool the node pool to use
+         */
+        explicit tree(pool_type *pool)
+                : m_header(nullptr),
+                  m_size(0),
+                  m_pool(pool) {
+            m_header = create<node_type>();
             empty_initialize();
         }
 
@@ -519,7 +1325,8 @@ namespace wlp {
          */
         tree(tree_type &&tree)
                 : m_header(move(tree.m_header)),
-                  m_size(move(tree.m_size)) {
+                  m_size(move(tree.m_size)),
+                  m_pool(tree.m_pool) {
             tree.m_header = nullptr;
             tree.m_size = 0;
         }
@@ -530,7 +1337,7 @@ namespace wlp {
         ~tree() {
             clear();
             if (m_header) {
-                destroy_node(m_header);
+                destroy<node_type>(m_header);
             }
         }
 
@@ -589,19 +1396,47 @@ namespace wlp {
             return static_cast<size_type>(-1);
         }
 
+        /**
+         * @return the node pool used by this tree, or null
+         */
+        pool_type *pool() const {
+            return m_pool;
+        }
+
         /**
          * Delete all the nodes in the tree such that it is now empty.
+         * If the tree uses a node pool, all the nodes are returned
+         * to it in one step.
          */
         void clear() noexcept {
             if (m_size > 0) {
-                erase(m_header->m_parent);
-                m_header->m_parent = nullptr;
+                erase(m_header->parent());
+                m_header->set_parent(nullptr);
                 m_header->m_left = m_header;
                 m_header->m_right = m_header;
                 m_size = 0;
             }
         }
 
+        /**
+         * Replace the contents of the tree with the elements of a
+         * sorted range. The tree is built balanced in linear time,
+         * without comparisons or rotations. Every node is allocated
+         * before the tree is touched, so that on allocation failure
+         * the tree is left unchanged.
+         *
+         * @pre the range is sorted by key, and for containers not
+         *      allowing multiple keys no key appears twice
+         *
+         * @tparam It forward iterator type whose elements are
+         *            assignable to the tree element type
+         * @param first iterator to the first element
+         * @param last  iterator past the last element
+         * @return false if the nodes could not be allocated
+         */
+        template<typename It>
+        bool assign_sorted(It first, It last);
+
         /**
          * Insert a value with a given key into the tree. This function
          * will insert the value if its key does not exist and fail
@@ -732,28 +1567,150 @@ namespace wlp {
          * @pre The returned value is such that all nodes with the provided
          *      key are in the range @code [lower_bound(key), upper_bound(key)) @endcode.
          *
-         * @param key the key whose last node to find
-         * @return const iterator to the node right after the last node
+         * @param key the key whose last node to find
+         * @return const iterator to the node right after the last node
+         */
+        const_iterator upper_bound(const key_type &key) const;
+
+        /**
+         * Obtain the range of nodes whose keys are equal to the provided key
+         * as per @code lower_bound @endcode and @code upper_bound @endcode.
+         *
+         * @param key the key whose range to get
+         * @return a pair of iterators to the lower and upper bounds
+         */
+        pair <iterator, iterator> equal_range(const key_type &key);
+
+        /**
+         * Obtain the range of nodes whose keys are equal to the provided key
+         * as per @code lower_bound @endcode and @code upper_bound @endcode.
+         *
+         * @param key the key whose range to get
+         * @return a pair of const iterators to the lower and upper bounds
+         */
+        pair <const_iterator, const_iterator> equal_range(const key_type &val) const;
+
+        /**
+         * Move every node whose key is not less than the provided key
+         * into another tree, replacing its contents. No node is copied
+         * or reallocated. The pieces are rejoined bottom-up along the
+         * search path, tracking their black heights on the way, which
+         * takes logarithmic time overall. A counted tree then reads
+         * the sizes from the subtree counts, but an uncounted tree
+         * counts the smaller part node by node, which is linear in
+         * that part in the worst case.
+         *
+         * @param key   the key at which to split
+         * @param right the tree that receives the upper part, which
+         *              must use the same node pool as this tree
+         * @return false if the trees cannot exchange nodes
+         */
+        bool split(const key_type &key, tree_type &right);
+
+        /**
+         * Append every node of another tree to this tree in
+         * logarithmic time, leaving the other tree empty.
+         *
+         * @param right tree whose keys are all greater than those in
+         *              this tree and which uses the same node pool
+         * @return false if the trees cannot exchange nodes or their
+         * keys are not ordered, in which case neither tree changes
+         */
+        bool join(tree_type &right);
+
+        /**
+         * Move the nodes of another tree into this tree without
+         * reallocating them. Nodes whose keys are already in this
+         * tree stay in the other tree. If the key ranges of the two
+         * trees do not overlap, they are joined instead.
+         *
+         * @param other tree using the same node pool as this tree
+         * @return the number of nodes moved
+         */
+        size_type merge_unique(tree_type &other);
+
+        /**
+         * Move every node of another tree into this tree without
+         * reallocating them, allowing duplicate keys.
+         *
+         * @param other tree using the same node pool as this tree
+         * @return the number of nodes moved
+         */
+        size_type merge_equal(tree_type &other);
+
+        /**
+         * Obtain an iterator to the node at the given position in
+         * the natural order of the tree. Logarithmic if the tree is
+         * counted and linear otherwise.
+         *
+         * @param k zero-based position of the node
+         * @return iterator to the node or pass-the-end if the
+         * position is out of range
+         */
+        iterator nth(size_type k);
+
+        /**
+         * Obtain a const iterator to the node at the given position
+         * in the natural order of the tree.
+         *
+         * @param k zero-based position of the node
+         * @return const iterator to the node or pass-the-end if the
+         * position is out of range
+         */
+        const_iterator nth(size_type k) const;
+
+        /**
+         * Obtain the number of nodes whose keys are less than
+         * the provided key, which is the position of
+         * @code lower_bound(key) @endcode. Logarithmic if the
+         * tree is counted and linear otherwise.
+         *
+         * @param key the key whose rank to find
+         * @return the number of nodes ordered before the key
          */
-        const_iterator upper_bound(const key_type &key) const;
+        size_type rank(const key_type &key) const;
 
         /**
-         * Obtain the range of nodes whose keys are equal to the provided key
-         * as per @code lower_bound @endcode and @code upper_bound @endcode.
+         * Obtain the position of the node pointed to by an iterator
+         * in the natural order of the tree. The position of the
+         * pass-the-end iterator is the size of the tree.
          *
-         * @param key the key whose range to get
-         * @return a pair of iterators to the lower and upper bounds
+         * @param pos iterator to a node in this tree
+         * @return the zero-based position of the node
          */
-        pair <iterator, iterator> equal_range(const key_type &key);
+        size_type position(const iterator &pos) const {
+            return node_position(pos.m_node);
+        }
 
         /**
-         * Obtain the range of nodes whose keys are equal to the provided key
-         * as per @code lower_bound @endcode and @code upper_bound @endcode.
+         * @param pos const iterator to a node in this tree
+         * @return the zero-based position of the node
+         */
+        size_type position(const const_iterator &pos) const {
+            return node_position(pos.m_node);
+        }
+
+        /**
+         * Obtain the number of nodes in the range
+         * @code [first, last) @endcode.
          *
-         * @param key the key whose range to get
-         * @return a pair of const iterators to the lower and upper bounds
+         * @param first iterator to the first node
+         * @param last  iterator after the last node, which must not
+         *              be ordered before the first
+         * @return the number of nodes in the range
          */
-        pair <const_iterator, const_iterator> equal_range(const key_type &val) const;
+        size_type distance(const iterator &first, const iterator &last) const {
+            return node_position(last.m_node) - node_position(first.m_node);
+        }
+
+        /**
+         * @param first const iterator to the first node
+         * @param last  const iterator after the last node
+         * @return the number of nodes in the range
+         */
+        size_type distance(const const_iterator &first, const const_iterator &last) const {
+            return node_position(last.m_node) - node_position(first.m_node);
+        }
 
         /**
          * Disable copy assignemnt.
@@ -773,9 +1730,10 @@ namespace wlp {
          */
         tree_type &operator=(tree_type &&tree) {
             clear();
-            destroy_node(m_header);
+            destroy<node_type>(m_header);
             m_size = move(tree.m_size);
             m_header = move(tree.m_header);
+            m_pool = tree.m_pool;
             tree.m_size = 0;
             tree.m_header = 0;
             return *this;
@@ -784,264 +1742,58 @@ namespace wlp {
     };
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::rotateLeft(node_type *node, node_type *&root) {
-        node_type *carry = node->m_right;
-        node->m_right = carry->m_left;
-        if (carry->m_left) {
-            carry->m_left->m_parent = node;
-        }
-        carry->m_parent = node->m_parent;
-        if (node == root) {
-            root = carry;
-        } else if (node == node->m_parent->m_left) {
-            node->m_parent->m_left = carry;
-        } else {
-            node->m_parent->m_right = carry;
-        }
-        carry->m_left = node;
-        node->m_parent = carry;
+        __rb_rotate_left(node, root);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::rotateRight(node_type *node, node_type *&root) {
-        node_type *carry = node->m_left;
-        node->m_left = carry->m_right;
-        if (carry->m_right) {
-            carry->m_right->m_parent = node;
-        }
-        carry->m_parent = node->m_parent;
-        if (node == root) {
-            root = carry;
-        } else if (node == node->m_parent->m_right) {
-            node->m_parent->m_right = carry;
-        } else {
-            node->m_parent->m_left = carry;
-        }
-        carry->m_right = node;
-        node->m_parent = carry;
+        __rb_rotate_right(node, root);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::rebalance(node_type *node, node_type *&root) {
-        node->m_color = color::RED;
-        while (node != root && node->m_parent->m_color == color::RED) {
-            if (node->m_parent == node->m_parent->m_parent->m_left) {
-                node_type *carry = node->m_parent->m_parent->m_right;
-                if (carry && carry->m_color == color::RED) {
-                    node->m_parent->m_color = color::BLACK;
-                    carry->m_color = color::BLACK;
-                    node->m_parent->m_parent->m_color = color::RED;
-                    node = node->m_parent->m_parent;
-                } else {
-                    if (node == node->m_parent->m_right) {
-                        node = node->m_parent;
-                        rotateLeft(node, root);
-                    }
-                    node->m_parent->m_color = color::BLACK;
-                    node->m_parent->m_parent->m_color = color::RED;
-                    rotateRight(node->m_parent->m_parent, root);
-                }
-            } else {
-                node_type *carry = node->m_parent->m_parent->m_left;
-                if (carry && carry->m_color == color::RED) {
-                    node->m_parent->m_color = color::BLACK;
-                    carry->m_color = color::BLACK;
-                    node->m_parent->m_parent->m_color = color::RED;
-                    node = node->m_parent->m_parent;
-                } else {
-                    if (node == node->m_parent->m_left) {
-                        node = node->m_parent;
-                        rotateRight(node, root);
-                    }
-                    node->m_parent->m_color = color::BLACK;
-                    node->m_parent->m_parent->m_color = color::RED;
-                    rotateLeft(node->m_parent->m_parent, root);
-                }
-            }
-        }
-        root->m_color = color::BLACK;
+        __rb_insert_rebalance(node, root);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::node_type *
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::node_type *
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::erase_rebalance(
             node_type *node,
             node_type *&root,
             node_type *&leftmost,
             node_type *&rightmost) {
-        node_type *carry = node;
-        node_type *cur = 0;
-        node_type *cur_parent = 0;
-        if (!carry->m_left) {
-            // node has at most one non-null child
-            // carry == node and cur might be null
-            cur = carry->m_right;
-        } else if (!carry->m_right) {
-            // node has exactly one non-null child
-            // carry == node and cur is not null
-            cur = carry->m_left;
-        } else {
-            // node has two non-null children
-            // set cur to node's successor and cur might be null
-            carry = carry->m_right;
-            while (carry->m_left) {
-                carry = carry->m_left;
-            }
-            cur = carry->m_right;
-        }
-        if (carry != node) {
-            // Relink cur in place of node
-            // cur is node's successor
-            node->m_left->m_parent = carry;
-            carry->m_left = node->m_left;
-            if (carry != node->m_right) {
-                cur_parent = carry->m_parent;
-                if (cur) {
-                    // carry must be a child of m_left
-                    cur->m_parent = carry->m_parent;
-                }
-                carry->m_parent->m_left = cur;
-                carry->m_right = node->m_right;
-                node->m_right->m_parent = carry;
-            } else {
-                cur_parent = carry;
-            }
-            if (root == node) {
-                root = carry;
-            } else if (node->m_parent->m_left == node) {
-                node->m_parent->m_left = carry;
-            } else {
-                node->m_parent->m_right = carry;
-            }
-            carry->m_parent = node->m_parent;
-            swap(carry->m_color, node->m_color);
-            // carry now points to node that is deleted
-            carry = node;
-        } else {
-            // here carry == node
-            cur_parent = carry->m_parent;
-            if (cur) {
-                cur->m_parent = carry->m_parent;
-            }
-            if (root == node) {
-                root = cur;
-            } else if (node->m_parent->m_left == node) {
-                node->m_parent->m_left = cur;
-            } else {
-                node->m_parent->m_right = cur;
-            }
-            if (leftmost == node) {
-                // node->m_left might also be null
-                if (!node->m_right) {
-                    // makes leftmost == header if node == root
-                    leftmost = node->m_parent;
-                } else {
-                    leftmost = node_type::find_minimum(cur);
-                }
-            }
-            if (rightmost == node) {
-                // node->m_rught might also be null
-                if (!node->m_left) {
-                    // makes rightmost == header if node == root
-                    rightmost = node->m_parent;
-                } else {
-                    // cur == node->m_left
-                    rightmost = node_type::find_maximum(cur);
-                }
-            }
-        }
-        if (carry->m_color != color::RED) {
-            while (cur != root && (!cur || cur->m_color == color::BLACK)) {
-                if (cur == cur_parent->m_left) {
-                    node_type *aux = cur_parent->m_right;
-                    if (aux->m_color == color::RED) {
-                        aux->m_color = color::BLACK;
-                        cur_parent->m_color = color::RED;
-                        rotateLeft(cur_parent, root);
-                        aux = cur_parent->m_right;
-                    }
-                    if ((!aux->m_left || aux->m_left->m_color == color::BLACK) &&
-                        (!aux->m_right || aux->m_right->m_color == color::BLACK)) {
-                        aux->m_color = color::RED;
-                        cur = cur_parent;
-                        cur_parent = cur_parent->m_parent;
-                    } else {
-                        if (!aux->m_right || aux->m_right->m_color == color::BLACK) {
-                            if (aux->m_left) {
-                                aux->m_left->m_color = color::BLACK;
-                            }
-                            aux->m_color = color::RED;
-                            rotateRight(aux, root);
-                            aux = cur_parent->m_right;
-                        }
-                        aux->m_color = cur_parent->m_color;
-                        cur_parent->m_color = color::BLACK;
-                        if (aux->m_right) {
-                            aux->m_right->m_color = color::BLACK;
-                        }
-                        rotateLeft(cur_parent, root);
-                        break;
-                    }
-                } else {
-                    // same as above but with left and right switched
-                    node_type *aux = cur_parent->m_left;
-                    if (aux->m_color == color::RED) {
-                        aux->m_color = color::BLACK;
-                        cur_parent->m_color = color::RED;
-                        rotateRight(cur_parent, root);
-                        aux = cur_parent->m_left;
-                    }
-                    if ((!aux->m_right || aux->m_right->m_color == color::BLACK) &&
-                        (!aux->m_left || aux->m_left->m_color == color::BLACK)) {
-                        aux->m_color = color::RED;
-                        cur = cur_parent;
-                        cur_parent = cur_parent->m_parent;
-                    } else {
-                        if (!aux->m_left || aux->m_left->m_color == color::BLACK) {
-                            if (aux->m_right) {
-                                aux->m_right->m_color = color::BLACK;
-                            }
-                            aux->m_color = color::RED;
-                            rotateLeft(aux, root);
-                            aux = cur_parent->m_left;
-                        }
-                        aux->m_color = cur_parent->m_color;
-                        cur_parent->m_color = color::BLACK;
-                        if (aux->m_left) {
-                            aux->m_left->m_color = color::BLACK;
-                        }
-                        rotateRight(cur_parent, root);
-                        break;
-                    }
-                }
-            }
-            if (cur) {
-                cur->m_color = color::BLACK;
-            }
-        }
-        return carry;
+        return __rb_erase_rebalance(node, root, leftmost, rightmost);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
     template<typename E>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::insert(node_type *cur, node_type *carry, E &&element) {
         node_type *node = create_node();
         node->m_element = forward<E>(element);
-        if (carry == m_header || cur || m_cmp.__lt__(m_get_key(element), m_get_key(carry->m_element))) {
+        return link_node(cur, carry, node);
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::link_node(node_type *cur, node_type *carry, node_type *node) {
+        if (carry == m_header || cur || m_cmp.__lt__(m_get_key(node->m_element), m_get_key(carry->m_element))) {
             carry->m_left = node;
             if (carry == m_header) {
-                m_header->m_parent = node;
+                m_header->set_parent(node);
                 m_header->m_right = node;
             } else if (carry == m_header->m_left) {
                 m_header->m_left = node;
@@ -1052,64 +1804,89 @@ namespace wlp {
                 m_header->m_right = node;
             }
         }
-        node->m_parent = carry;
+        node->set_parent(carry);
         node->m_left = nullptr;
         node->m_right = nullptr;
-        rebalance(node, m_header->m_parent);
+        node_type *root = m_header->parent();
+        rebalance(node, root);
+        m_header->set_parent(root);
         ++m_size;
         return iterator(node);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
     template<typename E>
-    pair<typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator, bool>
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    pair<typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator, bool>
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::insert_unique(E &&element) {
-        node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *carry;
+        node_type *found = unique_position(m_get_key(element), carry);
+        if (found) {
+            return pair<iterator, bool>(iterator(found), false);
+        }
+        return pair<iterator, bool>(insert(nullptr, carry, forward<E>(element)), true);
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::node_type *
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::unique_position(const key_type &key, node_type *&carry) {
+        carry = m_header;
+        node_type *cur = m_header->parent();
         bool compare = true;
         while (cur) {
             carry = cur;
-            compare = m_cmp.__lt__(m_get_key(element), m_get_key(cur->m_element));
+            compare = m_cmp.__lt__(key, m_get_key(cur->m_element));
             cur = compare ? cur->m_left : cur->m_right;
         }
-        iterator tmp = iterator(carry);
+        node_type *tmp = carry;
         if (compare) {
-            if (tmp == begin()) {
-                return pair<iterator, bool>(insert(cur, carry, forward<E>(element)), true);
-            } else {
-                --tmp;
+            if (tmp == m_header->m_left) {
+                return nullptr;
             }
+            tmp = __rb_decrement(tmp);
         }
-        if (m_cmp.__lt__(m_get_key(tmp.m_node->m_element), m_get_key(element))) {
-            return pair<iterator, bool>(insert(cur, carry, forward<E>(element)), true);
+        if (m_cmp.__lt__(m_get_key(tmp->m_element), key)) {
+            return nullptr;
         }
-        return pair<iterator, bool>(tmp, false);
+        return tmp;
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
     template<typename E>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::insert_equal(E &&element) {
+        return insert(nullptr, equal_position(m_get_key(element)), forward<E>(element));
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::node_type *
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::equal_position(const key_type &key) {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             carry = cur;
-            cur = m_cmp.__lt__(m_get_key(element), m_get_key(cur->m_element)) ? cur->m_left : cur->m_right;
+            cur = m_cmp.__lt__(key, m_get_key(cur->m_element)) ? cur->m_left : cur->m_right;
         }
-        return insert(cur, carry, forward<E>(element));
+        return carry;
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::erase(node_type *root) {
         node_type *current;
         node_type *pre;
         node_type *tmp;
+        node_type *released = nullptr;
+        node_type *last = nullptr;
+        size_type count = 0;
         if (!root) {
             return;
         }
@@ -1118,7 +1895,7 @@ namespace wlp {
             if (!current->m_left) {
                 tmp = current;
                 current = current->m_right;
-                destroy_node(tmp);
+                release_node(tmp, released, last, count);
             } else {
                 pre = current->m_left;
                 while (pre->m_right && pre->m_right != current) {
@@ -1133,34 +1910,36 @@ namespace wlp {
                     pre->m_right = nullptr;
                     tmp = current;
                     current = current->m_right;
-                    destroy_node(tmp);
+                    release_node(tmp, released, last, count);
                 }
             }
         }
+        if (released) {
+            m_pool->deallocate(released, last, count);
+        }
     }
 
+
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline void tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::erase(const iterator &pos) {
-        node_type *carry = erase_rebalance(pos.m_node, m_header->m_parent, m_header->m_left, m_header->m_right);
-        destroy_node(carry);
-        --m_size;
+        destroy_node(unlink_node(pos.m_node));
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::size_type
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::erase(const key_type &cur) {
         pair<iterator, iterator> res = equal_range(cur);
         return erase(res.m_first, res.m_second);
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::size_type
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::erase(const iterator &first, const iterator &last) {
         size_type count;
         if (first == begin() && last == end()) {
@@ -1178,12 +1957,12 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::find(const key_type &key) {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             if (!m_cmp.__lt__(m_get_key(cur->m_element), key)) {
                 carry = cur;
@@ -1197,12 +1976,12 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::find(const key_type &key) const {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             if (!m_cmp.__lt__(m_get_key(cur->m_element), key)) {
                 carry = cur;
@@ -1216,9 +1995,9 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::size_type
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::count(const key_type &key) const {
         pair<const_iterator, const_iterator> res = equal_range(key);
         size_type count = 0;
@@ -1230,12 +2009,12 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::lower_bound(const key_type &key) {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             if (!m_cmp.__lt__(m_get_key(cur->m_element), key)) {
                 carry = cur;
@@ -1248,12 +2027,12 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::upper_bound(const key_type &key) {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             if (m_cmp.__lt__(key, m_get_key(cur->m_element))) {
                 carry = cur;
@@ -1267,12 +2046,12 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::lower_bound(const key_type &key) const {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             if (!m_cmp.__lt__(m_get_key(cur->m_element), key)) {
                 carry = cur;
@@ -1285,12 +2064,12 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
-    typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::upper_bound(const key_type &key) const {
         node_type *carry = m_header;
-        node_type *cur = m_header->m_parent;
+        node_type *cur = m_header->parent();
         while (cur) {
             if (m_cmp.__lt__(key, m_get_key(cur->m_element))) {
                 carry = cur;
@@ -1304,28 +2083,355 @@ namespace wlp {
     }
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
     inline pair<
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator,
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::iterator
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator,
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
     >
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::equal_range(const key_type &key) {
         return pair<iterator, iterator>(lower_bound(key), upper_bound(key));
     }
 
 
     template<typename Element, typename Key, typename Val,
-            typename GetKey, typename GetVal, typename Cmp>
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
     inline pair<
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator,
-            typename tree<Element, Key, Val, GetKey, GetVal, Cmp>::const_iterator
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::const_iterator,
+            typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::const_iterator
     >
-    tree<Element, Key, Val, GetKey, GetVal, Cmp>
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
     ::equal_range(const key_type &key) const {
         return pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
     }
 
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::nth(size_type k) {
+        if (k >= m_size) {
+            return end();
+        }
+        if (!counter::counted) {
+            iterator it = begin();
+            while (k--) {
+                ++it;
+            }
+            return it;
+        }
+        node_type *cur = m_header->parent();
+        while (true) {
+            size_type left = counter::count(cur->m_left);
+            if (k < left) {
+                cur = cur->m_left;
+            } else if (k == left) {
+                return iterator(cur);
+            } else {
+                k -= left + 1;
+                cur = cur->m_right;
+            }
+        }
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    inline typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::const_iterator
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::nth(size_type k) const {
+        return const_iterator(const_cast<tree_type *>(this)->nth(k).m_node);
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::rank(const key_type &key) const {
+        if (!counter::counted) {
+            return node_position(lower_bound(key).m_node);
+        }
+        size_type result = 0;
+        node_type *cur = m_header->parent();
+        while (cur) {
+            if (!m_cmp.__lt__(m_get_key(cur->m_element), key)) {
+                cur = cur->m_left;
+            } else {
+                result += counter::count(cur->m_left) + 1;
+                cur = cur->m_right;
+            }
+        }
+        return result;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::node_position(node_type *node) const {
+        if (node == m_header) {
+            return m_size;
+        }
+        if (!counter::counted) {
+            size_type result = 0;
+            for (node_type *cur = m_header->m_left; cur != node; cur = __rb_increment(cur)) {
+                ++result;
+            }
+            return result;
+        }
+        size_type result = counter::count(node->m_left);
+        while (node != m_header->parent()) {
+            node_type *parent = node->parent();
+            if (node == parent->m_right) {
+                result += counter::count(parent->m_left) + 1;
+            }
+            node = parent;
+        }
+        return result;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    template<typename It>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::node_type *
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::build_sorted(It &it, node_type *&free, size_type count, size_type depth, size_type red_depth) {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_type left_count = (count - 1) / 2;
+        node_type *left = build_sorted(it, free, left_count, depth + 1, red_depth);
+        node_type *node = free;
+        free = free->m_left;
+        node->m_element = *it;
+        ++it;
+        node->set_color(depth == red_depth ? color::RED : color::BLACK);
+        node->m_left = left;
+        if (left) {
+            left->set_parent(node);
+        }
+        node->m_right = build_sorted(it, free, count - 1 - left_count, depth + 1, red_depth);
+        if (node->m_right) {
+            node->m_right->set_parent(node);
+        }
+        counter::recount(node);
+        return node;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    template<typename It>
+    bool tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::assign_sorted(It first, It last) {
+        size_type count = 0;
+        for (It it = first; it != last; ++it) {
+            ++count;
+        }
+        // allocate every node first, chained through their left links
+        node_type *free = nullptr;
+        for (size_type i = 0; i < count; ++i) {
+            node_type *node = create_node();
+            if (!node) {
+                while (free) {
+                    node = free;
+                    free = free->m_left;
+                    destroy_node(node);
+                }
+                return false;
+            }
+            node->m_left = free;
+            free = node;
+        }
+        clear();
+        if (count == 0) {
+            return true;
+        }
+        // nodes on the partially filled level below
+        // the full levels are red
+        size_type full_levels = 0;
+        while ((static_cast<size_type>(2) << full_levels) - 1 <= count) {
+            ++full_levels;
+        }
+        node_type *root = build_sorted(first, free, count, 0, full_levels);
+        root->set_parent(m_header);
+        root->set_color(color::BLACK);
+        m_header->set_parent(root);
+        m_header->m_left = node_type::find_minimum(root);
+        m_header->m_right = node_type::find_maximum(root);
+        m_size = count;
+        return true;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    void tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::adopt_root(node_type *root, size_type size) {
+        m_header->set_parent(root);
+        if (root) {
+            root->set_parent(m_header);
+            root->set_color(color::BLACK);
+            m_header->m_left = node_type::find_minimum(root);
+            m_header->m_right = node_type::find_maximum(root);
+        } else {
+            m_header->m_left = m_header;
+            m_header->m_right = m_header;
+        }
+        m_size = size;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    bool tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::split(const key_type &key, tree_type &right) {
+        if (&right == this || right.m_pool != m_pool) {
+            return false;
+        }
+        right.clear();
+        if (m_size == 0) {
+            return true;
+        }
+        node_type *node = m_header->parent();
+        node_type *last = nullptr;
+        while (node) {
+            last = node;
+            node = m_cmp.__lt__(m_get_key(node->m_element), key) ? node->m_right : node->m_left;
+        }
+        // climb the search path, joining each node and its
+        // off-path subtree to the part it belongs to; black heights
+        // are tracked on the way up so that no join has to measure
+        node_type *lower = nullptr;
+        node_type *upper = nullptr;
+        size_t lower_height = 0;
+        size_t upper_height = 0;
+        // black height of the children of the current node,
+        // which is zero below the end of the search path
+        size_t height = 0;
+        node = last;
+        while (node != m_header) {
+            node_type *parent = node->parent();
+            bool black = node->color() == color::BLACK;
+            if (m_cmp.__lt__(m_get_key(node->m_element), key)) {
+                node_type *off = node->m_left;
+                size_t off_height = height + (off && off->color() == color::RED ? 1 : 0);
+                lower = __rb_join(off, off_height, node, lower, lower_height, lower_height);
+            } else {
+                node_type *off = node->m_right;
+                size_t off_height = height + (off && off->color() == color::RED ? 1 : 0);
+                upper = __rb_join(upper, upper_height, node, off, off_height, upper_height);
+            }
+            if (black) {
+                ++height;
+            }
+            node = parent;
+        }
+        size_type total = m_size;
+        adopt_root(lower, 0);
+        right.adopt_root(upper, 0);
+        if (counter::counted) {
+            m_size = counter::count(lower);
+            right.m_size = total - m_size;
+            return true;
+        }
+        size_type count = 0;
+        node_type *a = m_header->m_left;
+        node_type *b = right.m_header->m_left;
+        while (a != m_header && b != right.m_header) {
+            a = __rb_increment(a);
+            b = __rb_increment(b);
+            ++count;
+        }
+        m_size = a == m_header ? count : total - count;
+        right.m_size = total - m_size;
+        return true;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    bool tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::join(tree_type &right) {
+        if (&right == this || right.m_pool != m_pool) {
+            return false;
+        }
+        if (right.m_size == 0) {
+            return true;
+        }
+        if (m_size == 0) {
+            exchange(right);
+            return true;
+        }
+        if (!m_cmp.__lt__(m_get_key(m_header->m_right->m_element), m_get_key(right.m_header->m_left->m_element))) {
+            return false;
+        }
+        size_type total = m_size + right.m_size;
+        node_type *mid = right.unlink_node(right.m_header->m_left);
+        node_type *left_root = m_header->parent();
+        node_type *right_root = right.m_header->parent();
+        size_t height;
+        adopt_root(__rb_join(left_root, __rb_black_height(left_root), mid,
+                             right_root, __rb_black_height(right_root), height), total);
+        right.empty_initialize();
+        right.m_size = 0;
+        return true;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::merge_unique(tree_type &other) {
+        if (&other == this || other.m_pool != m_pool || other.m_size == 0) {
+            return 0;
+        }
+        size_type count = other.m_size;
+        if (join(other)) {
+            // also taken when this tree is empty
+            return count;
+        }
+        if (other.join(*this)) {
+            exchange(other);
+            return count;
+        }
+        count = 0;
+        node_type *node = other.m_header->m_left;
+        while (node != other.m_header) {
+            node_type *next = __rb_increment(node);
+            node_type *carry;
+            if (!unique_position(m_get_key(node->m_element), carry)) {
+                other.unlink_node(node);
+                link_node(nullptr, carry, node);
+                ++count;
+            }
+            node = next;
+        }
+        return count;
+    }
+
+    template<typename Element, typename Key, typename Val,
+            typename GetKey, typename GetVal, typename Cmp, bool Counted>
+    typename tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>::size_type
+    tree<Element, Key, Val, GetKey, GetVal, Cmp, Counted>
+    ::merge_equal(tree_type &other) {
+        if (&other == this || other.m_pool != m_pool || other.m_size == 0) {
+            return 0;
+        }
+        size_type count = other.m_size;
+        if (join(other)) {
+            return count;
+        }
+        if (other.join(*this)) {
+            exchange(other);
+            return count;
+        }
+        node_type *node = other.m_header->m_left;
+        while (node != other.m_header) {
+            node_type *next = __rb_increment(node);
+            other.unlink_node(node);
+            link_node(nullptr, equal_position(m_get_key(node->m_element)), node);
+            node = next;
+        }
+        other.m_size = 0;
+        return count;
+    }
+
 }
 
 #endif //EMBEDDEDCPLUSPLUS_REDBLACKTREE_H
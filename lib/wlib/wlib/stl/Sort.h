@@ -0,0 +1,1067 @@
+/**
+ * @file Sort.h
+ * @brief Comparison sorting over random access structures.
+ *
+ * This file contains an introspective sort for data structures
+ * that supply a @code RandomAccessIterator @endcode. The sort is
+ * a pattern-defeating quicksort: small ranges are finished with
+ * insertion sort, ranges that appear already sorted are detected
+ * and finished early, and a range that repeatedly partitions badly
+ * falls back to heap sort, so the worst case stays O(n log n).
+ * The sort is not stable.
+ *
+ * A stable merge sort is also provided, which merges through a
+ * temporary buffer of half the range, or in place by rotations
+ * if the buffer cannot be allocated.
+ *
+ * Partial sort and nth element order only part of a range: partial
+ * sort selects the smallest elements through a heap, and nth element
+ * runs the introsort partitioning on the side holding the requested
+ * position only, which takes linear time on average.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SORT_H
+#define EMBEDDEDCPLUSPLUS_SORT_H
+
+#include <wlib/memory>
+#include <wlib/utility>
+
+#include <wlib/stl/ArrayHeap.h>
+#include <wlib/stl/ArrayList.h>
+#include <wlib/stl/LinkedList.h>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Concept.h>
+#include <wlib/stl/Helper.h>
+#include <wlib/stl/TypeTraits.h>
+
+namespace wlp {
+
+    /**
+     * Ranges of at most this size are sorted with insertion sort.
+     */
+    static constexpr size_t __sort_insertion_threshold = 24;
+    /**
+     * Ranges larger than this size select the pivot from
+     * the median of three medians.
+     */
+    static constexpr size_t __sort_ninther_threshold = 128;
+    /**
+     * Partial insertion sort gives up after moving this
+     * many elements.
+     */
+    static constexpr size_t __sort_partial_insertion_limit = 8;
+    /**
+     * Merge sort finishes ranges of at most this size
+     * with insertion sort.
+     */
+    static constexpr size_t __merge_sort_insertion_threshold = 16;
+
+    /**
+     * Swap the elements at two indices.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @param first iterator to the first element in the structure
+     * @param i first index
+     * @param j second index
+     */
+    template<typename RandomAccessIterator, typename SizeType>
+    inline void __sort_swap(RandomAccessIterator first, SizeType i, SizeType j) {
+        swap(*(first + i), *(first + j));
+    }
+
+    /**
+     * Order the elements at two indices.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param i index that will hold the smaller element
+     * @param j index that will hold the larger element
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    inline void __sort2(RandomAccessIterator first, SizeType i, SizeType j, Cmp &cmp) {
+        if (cmp.__lt__(*(first + j), *(first + i))) {
+            __sort_swap(first, i, j);
+        }
+    }
+
+    /**
+     * Order the elements at three indices.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param i index that will hold the smallest element
+     * @param j index that will hold the median element
+     * @param k index that will hold the largest element
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    inline void __sort3(RandomAccessIterator first, SizeType i, SizeType j, SizeType k, Cmp &cmp) {
+        __sort2(first, i, j, cmp);
+        __sort2(first, j, k, cmp);
+        __sort2(first, i, j, cmp);
+    }
+
+    /**
+     * Insertion sort the elements in @code [lo, hi) @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __insertion_sort(RandomAccessIterator first, SizeType lo, SizeType hi, Cmp &cmp) {
+        if (lo == hi) {
+            return;
+        }
+        for (SizeType i = static_cast<SizeType>(lo + 1); i < hi; ++i) {
+            if (cmp.__lt__(*(first + i), *(first + (i - 1)))) {
+                ValType tmp(move(*(first + i)));
+                SizeType j = i;
+                do {
+                    *(first + j) = move(*(first + (j - 1)));
+                    --j;
+                } while (j > lo && cmp.__lt__(tmp, *(first + (j - 1))));
+                *(first + j) = move(tmp);
+            }
+        }
+    }
+
+    /**
+     * Insertion sort the elements in @code [lo, hi) @endcode,
+     * assuming the element at @code lo - 1 @endcode is not greater
+     * than any element in the range, so the inner loop needs no
+     * bounds check.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __unguarded_insertion_sort(RandomAccessIterator first, SizeType lo, SizeType hi, Cmp &cmp) {
+        if (lo == hi) {
+            return;
+        }
+        for (SizeType i = static_cast<SizeType>(lo + 1); i < hi; ++i) {
+            if (cmp.__lt__(*(first + i), *(first + (i - 1)))) {
+                ValType tmp(move(*(first + i)));
+                SizeType j = i;
+                do {
+                    *(first + j) = move(*(first + (j - 1)));
+                    --j;
+                } while (cmp.__lt__(tmp, *(first + (j - 1))));
+                *(first + j) = move(tmp);
+            }
+        }
+    }
+
+    /**
+     * Attempt to insertion sort the elements in @code [lo, hi) @endcode,
+     * giving up if more than a few elements need to be moved.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     * @return true if the range was sorted
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    bool __partial_insertion_sort(RandomAccessIterator first, SizeType lo, SizeType hi, Cmp &cmp) {
+        if (lo == hi) {
+            return true;
+        }
+        size_t moved = 0;
+        for (SizeType i = static_cast<SizeType>(lo + 1); i < hi; ++i) {
+            if (cmp.__lt__(*(first + i), *(first + (i - 1)))) {
+                ValType tmp(move(*(first + i)));
+                SizeType j = i;
+                do {
+                    *(first + j) = move(*(first + (j - 1)));
+                    --j;
+                } while (j > lo && cmp.__lt__(tmp, *(first + (j - 1))));
+                *(first + j) = move(tmp);
+                moved += i - j;
+            }
+            if (moved > __sort_partial_insertion_limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Partition @code [lo, hi) @endcode around the pivot at @code lo @endcode
+     * such that elements less than the pivot are placed to its left.
+     * Elements equal to the pivot go to the right. The range must
+     * contain an element not less than the pivot after @code lo @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the pivot and first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     * @param already_partitioned set to true if no elements were swapped
+     * @return the final index of the pivot
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    SizeType __partition_right(
+            RandomAccessIterator first,
+            SizeType lo,
+            SizeType hi,
+            Cmp &cmp,
+            bool &already_partitioned
+    ) {
+        ValType pivot(move(*(first + lo)));
+        SizeType i = lo;
+        SizeType j = hi;
+        while (cmp.__lt__(*(first + ++i), pivot));
+        if (i - 1 == lo) {
+            while (i < j && !cmp.__lt__(*(first + --j), pivot));
+        } else {
+            while (!cmp.__lt__(*(first + --j), pivot));
+        }
+        already_partitioned = i >= j;
+        while (i < j) {
+            __sort_swap(first, i, j);
+            while (cmp.__lt__(*(first + ++i), pivot));
+            while (!cmp.__lt__(*(first + --j), pivot));
+        }
+        SizeType pivot_index = static_cast<SizeType>(i - 1);
+        *(first + lo) = move(*(first + pivot_index));
+        *(first + pivot_index) = move(pivot);
+        return pivot_index;
+    }
+
+    /**
+     * Partition @code [lo, hi) @endcode around the pivot at @code lo @endcode
+     * such that elements equal to the pivot are placed to its left.
+     * Used when the pivot is equal to the element preceding the range,
+     * which puts every element equal to the pivot into place at once.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the pivot and first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     * @return the final index of the pivot
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    SizeType __partition_left(RandomAccessIterator first, SizeType lo, SizeType hi, Cmp &cmp) {
+        ValType pivot(move(*(first + lo)));
+        SizeType i = lo;
+        SizeType j = hi;
+        while (cmp.__lt__(pivot, *(first + --j)));
+        if (j + 1 == hi) {
+            while (i < j && !cmp.__lt__(pivot, *(first + ++i)));
+        } else {
+            while (!cmp.__lt__(pivot, *(first + ++i)));
+        }
+        while (i < j) {
+            __sort_swap(first, i, j);
+            while (cmp.__lt__(pivot, *(first + --j)));
+            while (!cmp.__lt__(pivot, *(first + ++i)));
+        }
+        *(first + lo) = move(*(first + j));
+        *(first + j) = move(pivot);
+        return j;
+    }
+
+    /**
+     * Heap sort the elements in @code [lo, hi) @endcode. Used as the
+     * fallback when introsort detects too many unbalanced partitions.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __heap_sort_range(RandomAccessIterator first, SizeType lo, SizeType hi, Cmp &cmp) {
+        RandomAccessIterator base = first + lo;
+        SizeType length = static_cast<SizeType>(hi - lo);
+        for (SizeType parent = static_cast<SizeType>(length / 2); parent > 0;) {
+            --parent;
+            __adjust_heap(base, parent, length, ValType(move(*(base + parent))), cmp);
+        }
+        for (SizeType end = static_cast<SizeType>(length - 1); end > 0; --end) {
+            ValType value(move(*(base + end)));
+            *(base + end) = move(*base);
+            __adjust_heap(base, (SizeType) 0, end, move(value), cmp);
+        }
+    }
+
+    /**
+     * Introsort main loop. Sorts @code [lo, hi) @endcode, recursing
+     * on the left partition and looping on the right partition.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     * @param bad_allowed number of unbalanced partitions allowed
+     * before falling back to heap sort
+     * @param leftmost whether the range has no elements to its left
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __intro_sort_loop(
+            RandomAccessIterator first,
+            SizeType lo,
+            SizeType hi,
+            Cmp &cmp,
+            size_t bad_allowed,
+            bool leftmost
+    ) {
+        for (;;) {
+            SizeType size = static_cast<SizeType>(hi - lo);
+            if (size < __sort_insertion_threshold) {
+                if (leftmost) {
+                    __insertion_sort<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+                } else {
+                    __unguarded_insertion_sort<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+                }
+                return;
+            }
+            SizeType half = static_cast<SizeType>(lo + size / 2);
+            if (size > __sort_ninther_threshold) {
+                __sort3(first, lo, half, static_cast<SizeType>(hi - 1), cmp);
+                __sort3(first, static_cast<SizeType>(lo + 1), static_cast<SizeType>(half - 1),
+                        static_cast<SizeType>(hi - 2), cmp);
+                __sort3(first, static_cast<SizeType>(lo + 2), static_cast<SizeType>(half + 1),
+                        static_cast<SizeType>(hi - 3), cmp);
+                __sort3(first, static_cast<SizeType>(half - 1), half, static_cast<SizeType>(half + 1), cmp);
+                __sort_swap(first, lo, half);
+            } else {
+                __sort3(first, half, lo, static_cast<SizeType>(hi - 1), cmp);
+            }
+
+            // a pivot equal to the preceding element is the smallest
+            // value in the range, so group its duplicates and skip them
+            if (!leftmost && !cmp.__lt__(*(first + (lo - 1)), *(first + lo))) {
+                lo = static_cast<SizeType>(
+                        __partition_left<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp) + 1);
+                continue;
+            }
+
+            bool already_partitioned;
+            SizeType pivot = __partition_right<RandomAccessIterator, SizeType, ValType>(
+                    first, lo, hi, cmp, already_partitioned);
+            SizeType left_size = static_cast<SizeType>(pivot - lo);
+            SizeType right_size = static_cast<SizeType>(hi - pivot - 1);
+
+            if (left_size < size / 8 || right_size < size / 8) {
+                if (--bad_allowed == 0) {
+                    __heap_sort_range<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+                    return;
+                }
+                // break up patterns that cause unbalanced partitions
+                if (left_size >= __sort_insertion_threshold) {
+                    __sort_swap(first, lo, static_cast<SizeType>(lo + left_size / 4));
+                    __sort_swap(first, static_cast<SizeType>(pivot - 1),
+                                static_cast<SizeType>(pivot - left_size / 4));
+                }
+                if (right_size >= __sort_insertion_threshold) {
+                    __sort_swap(first, static_cast<SizeType>(pivot + 1),
+                                static_cast<SizeType>(pivot + 1 + right_size / 4));
+                    __sort_swap(first, static_cast<SizeType>(hi - 1),
+                                static_cast<SizeType>(hi - right_size / 4));
+                }
+            } else if (already_partitioned &&
+                       __partial_insertion_sort<RandomAccessIterator, SizeType, ValType>(first, lo, pivot, cmp) &&
+                       __partial_insertion_sort<RandomAccessIterator, SizeType, ValType>(
+                               first, static_cast<SizeType>(pivot + 1), hi, cmp)) {
+                return;
+            }
+
+            __intro_sort_loop<RandomAccessIterator, SizeType, ValType>(first, lo, pivot, cmp, bad_allowed, leftmost);
+            lo = static_cast<SizeType>(pivot + 1);
+            leftmost = false;
+        }
+    }
+
+    /**
+     * Sort the elements in @code [first, last) @endcode using
+     * introspective sort with the supplied comparator. The sort
+     * runs in O(n log n) time in the worst case, is linear on
+     * already sorted input, and is not stable.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType size type acquired from iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param last iterator one past the last element to sort
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, ValType>()
+            >::type
+    >
+    void intro_sort(
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            Cmp cmp
+    ) {
+        SizeType length = static_cast<SizeType>(last - first);
+        if (length < 2) {
+            return;
+        }
+        size_t log2 = 0;
+        for (SizeType n = length; n > 1; n >>= 1) {
+            ++log2;
+        }
+        __intro_sort_loop<RandomAccessIterator, SizeType, ValType>(
+                first, (SizeType) 0, length, cmp, log2, true);
+    }
+
+    /**
+     * Sort the elements in @code [first, last) @endcode using
+     * introspective sort and the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param last iterator one past the last element to sort
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void intro_sort(
+            RandomAccessIterator first,
+            RandomAccessIterator last
+    ) {
+        intro_sort(first, last, comparator<ValType>());
+    }
+
+    /**
+     * Sort an array list using introspective sort.
+     * This function uses the array list elements'
+     * default ordering operations, which may be overloaded.
+     *
+     * @tparam T list element type, inferred from array list
+     * @tparam Growth list growth policy, inferred from array list
+     * @param list array list to sort
+     */
+    template<typename T, typename Growth>
+    void intro_sort(array_list<T, Growth> &list) {
+        intro_sort(list, comparator<T>());
+    }
+
+    /**
+     * Sort an array list using introspective sort.
+     * This function uses a supplied comparator
+     * type for the array list element. The backing
+     * array is sorted directly rather than through
+     * iterators, avoiding their bounds checks.
+     *
+     * @tparam T list element type, inferred from array list
+     * @tparam Growth list growth policy, inferred from array list
+     * @tparam Cmp comparator type
+     * @param list array list to sort
+     * @param cmp comparator to use
+     */
+    template<typename T, typename Growth, typename Cmp>
+    void intro_sort(array_list<T, Growth> &list, Cmp cmp) {
+        typedef typename array_list<T, Growth>::size_type size_type;
+        size_type length = list.size();
+        if (length < 2) {
+            return;
+        }
+        size_t log2 = 0;
+        for (size_type n = length; n > 1; n >>= 1) {
+            ++log2;
+        }
+        __intro_sort_loop<T *, size_type, T>(list.data(), (size_type) 0, length, cmp, log2, true);
+    }
+
+    /**
+     * Place the smallest @code mid - lo @endcode elements of
+     * @code [lo, hi) @endcode in sorted order at the front of the
+     * range. The front is kept as a heap of the smallest elements
+     * seen, whose top is replaced whenever a smaller element is found.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param mid index one past the last element to sort
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __partial_sort(RandomAccessIterator first, SizeType lo, SizeType mid, SizeType hi, Cmp &cmp) {
+        RandomAccessIterator base = first + lo;
+        SizeType length = static_cast<SizeType>(mid - lo);
+        if (length == 0) {
+            return;
+        }
+        for (SizeType parent = static_cast<SizeType>(length / 2); parent > 0;) {
+            --parent;
+            __adjust_heap(base, parent, length, ValType(move(*(base + parent))), cmp);
+        }
+        for (SizeType i = length; i < hi - lo; ++i) {
+            if (cmp.__lt__(*(base + i), *base)) {
+                ValType value(move(*(base + i)));
+                *(base + i) = move(*base);
+                __adjust_heap(base, (SizeType) 0, length, move(value), cmp);
+            }
+        }
+        for (SizeType end = static_cast<SizeType>(length - 1); end > 0; --end) {
+            ValType value(move(*(base + end)));
+            *(base + end) = move(*base);
+            __adjust_heap(base, (SizeType) 0, end, move(value), cmp);
+        }
+    }
+
+    /**
+     * Introselect loop. Partitions @code [lo, hi) @endcode as in
+     * introsort but continues only into the partition that holds
+     * @code nth @endcode, falling back to heap sort of the remaining
+     * range after too many unbalanced partitions.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param nth index of the element to place
+     * @param hi index one past the last element in the range
+     * @param cmp comparator to use
+     * @param bad_allowed number of unbalanced partitions allowed
+     * before falling back to heap sort
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __intro_select_loop(
+            RandomAccessIterator first,
+            SizeType lo,
+            SizeType nth,
+            SizeType hi,
+            Cmp &cmp,
+            size_t bad_allowed
+    ) {
+        bool leftmost = true;
+        for (;;) {
+            SizeType size = static_cast<SizeType>(hi - lo);
+            if (size < __sort_insertion_threshold) {
+                __insertion_sort<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+                return;
+            }
+            SizeType half = static_cast<SizeType>(lo + size / 2);
+            if (size > __sort_ninther_threshold) {
+                __sort3(first, lo, half, static_cast<SizeType>(hi - 1), cmp);
+                __sort3(first, static_cast<SizeType>(lo + 1), static_cast<SizeType>(half - 1),
+                        static_cast<SizeType>(hi - 2), cmp);
+                __sort3(first, static_cast<SizeType>(lo + 2), static_cast<SizeType>(half + 1),
+                        static_cast<SizeType>(hi - 3), cmp);
+                __sort3(first, static_cast<SizeType>(half - 1), half, static_cast<SizeType>(half + 1), cmp);
+                __sort_swap(first, lo, half);
+            } else {
+                __sort3(first, half, lo, static_cast<SizeType>(hi - 1), cmp);
+            }
+
+            // a pivot equal to the preceding element is the smallest
+            // value in the range; its duplicates are already in place
+            if (!leftmost && !cmp.__lt__(*(first + (lo - 1)), *(first + lo))) {
+                SizeType pivot = __partition_left<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+                if (nth <= pivot) {
+                    return;
+                }
+                lo = static_cast<SizeType>(pivot + 1);
+                continue;
+            }
+
+            bool already_partitioned;
+            SizeType pivot = __partition_right<RandomAccessIterator, SizeType, ValType>(
+                    first, lo, hi, cmp, already_partitioned);
+            if (pivot == nth) {
+                return;
+            }
+            SizeType left_size = static_cast<SizeType>(pivot - lo);
+            SizeType right_size = static_cast<SizeType>(hi - pivot - 1);
+            if ((left_size < size / 8 || right_size < size / 8) && --bad_allowed == 0) {
+                __heap_sort_range<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+                return;
+            }
+            if (nth < pivot) {
+                hi = pivot;
+            } else {
+                lo = static_cast<SizeType>(pivot + 1);
+                leftmost = false;
+            }
+        }
+    }
+
+    /**
+     * Rearrange @code [first, last) @endcode so that the elements in
+     * @code [first, middle) @endcode are the smallest of the range in
+     * sorted order. The order of the remaining elements is unspecified.
+     * Runs in O(n log k) time for a sorted prefix of length k.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType size type acquired from iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param middle iterator one past the last element to sort
+     * @param last iterator one past the last element of the range
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, ValType>()
+            >::type
+    >
+    void partial_sort(
+            RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last,
+            Cmp cmp
+    ) {
+        __partial_sort<RandomAccessIterator, SizeType, ValType>(
+                first, (SizeType) 0, static_cast<SizeType>(middle - first),
+                static_cast<SizeType>(last - first), cmp);
+    }
+
+    /**
+     * Rearrange @code [first, last) @endcode so that the elements in
+     * @code [first, middle) @endcode are the smallest of the range in
+     * sorted order, using the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param middle iterator one past the last element to sort
+     * @param last iterator one past the last element of the range
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void partial_sort(
+            RandomAccessIterator first,
+            RandomAccessIterator middle,
+            RandomAccessIterator last
+    ) {
+        partial_sort(first, middle, last, comparator<ValType>());
+    }
+
+    /**
+     * Rearrange @code [first, last) @endcode so that @code nth @endcode
+     * holds the element that would be there if the range were sorted,
+     * no element before it is greater, and no element after it is
+     * less. Runs in linear time on average and O(n log n) time in the
+     * worst case.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType size type acquired from iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param nth iterator to the position to fill
+     * @param last iterator one past the last element of the range
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, ValType>()
+            >::type
+    >
+    void nth_element(
+            RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last,
+            Cmp cmp
+    ) {
+        SizeType length = static_cast<SizeType>(last - first);
+        SizeType index = static_cast<SizeType>(nth - first);
+        if (index >= length) {
+            return;
+        }
+        size_t log2 = 0;
+        for (SizeType n = length; n > 1; n >>= 1) {
+            ++log2;
+        }
+        __intro_select_loop<RandomAccessIterator, SizeType, ValType>(
+                first, (SizeType) 0, index, length, cmp, 2 * log2 + 1);
+    }
+
+    /**
+     * Rearrange @code [first, last) @endcode so that @code nth @endcode
+     * holds the element that would be there if the range were sorted,
+     * using the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param nth iterator to the position to fill
+     * @param last iterator one past the last element of the range
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void nth_element(
+            RandomAccessIterator first,
+            RandomAccessIterator nth,
+            RandomAccessIterator last
+    ) {
+        nth_element(first, nth, last, comparator<ValType>());
+    }
+
+    /**
+     * Reverse the elements in @code [lo, hi) @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     */
+    template<typename RandomAccessIterator, typename SizeType>
+    void __reverse_range(RandomAccessIterator first, SizeType lo, SizeType hi) {
+        while (lo + 1 < hi) {
+            --hi;
+            __sort_swap(first, lo, hi);
+            ++lo;
+        }
+    }
+
+    /**
+     * Merge the sorted ranges @code [lo, mid) @endcode and
+     * @code [mid, hi) @endcode without a buffer, by rotating the
+     * middle sections and recursing.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the left range
+     * @param mid index of the first element in the right range
+     * @param hi index one past the last element in the right range
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename Cmp>
+    void __merge_in_place(RandomAccessIterator first, SizeType lo, SizeType mid, SizeType hi, Cmp &cmp) {
+        if (lo == mid || mid == hi) {
+            return;
+        }
+        if (hi - lo == 2) {
+            __sort2(first, lo, mid, cmp);
+            return;
+        }
+        SizeType cut_left;
+        SizeType cut_right;
+        if (mid - lo > hi - mid) {
+            // lower bound of the left median in the right range
+            cut_left = static_cast<SizeType>(lo + (mid - lo) / 2);
+            SizeType l = mid;
+            SizeType h = hi;
+            while (l < h) {
+                SizeType m = static_cast<SizeType>(l + (h - l) / 2);
+                if (cmp.__lt__(*(first + m), *(first + cut_left))) { l = static_cast<SizeType>(m + 1); }
+                else { h = m; }
+            }
+            cut_right = l;
+        } else {
+            // upper bound of the right median in the left range
+            cut_right = static_cast<SizeType>(mid + (hi - mid) / 2);
+            SizeType l = lo;
+            SizeType h = mid;
+            while (l < h) {
+                SizeType m = static_cast<SizeType>(l + (h - l) / 2);
+                if (cmp.__lt__(*(first + cut_right), *(first + m))) { h = m; }
+                else { l = static_cast<SizeType>(m + 1); }
+            }
+            cut_left = l;
+        }
+        __reverse_range(first, cut_left, mid);
+        __reverse_range(first, mid, cut_right);
+        __reverse_range(first, cut_left, cut_right);
+        SizeType new_mid = static_cast<SizeType>(cut_left + (cut_right - mid));
+        __merge_in_place(first, lo, cut_left, new_mid, cmp);
+        __merge_in_place(first, new_mid, cut_right, hi, cmp);
+    }
+
+    /**
+     * Merge the sorted ranges @code [lo, mid) @endcode and
+     * @code [mid, hi) @endcode by moving the left range into a buffer.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the left range
+     * @param mid index of the first element in the right range
+     * @param hi index one past the last element in the right range
+     * @param buffer buffer with room for the left range
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __merge_buffered(
+            RandomAccessIterator first,
+            SizeType lo,
+            SizeType mid,
+            SizeType hi,
+            ValType *buffer,
+            Cmp &cmp
+    ) {
+        SizeType length = static_cast<SizeType>(mid - lo);
+        for (SizeType i = 0; i < length; ++i) {
+            buffer[i] = move(*(first + (lo + i)));
+        }
+        SizeType i = 0;
+        SizeType j = mid;
+        SizeType k = lo;
+        while (i < length && j < hi) {
+            if (cmp.__lt__(*(first + j), buffer[i])) {
+                *(first + k++) = move(*(first + j++));
+            } else {
+                *(first + k++) = move(buffer[i++]);
+            }
+        }
+        while (i < length) {
+            *(first + k++) = move(buffer[i++]);
+        }
+    }
+
+    /**
+     * Merge sort main loop. Sorts @code [lo, hi) @endcode.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param lo index of the first element in the range
+     * @param hi index one past the last element in the range
+     * @param buffer buffer with room for half the range, or null
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __merge_sort_loop(
+            RandomAccessIterator first,
+            SizeType lo,
+            SizeType hi,
+            ValType *buffer,
+            Cmp &cmp
+    ) {
+        if (hi - lo <= __merge_sort_insertion_threshold) {
+            __insertion_sort<RandomAccessIterator, SizeType, ValType>(first, lo, hi, cmp);
+            return;
+        }
+        SizeType mid = static_cast<SizeType>(lo + (hi - lo) / 2);
+        __merge_sort_loop(first, lo, mid, buffer, cmp);
+        __merge_sort_loop(first, mid, hi, buffer, cmp);
+        if (!cmp.__lt__(*(first + mid), *(first + (mid - 1)))) {
+            return;
+        }
+        if (buffer) {
+            __merge_buffered(first, lo, mid, hi, buffer, cmp);
+        } else {
+            __merge_in_place(first, lo, mid, hi, cmp);
+        }
+    }
+
+    /**
+     * Sort a range with merge sort, allocating a buffer of half
+     * its size. If the buffer cannot be allocated, the merges are
+     * performed in place in O(n log^2 n) time.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam SizeType integer size type
+     * @tparam ValType value type
+     * @tparam Cmp comparator type
+     * @param first iterator to the first element in the structure
+     * @param length the number of elements to sort
+     * @param cmp comparator to use
+     */
+    template<typename RandomAccessIterator, typename SizeType, typename ValType, typename Cmp>
+    void __merge_sort(RandomAccessIterator first, SizeType length, Cmp &cmp) {
+        if (length < 2) {
+            return;
+        }
+        ValType *buffer = nullptr;
+        if (length > __merge_sort_insertion_threshold) {
+            buffer = create<ValType[]>(length / 2);
+        }
+        __merge_sort_loop(first, (SizeType) 0, length, buffer, cmp);
+        if (buffer) {
+            destroy<ValType[]>(buffer);
+        }
+    }
+
+    /**
+     * Sort the elements in @code [first, last) @endcode using a
+     * stable merge sort with the supplied comparator. Equal elements
+     * keep their relative order. Requires a temporary buffer of half
+     * the range.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam Cmp comparator type
+     * @tparam SizeType size type acquired from iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param last iterator one past the last element to sort
+     * @param cmp comparator to use
+     */
+    template<
+            typename RandomAccessIterator,
+            typename Cmp,
+            typename SizeType = typename obtain_size_type<RandomAccessIterator>::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>() &&
+                    is_comparator<Cmp, ValType>()
+            >::type
+    >
+    void merge_sort(
+            RandomAccessIterator first,
+            RandomAccessIterator last,
+            Cmp cmp
+    ) {
+        __merge_sort<RandomAccessIterator, SizeType, ValType>(first, static_cast<SizeType>(last - first), cmp);
+    }
+
+    /**
+     * Sort the elements in @code [first, last) @endcode using a
+     * stable merge sort and the elements' default ordering.
+     *
+     * @tparam RandomAccessIterator random access iterator type
+     * @tparam ValType value type acquired from iterator type
+     * @param first iterator to first element in random access structure
+     * @param last iterator one past the last element to sort
+     */
+    template<
+            typename RandomAccessIterator,
+            typename = typename enable_if<
+                    is_random_access_iterator<RandomAccessIterator>()
+            >::type,
+            typename ValType = typename obtain_val_type<RandomAccessIterator>::type
+    >
+    void merge_sort(
+            RandomAccessIterator first,
+            RandomAccessIterator last
+    ) {
+        merge_sort(first, last, comparator<ValType>());
+    }
+
+    /**
+     * Stable sort an array list using merge sort.
+     *
+     * @tparam T list element type, inferred from array list
+     * @tparam Growth list growth policy, inferred from array list
+     * @tparam Cmp comparator type
+     * @param list array list to sort
+     * @param cmp comparator to use
+     */
+    template<typename T, typename Growth, typename Cmp>
+    void merge_sort(array_list<T, Growth> &list, Cmp cmp) {
+        typedef typename array_list<T, Growth>::size_type size_type;
+        __merge_sort<T *, size_type, T>(list.data(), list.size(), cmp);
+    }
+
+    /**
+     * Stable sort an array list using merge sort and the
+     * elements' default ordering.
+     *
+     * @tparam T list element type, inferred from array list
+     * @tparam Growth list growth policy, inferred from array list
+     * @param list array list to sort
+     */
+    template<typename T, typename Growth>
+    void merge_sort(array_list<T, Growth> &list) {
+        merge_sort(list, comparator<T>());
+    }
+
+    /**
+     * Stable sort a linked list by relinking its nodes.
+     *
+     * @see linked_list<T>::sort()
+     * @tparam T list element type, inferred from linked list
+     * @tparam Cmp comparator type
+     * @param list linked list to sort
+     * @param cmp comparator to use
+     */
+    template<typename T, typename Cmp>
+    void merge_sort(linked_list<T> &list, Cmp cmp) {
+        list.sort(cmp);
+    }
+
+    /**
+     * Stable sort a linked list by relinking its nodes.
+     *
+     * @tparam T list element type, inferred from linked list
+     * @param list linked list to sort
+     */
+    template<typename T>
+    void merge_sort(linked_list<T> &list) {
+        list.sort();
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SORT_H
@@ -0,0 +1,93 @@
+/**
+ * @file SpinLock.h
+ * @brief Lock policies for containers shared between threads.
+ *
+ * A lock policy is a type with @code lock @endcode,
+ * @code try_lock @endcode and @code unlock @endcode members.
+ * The spin lock busy-waits on an atomic flag using the compiler
+ * atomic builtins, so it needs no operating system support; the
+ * null lock does nothing and lets a concurrent container be used
+ * from a single thread without paying for synchronization.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_SPINLOCK_H
+#define EMBEDDEDCPLUSPLUS_SPINLOCK_H
+
+namespace wlp {
+
+    /**
+     * Test-and-test-and-set spin lock. Waiting threads spin on a
+     * plain load of the flag and only attempt the atomic exchange
+     * once the flag reads clear, which keeps the cache line shared
+     * while the lock is held.
+     */
+    class spin_lock {
+        /**
+         * Whether the lock is held.
+         */
+        bool m_locked;
+
+    public:
+        spin_lock()
+                : m_locked(false) {
+        }
+
+        /**
+         * Disable copy construction.
+         */
+        spin_lock(const spin_lock &) = delete;
+
+        /**
+         * Attempt to acquire the lock without waiting.
+         *
+         * @return true if the lock was acquired
+         */
+        bool try_lock() {
+            return !__atomic_test_and_set(&m_locked, __ATOMIC_ACQUIRE);
+        }
+
+        /**
+         * Acquire the lock, spinning until it is released.
+         */
+        void lock() {
+            while (!try_lock()) {
+                while (__atomic_load_n(&m_locked, __ATOMIC_RELAXED)) {
+                }
+            }
+        }
+
+        /**
+         * Release the lock.
+         */
+        void unlock() {
+            __atomic_clear(&m_locked, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this lock
+         */
+        spin_lock &operator=(const spin_lock &) = delete;
+    };
+
+    /**
+     * Lock policy that performs no synchronization.
+     */
+    struct null_lock {
+        bool try_lock() {
+            return true;
+        }
+
+        void lock() {
+        }
+
+        void unlock() {
+        }
+    };
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_SPINLOCK_H
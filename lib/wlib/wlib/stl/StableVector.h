@@ -0,0 +1,808 @@
+/**
+ * @file StableVector.h
+ * @brief Segmented array with stable element storage.
+ *
+ * A stable vector stores its elements in fixed-size chunks that
+ * are reached through a directory of chunk pointers. Growing the
+ * container allocates new chunks and at most reallocates the
+ * directory, so elements are never relocated and pointers to them
+ * remain valid as the container grows. Random access is constant
+ * time: an index is split into a chunk number and an offset.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_STABLEVECTOR_H
+#define EMBEDDEDCPLUSPLUS_STABLEVECTOR_H
+
+#include <stddef.h>
+
+#include <wlib/memory>
+#include <wlib/utility>
+
+namespace wlp {
+
+    /**
+     * @param n a power of two
+     * @return the base two logarithm of the number
+     */
+    constexpr size_t __chunk_shift(size_t n) {
+        return n <= 1 ? 0 : 1 + __chunk_shift(n >> 1);
+    }
+
+    // Forward declaration of stable vector
+    template<typename T, size_t ChunkSize>
+    class stable_vector;
+
+    /**
+     * Stable vector random access iterator type.
+     *
+     * @tparam T element type
+     * @tparam Ref reference type, which may be const
+     * @tparam Ptr pointer type, which may be const
+     * @tparam ChunkSize number of elements per chunk
+     */
+    template<typename T, typename Ref, typename Ptr, size_t ChunkSize>
+    class StableVectorIterator {
+    public:
+        typedef size_t size_type;
+        typedef ptrdiff_t diff_type;
+        typedef T val_type;
+        typedef Ref reference;
+        typedef Ptr pointer;
+        typedef stable_vector<T, ChunkSize> vector_type;
+        typedef StableVectorIterator<T, Ref, Ptr, ChunkSize> self_type;
+
+    private:
+        /**
+         * Pointer to the iterated stable vector.
+         */
+        const vector_type *m_vector;
+        /**
+         * The element index pointed to by this iterator.
+         */
+        size_type m_i;
+
+        friend class stable_vector<T, ChunkSize>;
+
+    public:
+        /**
+         * An empty stable vector iterator is invalid.
+         */
+        StableVectorIterator()
+                : m_vector(nullptr),
+                  m_i(static_cast<size_type>(-1)) {}
+
+        /**
+         * Copy constructor.
+         *
+         * @param it iterator to copy
+         */
+        StableVectorIterator(const self_type &it)
+                : m_vector(it.m_vector),
+                  m_i(it.m_i) {}
+
+        /**
+         * Constructor from an index and a backing stable vector.
+         * Indices past the end become pass-the-end.
+         *
+         * @param i element index
+         * @param vector backing stable vector
+         */
+        explicit StableVectorIterator(const size_type &i, const vector_type *vector)
+                : m_vector(vector),
+                  m_i(i) {
+            if (m_i > m_vector->m_size) {
+                m_i = m_vector->m_size;
+            }
+        }
+
+        /**
+         * @return a reference to the value pointed to
+         * by this iterator
+         */
+        reference operator*() const {
+            return m_vector->element(m_i);
+        }
+
+        /**
+         * @return a pointer to the value pointed to
+         * by this iterator
+         */
+        pointer operator->() const {
+            return &(operator*());
+        }
+
+        /**
+         * Move to the next element, or stay at pass-the-end.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator++() {
+            if (m_i < m_vector->m_size) {
+                ++m_i;
+            }
+            return *this;
+        }
+
+        /**
+         * @return copy of this iterator before increment
+         */
+        self_type operator++(int) {
+            self_type tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /**
+         * Move to the previous element, or stay at the first.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator--() {
+            if (m_i > 0) {
+                --m_i;
+            }
+            return *this;
+        }
+
+        /**
+         * @return copy of this iterator before decrement
+         */
+        self_type operator--(int) {
+            self_type tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        /**
+         * @param d the number of positions to increment
+         * @return reference to this iterator
+         */
+        self_type &operator+=(const size_type &d) {
+            m_i = m_i + d > m_vector->m_size ? m_vector->m_size : m_i + d;
+            return *this;
+        }
+
+        /**
+         * @param d the number of positions to decrement
+         * @return reference to this iterator
+         */
+        self_type &operator-=(const size_type &d) {
+            m_i = d >= m_i ? 0 : m_i - d;
+            return *this;
+        }
+
+        /**
+         * @param it iterator to compare
+         * @return true if they point to the same element
+         */
+        bool operator==(const self_type &it) const {
+            return m_i == it.m_i;
+        }
+
+        /**
+         * @param it iterator to compare
+         * @return true if they point to different elements
+         */
+        bool operator!=(const self_type &it) const {
+            return m_i != it.m_i;
+        }
+
+        /**
+         * @param it iterator to copy
+         * @return reference to this iterator
+         */
+        self_type &operator=(const self_type &it) {
+            m_i = it.m_i;
+            m_vector = it.m_vector;
+            return *this;
+        }
+
+        /**
+         * @param d number of positions to increment
+         * @return a new iterator
+         */
+        self_type operator+(const size_type &d) const {
+            return self_type(m_i + d, m_vector);
+        }
+
+        /**
+         * @param d number of positions to decrement
+         * @return a new iterator
+         */
+        self_type operator-(const size_type &d) const {
+            return self_type(m_i - d, m_vector);
+        }
+
+        /**
+         * @param it iterator to subtract
+         * @return the integer distance between the iterators
+         */
+        diff_type operator-(const self_type &it) const {
+            return static_cast<diff_type>(m_i - it.m_i);
+        }
+    };
+
+    /**
+     * Segmented array container with the interface of
+     * @code array_list @endcode. Elements live in chunks of
+     * @code ChunkSize @endcode elements that are never moved or
+     * freed while in use, so a pointer to an element stays valid
+     * across @code push_back @endcode, @code reserve @endcode, and
+     * any other growth. Inserting or erasing in the middle still
+     * shifts values between slots, as in @code array_list @endcode.
+     *
+     * @tparam T element type
+     * @tparam ChunkSize number of elements per chunk, a power of two
+     */
+    template<typename T, size_t ChunkSize = 16>
+    class stable_vector {
+        static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+                      "Chunk size must be a power of two");
+
+    public:
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef stable_vector<T, ChunkSize> vector_type;
+        typedef StableVectorIterator<T, T &, T *, ChunkSize> iterator;
+        typedef StableVectorIterator<T, const T &, const T *, ChunkSize> const_iterator;
+
+        static constexpr size_type chunk_size = ChunkSize;
+
+    private:
+        static constexpr size_type chunk_shift = __chunk_shift(ChunkSize);
+        static constexpr size_type chunk_mask = ChunkSize - 1;
+
+        /**
+         * Directory of chunk pointers.
+         */
+        val_type **m_chunks;
+        /**
+         * The number of allocated chunks.
+         */
+        size_type m_num_chunks;
+        /**
+         * The number of slots in the chunk directory.
+         */
+        size_type m_directory_size;
+        /**
+         * The current number of elements.
+         */
+        size_type m_size;
+
+        friend class StableVectorIterator<T, T &, T *, ChunkSize>;
+
+        friend class StableVectorIterator<T, const T &, const T *, ChunkSize>;
+
+    public:
+        /**
+         * Constructor with an initial capacity, which is
+         * rounded up to a whole number of chunks.
+         *
+         * @param initial_capacity the number of elements to reserve
+         */
+        explicit stable_vector(size_type initial_capacity = ChunkSize)
+                : m_chunks(nullptr),
+                  m_num_chunks(0),
+                  m_directory_size(0),
+                  m_size(0) {
+            reserve(initial_capacity);
+        }
+
+        /**
+         * Disable copy constructor.
+         */
+        stable_vector(const vector_type &) = delete;
+
+        /**
+         * Move constructor. Pointers to elements of the
+         * moved vector remain valid.
+         *
+         * @param vector stable vector whose resources to transfer
+         */
+        stable_vector(vector_type &&vector)
+                : m_chunks(vector.m_chunks),
+                  m_num_chunks(vector.m_num_chunks),
+                  m_directory_size(vector.m_directory_size),
+                  m_size(vector.m_size) {
+            vector.m_chunks = nullptr;
+            vector.m_num_chunks = 0;
+            vector.m_directory_size = 0;
+            vector.m_size = 0;
+        }
+
+        /**
+         * Free all chunks and the directory.
+         */
+        ~stable_vector() {
+            release();
+        }
+
+    private:
+        /**
+         * @param i element index
+         * @return reference to the element slot
+         */
+        val_type &element(size_type i) const {
+            return m_chunks[i >> chunk_shift][i & chunk_mask];
+        }
+
+        /**
+         * Free all chunks and the directory.
+         */
+        void release();
+
+        /**
+         * Ensure the directory has room for the given number of chunks.
+         * Only the chunk pointers are copied when it grows.
+         *
+         * @param num_chunks the number of directory slots needed
+         * @return false if the allocation failed
+         */
+        bool ensure_directory(size_type num_chunks);
+
+        /**
+         * Allocate a chunk if the vector is full.
+         *
+         * @return false if the allocation failed
+         */
+        bool ensure_capacity();
+
+        /**
+         * Normalize an index such that it is within
+         * the range @code [0, length) @endcode.
+         *
+         * @param i integer to normalize
+         */
+        void normalize(size_type &i) const {
+            if (m_size == 0) {
+                i = 0;
+                return;
+            }
+            i %= m_size;
+        }
+
+        /**
+         * Shift the elements at and after position @code i @endcode
+         * one slot to the right.
+         *
+         * @param i the shift begin position
+         */
+        void shift_right(size_type i);
+
+        /**
+         * Shift the elements after position @code i @endcode one
+         * slot to the left, overwriting the element at @code i @endcode.
+         *
+         * @param i the shift begin position
+         */
+        void shift_left(size_type i);
+
+    public:
+        /**
+         * @return whether the vector is empty
+         */
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * @return the current number of elements
+         */
+        size_type size() const {
+            return m_size;
+        }
+
+        /**
+         * @return the number of elements storable without allocating
+         */
+        size_type capacity() const {
+            return m_num_chunks << chunk_shift;
+        }
+
+        /**
+         * Allocate chunks such that the capacity is at least the
+         * requested amount. Existing elements are not moved.
+         *
+         * @param new_capacity the number of elements to reserve
+         * @return false if an allocation failed
+         */
+        bool reserve(size_type new_capacity);
+
+        /**
+         * Free the chunks that hold no elements.
+         */
+        void shrink();
+
+        /**
+         * Get the element at position @code i @endcode.
+         *
+         * @param i the index of the element to get
+         * @return reference to the element
+         */
+        val_type &at(size_type i) {
+            normalize(i);
+            return element(i);
+        }
+
+        /**
+         * Get the element at position @code i @endcode.
+         *
+         * @param i the index of the element to get
+         * @return reference to the element
+         */
+        const val_type &at(size_type i) const {
+            normalize(i);
+            return element(i);
+        }
+
+        /**
+         * Access operator without bounds checking.
+         *
+         * @param i position to access
+         * @return reference to the element there
+         */
+        val_type &operator[](size_type i) {
+            return element(i);
+        }
+
+        /**
+         * Access operator without bounds checking.
+         *
+         * @param i position to access
+         * @return reference to the element there
+         */
+        const val_type &operator[](size_type i) const {
+            return element(i);
+        }
+
+        /**
+         * @pre the vector has capacity
+         * @return reference to the first element
+         */
+        val_type &front() {
+            return element(0);
+        }
+
+        /**
+         * @pre the vector has capacity
+         * @return reference to the first element
+         */
+        const val_type &front() const {
+            return element(0);
+        }
+
+        /**
+         * @pre the vector has capacity
+         * @return reference to the last element
+         */
+        val_type &back() {
+            return element(m_size == 0 ? 0 : m_size - 1);
+        }
+
+        /**
+         * @pre the vector has capacity
+         * @return reference to the last element
+         */
+        const val_type &back() const {
+            return element(m_size == 0 ? 0 : m_size - 1);
+        }
+
+        /**
+         * Clear the contents of the vector such that it is empty.
+         * The chunks are kept for reuse.
+         */
+        void clear() noexcept {
+            m_size = 0;
+        }
+
+        /**
+         * @return iterator to the first element
+         */
+        iterator begin() {
+            return iterator(0, this);
+        }
+
+        /**
+         * @return iterator to the first element
+         */
+        const_iterator begin() const {
+            return const_iterator(0, this);
+        }
+
+        /**
+         * @return pass-the-end iterator
+         */
+        iterator end() {
+            return iterator(m_size, this);
+        }
+
+        /**
+         * @return pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(m_size, this);
+        }
+
+        /**
+         * Insert an element at the specified position such that
+         * the elements at and after it are shifted to the right.
+         *
+         * @param i position to insert
+         * @param val element to insert
+         * @return iterator to the inserted element, or pass-the-end
+         * if allocation failed
+         */
+        template<typename V>
+        iterator insert(size_type i, V &&val) {
+            if (!ensure_capacity()) {
+                return end();
+            }
+            normalize(i);
+            shift_right(i);
+            element(i) = forward<V>(val);
+            ++m_size;
+            return iterator(i, this);
+        }
+
+        /**
+         * Insert an element at the position pointed to by the iterator.
+         *
+         * @param it iterator to the inserted position
+         * @param val element to insert
+         * @return iterator to the inserted element, or pass-the-end
+         * if allocation failed
+         */
+        template<typename V>
+        iterator insert(const iterator &it, V &&val) {
+            if (it.m_i > m_size || !ensure_capacity()) {
+                return end();
+            }
+            shift_right(it.m_i);
+            element(it.m_i) = forward<V>(val);
+            ++m_size;
+            return it;
+        }
+
+        /**
+         * Remove the element at the specified position.
+         *
+         * @param i position whose element to erase
+         * @return iterator to the next element
+         */
+        iterator erase(size_type i) {
+            if (m_size == 0) {
+                return end();
+            }
+            normalize(i);
+            shift_left(i);
+            --m_size;
+            return iterator(i, this);
+        }
+
+        /**
+         * Remove the element at the specified position.
+         *
+         * @param it position whose element to erase
+         * @return iterator to the next element
+         */
+        iterator erase(const iterator &it) {
+            if (m_size == 0 || it.m_i >= m_size) {
+                return end();
+            }
+            shift_left(it.m_i);
+            --m_size;
+            return it;
+        }
+
+        /**
+         * Insert an element at the back. Existing
+         * elements are never moved.
+         *
+         * @param val element to insert
+         * @return false if allocation failed
+         */
+        template<typename V>
+        bool push_back(V &&val) {
+            if (!ensure_capacity()) {
+                return false;
+            }
+            element(m_size) = forward<V>(val);
+            ++m_size;
+            return true;
+        }
+
+        /**
+         * Insert an element at the front.
+         *
+         * @param val element to insert
+         * @return false if allocation failed
+         */
+        template<typename V>
+        bool push_front(V &&val) {
+            if (!ensure_capacity()) {
+                return false;
+            }
+            shift_right(0);
+            element(0) = forward<V>(val);
+            ++m_size;
+            return true;
+        }
+
+        /**
+         * Remove the last element.
+         */
+        void pop_back() {
+            if (m_size > 0) {
+                --m_size;
+            }
+        }
+
+        /**
+         * Remove the first element.
+         */
+        void pop_front() {
+            if (m_size > 0) {
+                shift_left(0);
+                --m_size;
+            }
+        }
+
+        /**
+         * @param val the value to find
+         * @return the index of the value, or the size of the vector
+         * if the value is not found
+         */
+        size_type index_of(const val_type &val) const {
+            for (size_type i = 0; i < m_size; ++i) {
+                if (val == element(i)) { return i; }
+            }
+            return m_size;
+        }
+
+        /**
+         * @param val the value to count
+         * @return the number of elements equal to the value
+         */
+        size_type count(const val_type &val) const {
+            size_type c = 0;
+            for (size_type i = 0; i < m_size; ++i) {
+                if (val == element(i)) { ++c; }
+            }
+            return c;
+        }
+
+        /**
+         * @param val the value to find
+         * @return iterator to the value, or pass-the-end if not found
+         */
+        iterator find(const val_type &val) {
+            return iterator(index_of(val), this);
+        }
+
+        /**
+         * @param val the value to find
+         * @return iterator to the value, or pass-the-end if not found
+         */
+        const_iterator find(const val_type &val) const {
+            return const_iterator(index_of(val), this);
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this vector
+         */
+        vector_type &operator=(const vector_type &) = delete;
+
+        /**
+         * Move assignment operator.
+         *
+         * @param vector stable vector to transfer
+         * @return reference to this vector
+         */
+        vector_type &operator=(vector_type &&vector) {
+            release();
+            m_chunks = vector.m_chunks;
+            m_num_chunks = vector.m_num_chunks;
+            m_directory_size = vector.m_directory_size;
+            m_size = vector.m_size;
+            vector.m_chunks = nullptr;
+            vector.m_num_chunks = 0;
+            vector.m_directory_size = 0;
+            vector.m_size = 0;
+            return *this;
+        }
+    };
+
+    template<typename T, size_t ChunkSize>
+    constexpr typename stable_vector<T, ChunkSize>::size_type stable_vector<T, ChunkSize>::chunk_size;
+
+    template<typename T, size_t ChunkSize>
+    void stable_vector<T, ChunkSize>::release() {
+        for (size_type c = 0; c < m_num_chunks; ++c) {
+            destroy<val_type[]>(m_chunks[c]);
+        }
+        if (m_chunks) {
+            destroy<val_type *[]>(m_chunks);
+        }
+        m_chunks = nullptr;
+        m_num_chunks = 0;
+        m_directory_size = 0;
+        m_size = 0;
+    }
+
+    template<typename T, size_t ChunkSize>
+    bool stable_vector<T, ChunkSize>::ensure_directory(size_type num_chunks) {
+        if (num_chunks <= m_directory_size) {
+            return true;
+        }
+        size_type new_size = m_directory_size < 4 ? 4 : m_directory_size * 2;
+        if (new_size < num_chunks) {
+            new_size = num_chunks;
+        }
+        val_type **chunks = create<val_type *[]>(new_size);
+        if (!chunks) {
+            return false;
+        }
+        for (size_type c = 0; c < m_num_chunks; ++c) {
+            chunks[c] = m_chunks[c];
+        }
+        if (m_chunks) {
+            destroy<val_type *[]>(m_chunks);
+        }
+        m_chunks = chunks;
+        m_directory_size = new_size;
+        return true;
+    }
+
+    template<typename T, size_t ChunkSize>
+    bool stable_vector<T, ChunkSize>::reserve(size_type new_capacity) {
+        size_type num_chunks = (new_capacity + chunk_mask) >> chunk_shift;
+        if (!ensure_directory(num_chunks)) {
+            return false;
+        }
+        while (m_num_chunks < num_chunks) {
+            val_type *chunk = create<val_type[]>(ChunkSize);
+            if (!chunk) {
+                return false;
+            }
+            m_chunks[m_num_chunks++] = chunk;
+        }
+        return true;
+    }
+
+    template<typename T, size_t ChunkSize>
+    inline bool stable_vector<T, ChunkSize>::ensure_capacity() {
+        if (m_size < capacity()) {
+            return true;
+        }
+        return reserve(m_size + 1);
+    }
+
+    template<typename T, size_t ChunkSize>
+    void stable_vector<T, ChunkSize>::shrink() {
+        size_type used = (m_size + chunk_mask) >> chunk_shift;
+        while (m_num_chunks > used) {
+            destroy<val_type[]>(m_chunks[--m_num_chunks]);
+        }
+    }
+
+    template<typename T, size_t ChunkSize>
+    void stable_vector<T, ChunkSize>::shift_right(size_type i) {
+        for (size_type j = m_size; j > i; --j) {
+            element(j) = move(element(j - 1));
+        }
+    }
+
+    template<typename T, size_t ChunkSize>
+    void stable_vector<T, ChunkSize>::shift_left(size_type i) {
+        for (size_type j = i; j + 1 < m_size; ++j) {
+            element(j) = move(element(j + 1));
+        }
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_STABLEVECTOR_H
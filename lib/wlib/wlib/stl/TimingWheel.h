@@ -0,0 +1,415 @@
+/**
+ * @file TimingWheel.h
+ * @brief Hierarchical timing wheel of intrusive timers.
+ *
+ * A timing wheel files each timer into a slot by its expiry tick,
+ * so that scheduling and cancelling a timer is a constant time
+ * link or unlink. The wheel has several levels of slots, each
+ * covering a range of ticks as wide as the whole level below it.
+ * Timers far in the future sit in a coarse slot and are moved
+ * down a level when the wheel reaches that slot, which happens
+ * at most once per level for every timer. Timers embed a
+ * @code timer_hook @endcode and the wheel never allocates.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_TIMINGWHEEL_H
+#define EMBEDDEDCPLUSPLUS_TIMINGWHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <wlib/stl/IntrusiveList.h>
+
+namespace wlp {
+
+    /**
+     * Timer member embedded in objects scheduled on a timing
+     * wheel. A hook may be scheduled on at most one wheel.
+     */
+    struct timer_hook {
+        /**
+         * Link in the slot list of the wheel.
+         */
+        intrusive_list_hook m_link;
+        /**
+         * The tick at which the timer expires.
+         */
+        uint64_t m_expiry = 0;
+
+        /**
+         * @return true if the timer is scheduled
+         */
+        bool is_scheduled() const {
+            return m_link.is_linked();
+        }
+
+        /**
+         * @return the tick at which the timer expires
+         */
+        uint64_t expiry() const {
+            return m_expiry;
+        }
+    };
+
+    /**
+     * Hierarchical timing wheel over objects that embed a
+     * @code timer_hook @endcode. Time is measured in abstract
+     * ticks and moves forward with @code advance @endcode, which
+     * hands expired timers to a callback. Timers further away
+     * than the span of every level wait in an overflow list that
+     * is re-examined each time the top level wraps around.
+     *
+     * @tparam T        object type
+     * @tparam Hook     pointer to the timer hook member of the object
+     * @tparam Levels   number of wheel levels
+     * @tparam SlotBits log base two of the number of slots per level
+     */
+    template<typename T, timer_hook T::*Hook, size_t Levels = 4, size_t SlotBits = 6>
+    class timing_wheel {
+        static_assert(Levels > 0, "Timing wheel must have a level");
+        static_assert(SlotBits > 0 && Levels * SlotBits < 64, "Timing wheel span must fit in a tick");
+
+    public:
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef uint64_t tick_type;
+        typedef intrusive_list_hook link_type;
+        typedef timing_wheel<T, Hook, Levels, SlotBits> wheel_type;
+
+        static constexpr size_type levels = Levels;
+        static constexpr size_type slots = static_cast<size_type>(1) << SlotBits;
+
+    private:
+        static constexpr tick_type slot_mask = static_cast<tick_type>(slots - 1);
+
+        /**
+         * Slot list sentinels of every level.
+         */
+        link_type m_slots[Levels][slots];
+        /**
+         * Timers beyond the span of the top level.
+         */
+        link_type m_overflow;
+        /**
+         * Expired timers not yet handed to the callback.
+         */
+        link_type m_due;
+        /**
+         * The last processed tick.
+         */
+        tick_type m_now;
+        /**
+         * The number of scheduled timers, including due timers.
+         */
+        size_type m_size;
+
+        /**
+         * @param link slot link of a timer
+         * @return the object that owns the link
+         */
+        static T *owner_of(link_type *link) {
+            timer_hook *hook = __intrusive_owner<timer_hook, link_type, &timer_hook::m_link>(link);
+            return __intrusive_owner<T, timer_hook, Hook>(hook);
+        }
+
+        /**
+         * Reset a sentinel to an empty list.
+         *
+         * @param head list sentinel
+         */
+        static void reset(link_type *head) {
+            head->m_next = head;
+            head->m_prev = head;
+        }
+
+        /**
+         * Link a timer at the back of a list.
+         *
+         * @param head list sentinel
+         * @param link timer link
+         */
+        static void link_back(link_type *head, link_type *link) {
+            link->m_next = head;
+            link->m_prev = head->m_prev;
+            head->m_prev->m_next = link;
+            head->m_prev = link;
+        }
+
+        /**
+         * Unlink a timer from its list and reset its links.
+         *
+         * @param link timer link
+         */
+        static void unlink(link_type *link) {
+            link->m_prev->m_next = link->m_next;
+            link->m_next->m_prev = link->m_prev;
+            link->m_next = nullptr;
+            link->m_prev = nullptr;
+        }
+
+        /**
+         * File a timer into the slot for its expiry. The level is
+         * chosen by the distance from the base tick, and the slot
+         * by the expiry bits of that level, so the slot is reached
+         * no later than the expiry.
+         *
+         * @param hook timer hook, expiring no earlier than the base
+         * @param base the tick from which to measure
+         */
+        void place(timer_hook *hook, tick_type base) {
+            tick_type delta = hook->m_expiry - base;
+            for (size_type level = 0; level < Levels; ++level) {
+                if (delta < (static_cast<tick_type>(1) << ((level + 1) * SlotBits))) {
+                    size_type slot = static_cast<size_type>((hook->m_expiry >> (level * SlotBits)) & slot_mask);
+                    link_back(&m_slots[level][slot], &hook->m_link);
+                    return;
+                }
+            }
+            link_back(&m_overflow, &hook->m_link);
+        }
+
+        /**
+         * Refile every timer in a list relative to the current tick.
+         *
+         * @param head list sentinel
+         */
+        void cascade(link_type *head) {
+            link_type *link = head->m_next;
+            reset(head);
+            while (link != head) {
+                link_type *next = link->m_next;
+                place(__intrusive_owner<timer_hook, link_type, &timer_hook::m_link>(link), m_now);
+                link = next;
+            }
+        }
+
+        /**
+         * Process the current tick: move the coarse slots that
+         * the tick enters down a level, then move the timers of
+         * the current bottom slot to the due list.
+         */
+        void tick() {
+            for (size_type level = 1; level <= Levels; ++level) {
+                tick_type low = (static_cast<tick_type>(1) << (level * SlotBits)) - 1;
+                if (m_now & low) {
+                    break;
+                }
+                if (level == Levels) {
+                    cascade(&m_overflow);
+                } else {
+                    cascade(&m_slots[level][(m_now >> (level * SlotBits)) & slot_mask]);
+                }
+            }
+            link_type *head = &m_slots[0][m_now & slot_mask];
+            if (head->m_next == head) {
+                return;
+            }
+            head->m_next->m_prev = m_due.m_prev;
+            m_due.m_prev->m_next = head->m_next;
+            head->m_prev->m_next = &m_due;
+            m_due.m_prev = head->m_prev;
+            reset(head);
+        }
+
+        /**
+         * Hand due timers to a callback.
+         *
+         * @param callback function called with each expired object
+         * @param limit    maximum number of timers to expire
+         * @return the number of expired timers
+         */
+        template<typename Callback>
+        size_type drain(Callback &callback, size_type limit) {
+            size_type expired = 0;
+            while (expired < limit && m_due.m_next != &m_due) {
+                link_type *link = m_due.m_next;
+                unlink(link);
+                --m_size;
+                ++expired;
+                callback(*owner_of(link));
+            }
+            return expired;
+        }
+
+        /**
+         * Reset the links of every timer in a list.
+         *
+         * @param head list sentinel
+         */
+        static void release(link_type *head) {
+            link_type *link = head->m_next;
+            while (link != head) {
+                link_type *next = link->m_next;
+                link->m_next = nullptr;
+                link->m_prev = nullptr;
+                link = next;
+            }
+            reset(head);
+        }
+
+    public:
+        /**
+         * Create an empty wheel.
+         *
+         * @param now the current tick
+         */
+        explicit timing_wheel(tick_type now = 0)
+                : m_now(now),
+                  m_size(0) {
+            for (size_type level = 0; level < Levels; ++level) {
+                for (size_type slot = 0; slot < slots; ++slot) {
+                    reset(&m_slots[level][slot]);
+                }
+            }
+            reset(&m_overflow);
+            reset(&m_due);
+        }
+
+        /**
+         * Disable copy construction. The slot sentinels are linked
+         * to the timers, so the wheel may not be moved either.
+         */
+        timing_wheel(const wheel_type &) = delete;
+
+        /**
+         * Unschedule every timer.
+         */
+        ~timing_wheel() {
+            clear();
+        }
+
+        /**
+         * @return the last processed tick
+         */
+        tick_type now() const {
+            return m_now;
+        }
+
+        /**
+         * @return the number of scheduled timers
+         */
+        size_type size() const {
+            return m_size;
+        }
+
+        /**
+         * @return true if no timers are scheduled
+         */
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * Schedule a timer to expire at a tick. A scheduled timer
+         * is rescheduled. Expiries that are not in the future
+         * expire on the next tick.
+         *
+         * @param t      object to schedule
+         * @param expiry the tick at which to expire
+         */
+        void schedule(T &t, tick_type expiry) {
+            timer_hook *hook = &(t.*Hook);
+            if (hook->is_scheduled()) {
+                unlink(&hook->m_link);
+            } else {
+                ++m_size;
+            }
+            hook->m_expiry = expiry > m_now ? expiry : m_now + 1;
+            place(hook, m_now);
+        }
+
+        /**
+         * Schedule a timer to expire a number of ticks from now.
+         *
+         * @param t     object to schedule
+         * @param delay number of ticks until expiry
+         */
+        void schedule_after(T &t, tick_type delay) {
+            schedule(t, m_now + delay);
+        }
+
+        /**
+         * Cancel a timer.
+         *
+         * @param t object to cancel
+         * @return false if the timer was not scheduled
+         */
+        bool cancel(T &t) {
+            timer_hook *hook = &(t.*Hook);
+            if (!hook->is_scheduled()) {
+                return false;
+            }
+            unlink(&hook->m_link);
+            --m_size;
+            return true;
+        }
+
+        /**
+         * Move the wheel forward to a tick, calling the callback
+         * with every timer that expires, in order of expiry. A
+         * timer is unscheduled before its callback runs, so the
+         * callback may schedule it again. At most @code limit @endcode
+         * timers expire per call; when the limit is reached the
+         * wheel stops at the tick of the last expired timer and the
+         * rest expire on the next call.
+         *
+         * @tparam Callback callable taking a reference to the object
+         * @param now      the tick to advance to
+         * @param callback function called with each expired object
+         * @param limit    maximum number of timers to expire
+         * @return the number of expired timers
+         */
+        template<typename Callback>
+        size_type advance(tick_type now, Callback callback, size_type limit = static_cast<size_type>(-1)) {
+            size_type expired = drain(callback, limit);
+            while (m_now < now && expired < limit) {
+                if (m_size == 0) {
+                    m_now = now;
+                    break;
+                }
+                ++m_now;
+                tick();
+                expired += drain(callback, limit - expired);
+            }
+            return expired;
+        }
+
+        /**
+         * Unschedule every timer without calling back.
+         */
+        void clear() {
+            for (size_type level = 0; level < Levels; ++level) {
+                for (size_type slot = 0; slot < slots; ++slot) {
+                    release(&m_slots[level][slot]);
+                }
+            }
+            release(&m_overflow);
+            release(&m_due);
+            m_size = 0;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this wheel
+         */
+        wheel_type &operator=(const wheel_type &) = delete;
+    };
+
+    template<typename T, timer_hook T::*Hook, size_t Levels, size_t SlotBits>
+    constexpr typename timing_wheel<T, Hook, Levels, SlotBits>::size_type
+            timing_wheel<T, Hook, Levels, SlotBits>::levels;
+
+    template<typename T, timer_hook T::*Hook, size_t Levels, size_t SlotBits>
+    constexpr typename timing_wheel<T, Hook, Levels, SlotBits>::size_type
+            timing_wheel<T, Hook, Levels, SlotBits>::slots;
+
+    template<typename T, timer_hook T::*Hook, size_t Levels, size_t SlotBits>
+    constexpr typename timing_wheel<T, Hook, Levels, SlotBits>::tick_type
+            timing_wheel<T, Hook, Levels, SlotBits>::slot_mask;
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_TIMINGWHEEL_H
@@ -24,19 +24,23 @@ namespace wlp {
      *
      * @tparam Key stored value type
      * @tparam Cmp comparator for stored value, which uses the default comparator
+     * @tparam Counted whether nodes keep subtree counts, which makes
+     *                 @code nth @endcode, @code rank @endcode, and
+     *                 @code distance @endcode logarithmic
      */
-    template<typename Key, typename Cmp = comparator<Key>>
+    template<typename Key, typename Cmp = comparator<Key>, bool Counted = false>
     class tree_set {
     public:
-        typedef tree_set<Key, Cmp> set_type;
+        typedef tree_set<Key, Cmp, Counted> set_type;
         typedef tree<Key,
             Key, Key,
             SetGetKey<Key>, SetGetVal<Key>,
-            Cmp
+            Cmp, Counted
         > table_type;
         typedef typename table_type::iterator iterator;
         typedef typename table_type::const_iterator const_iterator;
         typedef typename table_type::size_type size_type;
+        typedef typename table_type::pool_type pool_type;
 
         typedef Key key_type;
 
@@ -48,6 +52,22 @@ namespace wlp {
                 : m_table() {
         }
 
+        explicit tree_set(pool_type *pool)
+                : m_table(pool) {
+        }
+
+        template<typename It>
+        tree_set(It first, It last)
+                : m_table() {
+            m_table.assign_sorted(first, last);
+        }
+
+        template<typename It>
+        tree_set(It first, It last, pool_type *pool)
+                : m_table(pool) {
+            m_table.assign_sorted(first, last);
+        }
+
         tree_set(const set_type &) = delete;
 
         tree_set(set_type &&set)
@@ -90,6 +110,11 @@ namespace wlp {
             m_table.clear();
         }
 
+        template<typename It>
+        bool assign_sorted(It first, It last) {
+            return m_table.assign_sorted(first, last);
+        }
+
         template<typename K>
         pair<iterator, bool> insert(K &&key) {
             return m_table.insert_unique(key);
@@ -107,6 +132,62 @@ namespace wlp {
             return m_table.find(key);
         }
 
+        iterator lower_bound(const key_type &key) {
+            return m_table.lower_bound(key);
+        }
+
+        const_iterator lower_bound(const key_type &key) const {
+            return m_table.lower_bound(key);
+        }
+
+        iterator upper_bound(const key_type &key) {
+            return m_table.upper_bound(key);
+        }
+
+        const_iterator upper_bound(const key_type &key) const {
+            return m_table.upper_bound(key);
+        }
+
+        pair<iterator, iterator> equal_range(const key_type &key) {
+            return m_table.equal_range(key);
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+            return m_table.equal_range(key);
+        }
+
+        bool split(const key_type &key, set_type &right) {
+            return m_table.split(key, right.m_table);
+        }
+
+        bool join(set_type &right) {
+            return m_table.join(right.m_table);
+        }
+
+        size_type merge(set_type &other) {
+            return m_table.merge_unique(other.m_table);
+        }
+
+        iterator nth(size_type k) {
+            return m_table.nth(k);
+        }
+
+        const_iterator nth(size_type k) const {
+            return m_table.nth(k);
+        }
+
+        size_type rank(const key_type &key) const {
+            return m_table.rank(key);
+        }
+
+        size_type distance(const iterator &first, const iterator &last) const {
+            return m_table.distance(first, last);
+        }
+
+        size_type distance(const const_iterator &first, const const_iterator &last) const {
+            return m_table.distance(first, last);
+        }
+
         iterator erase(const iterator &pos) {
             iterator tmp = pos;
             ++tmp;
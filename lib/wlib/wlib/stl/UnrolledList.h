@@ -0,0 +1,776 @@
+/**
+ * @file UnrolledList.h
+ * @brief Doubly linked list storing several elements per node.
+ *
+ * An unrolled list keeps up to @code NodeSize @endcode elements in
+ * each node. Compared to a linked list of single elements, the link
+ * overhead is shared by the node's elements, traversal touches one
+ * node per run of elements, and indexing skips whole nodes by their
+ * element counts. Full nodes are split in half on insertion, and
+ * nodes that fall below half full on erasure are merged with or
+ * refilled from a neighbour.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_UNROLLEDLIST_H
+#define EMBEDDEDCPLUSPLUS_UNROLLEDLIST_H
+
+#include <stddef.h>
+
+#include <wlib/memory>
+#include <wlib/utility>
+
+namespace wlp {
+
+    /**
+     * Unrolled list node, holding a run of elements.
+     *
+     * @tparam T        value type
+     * @tparam NodeSize maximum number of elements in the node
+     */
+    template<typename T, size_t NodeSize>
+    struct UnrolledListNode {
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef UnrolledListNode<T, NodeSize> node_type;
+
+        node_type *m_next;
+        node_type *m_prev;
+        size_type m_count;
+        val_type m_vals[NodeSize];
+    };
+
+    template<typename T, size_t NodeSize>
+    class unrolled_list;
+
+    /**
+     * Iterator over the elements of an @code unrolled_list @endcode.
+     * Points to an element by its node and its index in the node.
+     *
+     * @tparam T        value type
+     * @tparam Ref      reference to value type, which may be constant
+     * @tparam Ptr      pointer to value type, which may be constant
+     * @tparam NodeSize maximum number of elements in a node
+     */
+    template<typename T, typename Ref, typename Ptr, size_t NodeSize>
+    struct UnrolledListIterator {
+        typedef T val_type;
+        typedef Ref reference;
+        typedef Ptr pointer;
+        typedef size_t size_type;
+        typedef UnrolledListNode<T, NodeSize> node_type;
+        typedef unrolled_list<T, NodeSize> list_type;
+        typedef UnrolledListIterator<T, Ref, Ptr, NodeSize> self_type;
+
+        /**
+         * Pointer to the node of the element, or null past the end.
+         */
+        node_type *m_current;
+        /**
+         * Index of the element in its node.
+         */
+        size_type m_index;
+        /**
+         * Pointer to the iterated list.
+         */
+        const list_type *m_list;
+
+        /**
+         * Default constructor.
+         */
+        UnrolledListIterator()
+                : m_current(nullptr),
+                  m_index(0),
+                  m_list(nullptr) {}
+
+        /**
+         * Create an iterator to an element.
+         *
+         * @param node  node of the element
+         * @param index index of the element in the node
+         * @param list  parent unrolled list
+         */
+        UnrolledListIterator(node_type *node, size_type index, const list_type *list)
+                : m_current(node),
+                  m_index(index),
+                  m_list(list) {}
+
+        /**
+         * Copy constructor.
+         *
+         * @param it iterator to copy
+         */
+        UnrolledListIterator(const self_type &it)
+                : m_current(it.m_current),
+                  m_index(it.m_index),
+                  m_list(it.m_list) {}
+
+        /**
+         * @return reference to the element pointed to by the iterator
+         */
+        reference operator*() const {
+            return m_current->m_vals[m_index];
+        }
+
+        /**
+         * @return pointer to the element pointed to by the iterator
+         */
+        pointer operator->() const {
+            return &(operator*());
+        }
+
+        /**
+         * Move to the next element, or the pass-the-end iterator
+         * after the last element.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator++() {
+            if (m_current && ++m_index == m_current->m_count) {
+                m_current = m_current->m_next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        /**
+         * Post-fix increment operator.
+         *
+         * @return copy of the iterator before incrementing
+         */
+        self_type operator++(int) {
+            self_type clone(*this);
+            ++*this;
+            return clone;
+        }
+
+        /**
+         * Move to the previous element. The pass-the-end iterator
+         * moves to the last element, and the iterator does not
+         * move if it is at the first element.
+         *
+         * @return reference to this iterator
+         */
+        self_type &operator--() {
+            if (!m_current) {
+                m_current = m_list->m_tail;
+                m_index = m_current ? m_current->m_count - 1 : 0;
+            } else if (m_index > 0) {
+                --m_index;
+            } else if (m_current->m_prev) {
+                m_current = m_current->m_prev;
+                m_index = m_current->m_count - 1;
+            }
+            return *this;
+        }
+
+        /**
+         * Post-fix decrement operator.
+         *
+         * @return copy of the iterator before decrementing
+         */
+        self_type operator--(int) {
+            self_type clone(*this);
+            --*this;
+            return clone;
+        }
+
+        /**
+         * Equality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to the same element
+         */
+        bool operator==(const self_type &it) const {
+            return m_current == it.m_current && m_index == it.m_index;
+        }
+
+        /**
+         * Inequality operator.
+         *
+         * @param it iterator to compare
+         * @return true if they point to different elements
+         */
+        bool operator!=(const self_type &it) const {
+            return m_current != it.m_current || m_index != it.m_index;
+        }
+
+        /**
+         * Assignment operator.
+         *
+         * @param it iterator to copy
+         * @return reference to this iterator
+         */
+        self_type &operator=(const self_type &it) {
+            m_current = it.m_current;
+            m_index = it.m_index;
+            m_list = it.m_list;
+            return *this;
+        }
+    };
+
+    /**
+     * Unrolled doubly linked list. Every node except the last holds
+     * at least half of @code NodeSize @endcode elements after an
+     * erasure, so that the list stays densely packed.
+     *
+     * @tparam T        value type
+     * @tparam NodeSize maximum number of elements in a node
+     */
+    template<typename T, size_t NodeSize = 16>
+    class unrolled_list {
+        static_assert(NodeSize >= 2, "Node size must be at least two");
+
+    public:
+        typedef T val_type;
+        typedef size_t size_type;
+        typedef unrolled_list<T, NodeSize> list_type;
+        typedef UnrolledListNode<T, NodeSize> node_type;
+        typedef UnrolledListIterator<T, T &, T *, NodeSize> iterator;
+        typedef UnrolledListIterator<T, const T &, const T *, NodeSize> const_iterator;
+
+        static constexpr size_type node_size = NodeSize;
+        static constexpr size_type min_fill = NodeSize / 2;
+
+    private:
+        /**
+         * Pointer to the first node.
+         */
+        node_type *m_head;
+        /**
+         * Pointer to the last node.
+         */
+        node_type *m_tail;
+        /**
+         * The number of elements in the list.
+         */
+        size_type m_size;
+        /**
+         * The number of nodes in the list.
+         */
+        size_type m_num_nodes;
+
+        friend struct UnrolledListIterator<T, T &, T *, NodeSize>;
+        friend struct UnrolledListIterator<T, const T &, const T *, NodeSize>;
+
+    public:
+        /**
+         * Create an empty list.
+         */
+        unrolled_list()
+                : m_head(nullptr),
+                  m_tail(nullptr),
+                  m_size(0),
+                  m_num_nodes(0) {}
+
+        /**
+         * Disable copy construction.
+         */
+        unrolled_list(const list_type &) = delete;
+
+        /**
+         * Move constructor. The moved list is left empty.
+         *
+         * @param list the list to move
+         */
+        unrolled_list(list_type &&list)
+                : m_head(list.m_head),
+                  m_tail(list.m_tail),
+                  m_size(list.m_size),
+                  m_num_nodes(list.m_num_nodes) {
+            list.m_head = nullptr;
+            list.m_tail = nullptr;
+            list.m_size = 0;
+            list.m_num_nodes = 0;
+        }
+
+        /**
+         * Deallocate all nodes.
+         */
+        ~unrolled_list() {
+            clear();
+        }
+
+        /**
+         * @return whether the list has no elements
+         */
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /**
+         * @return the number of elements in the list
+         */
+        size_type size() const {
+            return m_size;
+        }
+
+        /**
+         * @return the number of elements storable without allocating
+         */
+        size_type capacity() const {
+            return m_num_nodes * NodeSize;
+        }
+
+        /**
+         * @return the number of nodes in the list
+         */
+        size_type nodes() const {
+            return m_num_nodes;
+        }
+
+        /**
+         * Obtain the element at an index, which wraps around
+         * if it is out of bounds. The list must not be empty.
+         *
+         * @param i index of the element
+         * @return reference to the element
+         */
+        val_type &at(size_type i) {
+            iterator it = locate(i % m_size);
+            return *it;
+        }
+
+        /**
+         * @param i index of the element
+         * @return constant reference to the element
+         */
+        const val_type &at(size_type i) const {
+            return const_cast<list_type *>(this)->at(i);
+        }
+
+        /**
+         * @param i index of the element
+         * @return reference to the element
+         */
+        val_type &operator[](size_type i) {
+            return at(i);
+        }
+
+        /**
+         * @param i index of the element
+         * @return constant reference to the element
+         */
+        const val_type &operator[](size_type i) const {
+            return at(i);
+        }
+
+        /**
+         * @return reference to the first element
+         */
+        val_type &front() {
+            return m_head->m_vals[0];
+        }
+
+        /**
+         * @return constant reference to the first element
+         */
+        const val_type &front() const {
+            return m_head->m_vals[0];
+        }
+
+        /**
+         * @return reference to the last element
+         */
+        val_type &back() {
+            return m_tail->m_vals[m_tail->m_count - 1];
+        }
+
+        /**
+         * @return constant reference to the last element
+         */
+        const val_type &back() const {
+            return m_tail->m_vals[m_tail->m_count - 1];
+        }
+
+        /**
+         * @return iterator to the first element
+         */
+        iterator begin() {
+            return iterator(m_head, 0, this);
+        }
+
+        /**
+         * @return pass-the-end iterator
+         */
+        iterator end() {
+            return iterator(nullptr, 0, this);
+        }
+
+        /**
+         * @return constant iterator to the first element
+         */
+        const_iterator begin() const {
+            return const_iterator(m_head, 0, this);
+        }
+
+        /**
+         * @return constant pass-the-end iterator
+         */
+        const_iterator end() const {
+            return const_iterator(nullptr, 0, this);
+        }
+
+        /**
+         * Insert a value before the given position.
+         *
+         * @param it  iterator to the element before which to insert
+         * @param val the value to insert
+         * @return iterator to the inserted element, or the pass-the-end
+         * iterator if a node could not be allocated
+         */
+        template<typename V>
+        iterator insert(const iterator &it, V &&val);
+
+        /**
+         * Insert a value at the given index, which wraps
+         * around if it is out of bounds.
+         *
+         * @param i   the index at which to insert
+         * @param val the value to insert
+         * @return iterator to the inserted element
+         */
+        template<typename V>
+        iterator insert(size_type i, V &&val) {
+            if (!m_size) {
+                return insert(end(), forward<V>(val));
+            }
+            return insert(locate(i % m_size), forward<V>(val));
+        }
+
+        /**
+         * Remove the element at the given position.
+         *
+         * @param it iterator to the element to remove
+         * @return iterator to the next element
+         */
+        iterator erase(const iterator &it);
+
+        /**
+         * Remove the element at the given index, which wraps
+         * around if it is out of bounds.
+         *
+         * @param i the index of the element to remove
+         * @return iterator to the next element
+         */
+        iterator erase(size_type i) {
+            if (!m_size) {
+                return end();
+            }
+            return erase(locate(i % m_size));
+        }
+
+        /**
+         * Append a value to the list.
+         *
+         * @param val the value to append
+         */
+        template<typename V>
+        void push_back(V &&val) {
+            if (!m_tail || m_tail->m_count == NodeSize) {
+                if (!append_node(m_tail)) {
+                    return;
+                }
+            }
+            m_tail->m_vals[m_tail->m_count++] = forward<V>(val);
+            ++m_size;
+        }
+
+        /**
+         * Prepend a value to the list.
+         *
+         * @param val the value to prepend
+         */
+        template<typename V>
+        void push_front(V &&val) {
+            insert(begin(), forward<V>(val));
+        }
+
+        /**
+         * Remove the last element, if any.
+         */
+        void pop_back() {
+            if (m_size) {
+                erase(iterator(m_tail, m_tail->m_count - 1, this));
+            }
+        }
+
+        /**
+         * Remove the first element, if any.
+         */
+        void pop_front() {
+            if (m_size) {
+                erase(begin());
+            }
+        }
+
+        /**
+         * Remove all elements and deallocate all nodes.
+         */
+        void clear() noexcept;
+
+        /**
+         * Find the first element equal to the value.
+         *
+         * @param val the value to find
+         * @return iterator to the element or pass-the-end iterator
+         */
+        iterator find(const val_type &val) {
+            for (node_type *node = m_head; node; node = node->m_next) {
+                for (size_type i = 0; i < node->m_count; ++i) {
+                    if (node->m_vals[i] == val) {
+                        return iterator(node, i, this);
+                    }
+                }
+            }
+            return end();
+        }
+
+        /**
+         * @param val the value to find
+         * @return constant iterator to the element or pass-the-end iterator
+         */
+        const_iterator find(const val_type &val) const {
+            iterator it = const_cast<list_type *>(this)->find(val);
+            return const_iterator(it.m_current, it.m_index, this);
+        }
+
+        /**
+         * @param val the value to find
+         * @return the index of the first element equal to the
+         * value, or the size of the list if there is none
+         */
+        size_type index_of(const val_type &val) const {
+            size_type offset = 0;
+            for (node_type *node = m_head; node; node = node->m_next) {
+                for (size_type i = 0; i < node->m_count; ++i) {
+                    if (node->m_vals[i] == val) {
+                        return offset + i;
+                    }
+                }
+                offset += node->m_count;
+            }
+            return m_size;
+        }
+
+        /**
+         * Disable copy assignment.
+         *
+         * @return reference to this list
+         */
+        list_type &operator=(const list_type &) = delete;
+
+        /**
+         * Move assignment operator. Elements in this list are
+         * destroyed and replaced by those of the moved list.
+         *
+         * @param list the list to move
+         * @return reference to this list
+         */
+        list_type &operator=(list_type &&list) {
+            clear();
+            m_head = list.m_head;
+            m_tail = list.m_tail;
+            m_size = list.m_size;
+            m_num_nodes = list.m_num_nodes;
+            list.m_head = nullptr;
+            list.m_tail = nullptr;
+            list.m_size = 0;
+            list.m_num_nodes = 0;
+            return *this;
+        }
+
+    private:
+        /**
+         * Obtain an iterator to a valid index, walking from
+         * whichever end of the list is closer.
+         *
+         * @param i index of the element
+         * @return iterator to the element
+         */
+        iterator locate(size_type i) {
+            if (i < m_size / 2) {
+                node_type *node = m_head;
+                while (i >= node->m_count) {
+                    i -= node->m_count;
+                    node = node->m_next;
+                }
+                return iterator(node, i, this);
+            }
+            size_type back = m_size - i;
+            node_type *node = m_tail;
+            while (back > node->m_count) {
+                back -= node->m_count;
+                node = node->m_prev;
+            }
+            return iterator(node, node->m_count - back, this);
+        }
+
+        /**
+         * Allocate an empty node and link it after the given node.
+         *
+         * @param prev node after which to link, or null to link at the front
+         * @return the new node, or null if allocation failed
+         */
+        node_type *append_node(node_type *prev) {
+            node_type *node = create<node_type>();
+            if (!node) {
+                return nullptr;
+            }
+            node->m_count = 0;
+            node->m_prev = prev;
+            node->m_next = prev ? prev->m_next : m_head;
+            if (node->m_next) {
+                node->m_next->m_prev = node;
+            } else {
+                m_tail = node;
+            }
+            if (prev) {
+                prev->m_next = node;
+            } else {
+                m_head = node;
+            }
+            ++m_num_nodes;
+            return node;
+        }
+
+        /**
+         * Unlink and deallocate a node.
+         *
+         * @param node the node to remove
+         */
+        void remove_node(node_type *node) {
+            if (node->m_prev) {
+                node->m_prev->m_next = node->m_next;
+            } else {
+                m_head = node->m_next;
+            }
+            if (node->m_next) {
+                node->m_next->m_prev = node->m_prev;
+            } else {
+                m_tail = node->m_prev;
+            }
+            destroy<node_type>(node);
+            --m_num_nodes;
+        }
+
+        /**
+         * Move elements from the back of one node to the back of another.
+         *
+         * @param from  the node to move elements out of
+         * @param first the index of the first element to move
+         * @param to    the node to move elements into
+         */
+        static void move_tail(node_type *from, size_type first, node_type *to) {
+            for (size_type i = first; i < from->m_count; ++i) {
+                to->m_vals[to->m_count++] = move(from->m_vals[i]);
+                from->m_vals[i] = val_type();
+            }
+            from->m_count = first;
+        }
+    };
+
+    template<typename T, size_t NodeSize>
+    constexpr typename unrolled_list<T, NodeSize>::size_type unrolled_list<T, NodeSize>::node_size;
+
+    template<typename T, size_t NodeSize>
+    constexpr typename unrolled_list<T, NodeSize>::size_type unrolled_list<T, NodeSize>::min_fill;
+
+    template<typename T, size_t NodeSize>
+    template<typename V>
+    typename unrolled_list<T, NodeSize>::iterator
+    unrolled_list<T, NodeSize>::insert(const iterator &it, V &&val) {
+        node_type *node = it.m_current;
+        size_type index = it.m_index;
+        if (!node) {
+            // inserting at the end appends to the last node
+            if (!m_tail || m_tail->m_count == NodeSize) {
+                if (!append_node(m_tail)) {
+                    return end();
+                }
+            }
+            node = m_tail;
+            index = node->m_count;
+        } else if (node->m_count == NodeSize) {
+            // split the full node in half
+            node_type *next = append_node(node);
+            if (!next) {
+                return end();
+            }
+            move_tail(node, NodeSize / 2, next);
+            if (index > node->m_count) {
+                index -= node->m_count;
+                node = next;
+            }
+        }
+        for (size_type i = node->m_count; i > index; --i) {
+            node->m_vals[i] = move(node->m_vals[i - 1]);
+        }
+        node->m_vals[index] = forward<V>(val);
+        ++node->m_count;
+        ++m_size;
+        return iterator(node, index, this);
+    }
+
+    template<typename T, size_t NodeSize>
+    typename unrolled_list<T, NodeSize>::iterator
+    unrolled_list<T, NodeSize>::erase(const iterator &it) {
+        node_type *node = it.m_current;
+        size_type index = it.m_index;
+        if (!node) {
+            return end();
+        }
+        --node->m_count;
+        for (size_type i = index; i < node->m_count; ++i) {
+            node->m_vals[i] = move(node->m_vals[i + 1]);
+        }
+        node->m_vals[node->m_count] = val_type();
+        --m_size;
+        if (node->m_count < min_fill) {
+            node_type *next = node->m_next;
+            node_type *prev = node->m_prev;
+            if (next && node->m_count + next->m_count <= NodeSize) {
+                // absorb the next node, positions in this node are kept
+                move_tail(next, 0, node);
+                remove_node(next);
+            } else if (prev && prev->m_count + node->m_count <= NodeSize) {
+                // fold this node into the previous node
+                index += prev->m_count;
+                move_tail(node, 0, prev);
+                remove_node(node);
+                node = prev;
+            } else if (next) {
+                // refill from the front of the next node
+                node->m_vals[node->m_count++] = move(next->m_vals[0]);
+                --next->m_count;
+                for (size_type i = 0; i < next->m_count; ++i) {
+                    next->m_vals[i] = move(next->m_vals[i + 1]);
+                }
+                next->m_vals[next->m_count] = val_type();
+            } else if (node->m_count == 0) {
+                remove_node(node);
+                return end();
+            }
+        }
+        if (index == node->m_count) {
+            return iterator(node->m_next, 0, this);
+        }
+        return iterator(node, index, this);
+    }
+
+    template<typename T, size_t NodeSize>
+    void unrolled_list<T, NodeSize>::clear() noexcept {
+        while (m_head) {
+            node_type *next = m_head->m_next;
+            destroy<node_type>(m_head);
+            m_head = next;
+        }
+        m_tail = nullptr;
+        m_size = 0;
+        m_num_nodes = 0;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_UNROLLEDLIST_H
@@ -13,11 +13,17 @@
 
 namespace wlp {
 
-    dynamic_string::dynamic_string() :
-        dynamic_string(nullptr, nullptr, 0, 0) {}
+    constexpr string_view::size_type string_view::npos;
 
-    dynamic_string::dynamic_string(nullptr_t) :
-        dynamic_string(nullptr, nullptr, 0, 0) {}
+    constexpr dynamic_string::size_type dynamic_string::local_capacity;
+
+    dynamic_string::dynamic_string() {
+        set_local();
+    }
+
+    dynamic_string::dynamic_string(nullptr_t) {
+        set_local();
+    }
 
     dynamic_string::dynamic_string(const char *str)
             : dynamic_string(str, nullptr, static_cast<size_type>(strlen(str)), 0) {}
@@ -25,42 +31,42 @@ namespace wlp {
     dynamic_string::dynamic_string(const char *str, size_type len)
             : dynamic_string(str, nullptr, len, 0) {}
 
-    dynamic_string::dynamic_string(size_type len, char *str)
-            : m_buffer(str),
-              m_len(len) {}
+    dynamic_string::dynamic_string(string_view str)
+            : dynamic_string(str.data(), str.length()) {}
 
-    dynamic_string::dynamic_string(const dynamic_string &str) : dynamic_string(str.c_str()) {}
+    dynamic_string::dynamic_string(const dynamic_string &str)
+            : dynamic_string(str.c_str(), str.length()) {}
 
-    dynamic_string::dynamic_string(dynamic_string &&str) noexcept
-            : m_buffer(str.m_buffer),
-              m_len(str.m_len) {
-        str.m_len = 0;
-        str.m_buffer = create<char[]>(1);
-        str.m_buffer[0] = '\0';
+    dynamic_string::dynamic_string(dynamic_string &&str) noexcept {
+        memcpy(m_local, str.m_local, sizeof(m_local));
+        str.set_local();
     }
 
     dynamic_string::dynamic_string(const char *str1, const char *str2, size_type len1, size_type len2) {
-        m_len = len1 + len2;
-        m_buffer = create<char[]>(static_cast<size_type>(m_len + 1));
-        memcpy(m_buffer, str1, len1);
-        memcpy(m_buffer + len1, str2, len2);
-        m_buffer[m_len] = '\0';
+        auto len = static_cast<size_type>(len1 + len2);
+        set_local();
+        allocate(len);
+        char *buf = buffer();
+        memcpy(buf, str1, len1);
+        memcpy(buf + len1, str2, len2);
+        buf[len] = '\0';
+        length_set(len);
     }
 
     dynamic_string::~dynamic_string() {
-        if (m_buffer) {
-            destroy<char[]>(m_buffer);
+        if (!is_local()) {
+            destroy<char[]>(m_heap.m_data);
         }
     }
 
     void dynamic_string::set_value(const char *str, size_type len) {
-        if (len > m_len) {
-            destroy<char[]>(m_buffer);
-            m_buffer = create<char[]>(static_cast<size_type>(len + 1));
+        if (len > capacity()) {
+            allocate(len);
         }
-        m_len = len;
-        memcpy(m_buffer, str, len);
-        m_buffer[len] = '\0';
+        char *buf = buffer();
+        memmove(buf, str, len);
+        buf[len] = '\0';
+        length_set(len);
     }
 
     dynamic_string &dynamic_string::operator=(const dynamic_string &str) {
@@ -74,74 +80,124 @@ namespace wlp {
     }
 
     dynamic_string &dynamic_string::operator=(dynamic_string &&str) noexcept {
-        destroy<char[]>(m_buffer);
-        m_buffer = str.m_buffer;
-        m_len = str.m_len;
-        str.m_len = 0;
-        str.m_buffer = create<char[]>(1);
-        str.m_buffer[0] = '\0';
+        if (this == &str) {
+            return *this;
+        }
+        if (str.is_local()) {
+            set_value(str.m_local, str.length());
+        } else {
+            if (!is_local()) {
+                destroy<char[]>(m_heap.m_data);
+            }
+            memcpy(m_local, str.m_local, sizeof(m_local));
+        }
+        str.set_local();
         return *this;
     }
 
     dynamic_string &dynamic_string::operator=(const char c) {
-        destroy<char[]>(m_buffer);
-        m_buffer = create<char[]>(2);
-        reinterpret_cast<uint16_t *>(m_buffer)[0] = static_cast<uint16_t>(c);
+        set_value(&c, 1);
         return *this;
     }
 
     dynamic_string::size_type dynamic_string::length() const {
-        return m_len;
+        return is_local() ? static_cast<size_type>(tag() >> tag_shift) : m_heap.m_len;
     }
 
     dynamic_string::size_type dynamic_string::capacity() const {
-        return static_cast<size_type>(-1);
+        return is_local() ? local_capacity : heap_capacity();
+    }
+
+    void dynamic_string::allocate(size_type len) {
+        if (!is_local()) {
+            destroy<char[]>(m_heap.m_data);
+        }
+        if (len <= local_capacity) {
+            set_local();
+        } else {
+            set_heap(create<char[]>(static_cast<size_type>(len + 1)), len);
+        }
+    }
+
+    void dynamic_string::reallocate(size_type cap) {
+        size_type len = length();
+        if (cap <= local_capacity) {
+            if (!is_local()) {
+                char *oldBuffer = m_heap.m_data;
+                set_local();
+                memcpy(m_local, oldBuffer, len + 1);
+                destroy<char[]>(oldBuffer);
+                length_set(len);
+            }
+            return;
+        }
+        char *newBuffer = create<char[]>(static_cast<size_type>(cap + 1));
+        memcpy(newBuffer, buffer(), len + 1);
+        if (!is_local()) {
+            destroy<char[]>(m_heap.m_data);
+        }
+        set_heap(newBuffer, cap);
+        length_set(len);
+    }
+
+    void dynamic_string::reserve(size_type cap) {
+        if (cap > capacity()) {
+            reallocate(cap);
+        }
+    }
+
+    void dynamic_string::shrink_to_fit() {
+        if (!is_local() && heap_capacity() > m_heap.m_len) {
+            reallocate(m_heap.m_len);
+        }
     }
 
     void dynamic_string::clear() noexcept {
-        m_buffer[0] = '\0';
-        m_len = 0;
+        buffer()[0] = '\0';
+        length_set(0);
     }
 
     char &dynamic_string::operator[](size_type pos) {
-        return m_buffer[pos];
+        return buffer()[pos];
     }
 
     const char &dynamic_string::operator[](size_type pos) const {
-        return m_buffer[pos];
+        return buffer()[pos];
     }
 
     char &dynamic_string::at(size_type pos) {
-        return pos < m_len ? m_buffer[pos] : m_buffer[m_len];
+        size_type len = length();
+        return pos < len ? buffer()[pos] : buffer()[len];
     }
 
     const char &dynamic_string::at(size_type pos) const {
-        return pos < m_len ? m_buffer[pos] : m_buffer[m_len];
+        size_type len = length();
+        return pos < len ? buffer()[pos] : buffer()[len];
     }
 
     bool dynamic_string::empty() const {
-        return m_len == 0;
+        return length() == 0;
     }
 
     char &dynamic_string::front() {
-        return m_buffer[0];
+        return buffer()[0];
     }
 
     const char &dynamic_string::front() const {
-        return m_buffer[0];
+        return buffer()[0];
     }
 
     char &dynamic_string::back() {
-        return empty() ? m_buffer[0] : m_buffer[m_len - 1];
+        return empty() ? buffer()[0] : buffer()[length() - 1];
     }
 
     const char &dynamic_string::back() const {
-        return empty() ? m_buffer[0] : m_buffer[m_len - 1];
+        return empty() ? buffer()[0] : buffer()[length() - 1];
     }
 
     dynamic_string &dynamic_string::operator+=(char c) {
-        const char array[2] = {c, '\0'};
-        return append(array, 1);
+        push_back(c);
+        return *this;
     }
 
     dynamic_string &dynamic_string::operator+=(const char *val) {
@@ -153,15 +209,24 @@ namespace wlp {
     }
 
     dynamic_string &dynamic_string::append(const char *c_str, size_type len) {
-        auto newLength = static_cast<size_type>(m_len + len);
-        char *newBuffer = create<char[]>(newLength + 1);
-        memcpy(newBuffer, m_buffer, m_len);
-        memcpy(newBuffer + m_len, c_str, len);
-        destroy<char[]>(m_buffer);
-        m_buffer = newBuffer;
+        size_type oldLength = length();
+        auto newLength = static_cast<size_type>(oldLength + len);
+        if (newLength > capacity()) {
+            // grow geometrically so that repeated appends are amortized constant
+            size_type newCapacity = MAX(newLength, static_cast<size_type>(2 * capacity()));
+            char *newBuffer = create<char[]>(static_cast<size_type>(newCapacity + 1));
+            memcpy(newBuffer, buffer(), oldLength);
+            memcpy(newBuffer + oldLength, c_str, len);
+            if (!is_local()) {
+                destroy<char[]>(m_heap.m_data);
+            }
+            set_heap(newBuffer, newCapacity);
+        } else {
+            memmove(buffer() + oldLength, c_str, len);
+        }
 
-        m_buffer[newLength] = '\0';
-        m_len = newLength;
+        buffer()[newLength] = '\0';
+        length_set(newLength);
 
         return *this;
     }
@@ -175,49 +240,64 @@ namespace wlp {
     }
 
     void dynamic_string::push_back(const char c) {
-        const char array[2] = {c, '\0'};
-        append(array, 1);
+        size_type len = length();
+        if (len == capacity()) {
+            reserve(MAX(static_cast<size_type>(2 * len), static_cast<size_type>(len + 1)));
+        }
+        char *buf = buffer();
+        buf[len] = c;
+        buf[len + 1] = '\0';
+        length_set(static_cast<size_type>(len + 1));
     }
 
     void dynamic_string::erase(size_type pos) {
-        if (m_len == 0 || pos >= m_len) { return; }
-        m_len--;
-        memmove(m_buffer + pos, m_buffer + pos + 1, m_len - pos);
-        m_buffer[m_len] = '\0';
+        size_type len = length();
+        if (len == 0 || pos >= len) { return; }
+        len--;
+        char *buf = buffer();
+        memmove(buf + pos, buf + pos + 1, len - pos);
+        buf[len] = '\0';
+        length_set(len);
     }
 
     void dynamic_string::pop_back() {
-        if (m_len != 0) {
-            m_buffer[m_len - 1] = '\0';
-            m_len--;
+        size_type len = length();
+        if (len != 0) {
+            buffer()[len - 1] = '\0';
+            length_set(static_cast<size_type>(len - 1));
         }
     }
 
     char *dynamic_string::c_str() {
-        return m_buffer;
+        return buffer();
     }
 
     const char *dynamic_string::c_str() const {
-        return m_buffer;
+        return buffer();
     }
 
     void dynamic_string::resize(size_type len) {
-        if (m_buffer) { destroy<char[]>(m_buffer); }
-        m_buffer = create<char[]>(static_cast<size_type>(len + 1));
-        m_buffer[0] = '\0';
-        m_len = 0;
+        if (len > capacity()) {
+            allocate(len);
+        }
+        buffer()[0] = '\0';
+        length_set(0);
     }
 
     void dynamic_string::length_set(size_type len) {
-        m_len = len;
+        if (is_local()) {
+            m_local[sizeof(m_local) - 1] = static_cast<char>(len << tag_shift);
+        } else {
+            m_heap.m_len = len;
+        }
     }
 
     dynamic_string dynamic_string::substr(size_type pos, size_type length) const {
-        length = pos >= m_len ? 0 : MIN(length, m_len - pos);
-        char *newBuffer = create<char[]>(static_cast<size_type>(length + 1));
-        memcpy(newBuffer, m_buffer + pos, length);
-        newBuffer[length] = '\0';
-        return {length, newBuffer};
+        size_type len = this->length();
+        if (pos >= len) {
+            return dynamic_string();
+        }
+        return dynamic_string(buffer() + pos, MIN(length, static_cast<size_type>(len - pos)));
     }
 
     dynamic_string::diff_type dynamic_string::compare(const dynamic_string &str) const {
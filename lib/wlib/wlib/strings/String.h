@@ -13,6 +13,7 @@
 #define EMBEDDEDCPLUSPLUS_STRINGTYPES_H
 
 #include <wlib/strings/StringIterator.h>
+#include <wlib/strings/StringView.h>
 #include <wlib/tmp/NullptrType.h>
 #include <wlib/stl/Helper.h>
 #include <stdint.h>
@@ -73,6 +74,14 @@ namespace wlp {
          */
         explicit static_string<tSize>(const dynamic_string &str);
 
+        /**
+         * Constructor creates a string from the characters of a view.
+         *
+         * @param str string view to copy
+         */
+        explicit static_string<tSize>(string_view str)
+                : static_string(str.data(), str.length()) {}
+
         /**
          * Construct a Static String from a character array and a known length.
          *
@@ -441,10 +450,27 @@ namespace wlp {
             if (pos + length >= m_len) {
                 length = static_cast<size_type>(m_len - pos);
             }
-            static_string<tSize> sub;
-            memcpy(sub.m_buffer, m_buffer + pos, length);
-            sub.m_buffer[length] = '\0';
-            return sub;
+            return static_string<tSize>(m_buffer + pos, length);
+        }
+
+        /**
+         * Makes a view of a substring of the current string without
+         * copying it. If @p pos is out of bounds the view is empty.
+         * The view is invalidated when the string is modified.
+         *
+         * @param pos starting position
+         * @param length maximum length of the substring
+         * @return view of the substring
+         */
+        string_view substr_view(size_type pos, size_type length = string_view::npos) const {
+            return string_view(m_buffer, m_len).substr(pos, length);
+        }
+
+        /**
+         * @return a view of the characters of the string
+         */
+        operator string_view() const {
+            return string_view(m_buffer, m_len);
         }
 
         /**
@@ -782,6 +808,13 @@ namespace wlp {
         explicit dynamic_string(const static_string<tSize> &str)
                 : dynamic_string(str.c_str(), str.length()) {}
 
+        /**
+         * Construct a dynamic string from the characters of a view.
+         *
+         * @param str string view to copy
+         */
+        explicit dynamic_string(string_view str);
+
         /**
          * Construct a dynamic string from a character array and
          * a known length.
@@ -858,13 +891,27 @@ namespace wlp {
         size_type length() const;
 
         /**
-         * The DynamicString has capacity equal to the maximum
-         * possible value of @code size_type @endcode.
+         * The number of characters the string can hold before
+         * its backing array must be reallocated.
          *
-         * @return the maximum dynamic string capcacity
+         * @return the string capacity
          */
         size_type capacity() const;
 
+        /**
+         * Grow the backing array to hold at least @p cap characters.
+         * The contents are kept. Does nothing if the capacity is
+         * already large enough.
+         *
+         * @param cap number of characters to make room for
+         */
+        void reserve(size_type cap);
+
+        /**
+         * Reallocate the backing array to fit the current length.
+         */
+        void shrink_to_fit();
+
         /**
          * Clears the string such that there are no characters left in it.
          */
@@ -1020,9 +1067,10 @@ namespace wlp {
         const char *c_str() const;
 
         /**
-         * Discard current contents and replace the backing array
-         * with one of size @code len + 1 @endcode. The first character
-         * is set to null and the length is zero to zero.
+         * Discard current contents and make room for @code len @endcode
+         * characters, replacing the backing array if it is too small
+         * and the local array cannot hold them. The first character
+         * is set to null and the length is set to zero.
          *
          * Used for direct writing to the underlying array.
          *
@@ -1047,6 +1095,26 @@ namespace wlp {
          */
         dynamic_string substr(size_type pos, size_type length) const;
 
+        /**
+         * Makes a view of a substring of the current string without
+         * copying it. If @p pos is out of bounds the view is empty.
+         * The view is invalidated when the string is modified.
+         *
+         * @param pos starting position
+         * @param length maximum length of the substring
+         * @return view of the substring
+         */
+        string_view substr_view(size_type pos, size_type length = string_view::npos) const {
+            return string_view(c_str(), this->length()).substr(pos, length);
+        }
+
+        /**
+         * @return a view of the characters of the string
+         */
+        operator string_view() const {
+            return string_view(c_str(), length());
+        }
+
         /**
          * Compares two strings and return 0 if they are equal, less than 0 if
          * given string is less than current string and greater than 0 if
@@ -1087,7 +1155,7 @@ namespace wlp {
         }
 
         iterator end() {
-            return iterator(m_len, this);
+            return iterator(length(), this);
         }
 
         const_iterator begin() const {
@@ -1095,17 +1163,127 @@ namespace wlp {
         }
 
         const_iterator end() const {
-            return const_iterator(m_len, this);
+            return const_iterator(length(), this);
         }
 
         template<size_t tSize>
         dynamic_string operator+(const static_string<tSize> &str) {
-            return {m_buffer, str.c_str(), m_len, str.length()};
+            return {c_str(), str.c_str(), length(), str.length()};
         }
 
+        /**
+         * Number of characters held inside the string object itself.
+         * Longer strings are stored in a heap allocated array.
+         */
+        static constexpr size_type local_capacity = sizeof(char *) + 2 * sizeof(size_type) - 2;
+
     private:
-        char *m_buffer;
-        size_type m_len;
+        /**
+         * Representation of a string stored in a heap allocated array.
+         */
+        struct heap_rep {
+            char *m_data;
+            size_type m_len;
+            /**
+             * Characters the array can hold, excluding the null
+             * terminator, encoded together with the heap flag.
+             */
+            size_type m_capacity;
+        };
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        static constexpr unsigned char tag_shift = 1;
+        static constexpr unsigned char heap_flag = 1;
+        static constexpr size_type heap_capacity_flag = 1;
+#else
+        static constexpr unsigned char tag_shift = 0;
+        static constexpr unsigned char heap_flag = 0x80;
+        static constexpr size_type heap_capacity_flag =
+                static_cast<size_type>(1) << (8 * sizeof(size_type) - 1);
+#endif
+
+        /**
+         * The last byte of the object is shared by the most significant
+         * byte of the heap capacity and the tag of a local string, which
+         * holds its length. The heap flag is a bit of that byte that
+         * local lengths never set.
+         */
+        union {
+            heap_rep m_heap;
+            /**
+             * Storage for strings of up to @code local_capacity @endcode
+             * characters, followed by the tag byte.
+             */
+            char m_local[sizeof(heap_rep)];
+        };
+
+        /**
+         * @return the byte holding the local length and the heap flag
+         */
+        unsigned char tag() const {
+            return static_cast<unsigned char>(m_local[sizeof(m_local) - 1]);
+        }
+
+        /**
+         * @return true if the string is stored in the local array
+         */
+        bool is_local() const {
+            return !(tag() & heap_flag);
+        }
+
+        /**
+         * @return the local array or the heap allocated array
+         */
+        char *buffer() {
+            return is_local() ? m_local : m_heap.m_data;
+        }
+
+        const char *buffer() const {
+            return is_local() ? m_local : m_heap.m_data;
+        }
+
+        /**
+         * @return capacity of the heap allocated array
+         */
+        size_type heap_capacity() const {
+            return (m_heap.m_capacity & ~heap_capacity_flag) >> tag_shift;
+        }
+
+        /**
+         * Point the string at a heap allocated array. The
+         * length must be set afterwards.
+         *
+         * @param data the heap allocated array
+         * @param cap characters the array can hold
+         */
+        void set_heap(char *data, size_type cap) {
+            m_heap.m_data = data;
+            m_heap.m_capacity = (cap << tag_shift) | heap_capacity_flag;
+        }
+
+        /**
+         * Make the string an empty string in the local array.
+         */
+        void set_local() {
+            m_local[0] = '\0';
+            m_local[sizeof(m_local) - 1] = '\0';
+        }
+
+        /**
+         * Make room for a number of characters, discarding the contents.
+         * The local array is used if it is large enough.
+         *
+         * @param len number of characters to hold
+         */
+        void allocate(size_type len);
+
+        /**
+         * Move the contents into a new backing array, which is the
+         * local array if the contents fit and the capacity allows it.
+         *
+         * @param cap capacity of the new array
+         */
+        void reallocate(size_type cap);
 
         /**
          * Constructor used by other String constructors to create @code dynamic_string @endcode.
@@ -1117,15 +1295,6 @@ namespace wlp {
          */
         dynamic_string(const char *str1, const char *str2, size_type len1, size_type len2);
 
-        /**
-         * Constructor for populating a dynamic_string with a dynamically allocated
-         * character array which the string takes ownership of and its length.
-         *
-         * @param str dynamically allocated character array filled with characters
-         * @param len length of the string
-         */
-        dynamic_string(size_type len, char *str);
-
         /**
          * Append method used by other public append methods.
          *
@@ -0,0 +1,234 @@
+/**
+ * @file StringView.h
+ * @brief Non-owning reference to a sequence of characters.
+ *
+ * A string view is a pointer and a length into characters owned
+ * elsewhere, such as a static string, a dynamic string, or a
+ * message buffer. Taking substrings of a view does not allocate
+ * or copy, which makes views suited to parsing and tokenizing.
+ * The characters of a view are not necessarily null terminated,
+ * and a view must not outlive the characters it refers to.
+ *
+ * @bug No known bugs
+ */
+
+#ifndef EMBEDDEDCPLUSPLUS_STRINGVIEW_H
+#define EMBEDDEDCPLUSPLUS_STRINGVIEW_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include <wlib/stl/Helper.h>
+
+namespace wlp {
+
+    class string_view {
+    public:
+        typedef size_t size_type;
+        typedef ptrdiff_t diff_type;
+        typedef const char *const_iterator;
+
+        /**
+         * Position returned by searches that find nothing.
+         */
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        /**
+         * Create an empty view.
+         */
+        string_view()
+                : m_data(""),
+                  m_len(0) {}
+
+        /**
+         * Create a view of a null terminated string.
+         *
+         * @param str null terminated string
+         */
+        string_view(const char *str)
+                : m_data(str),
+                  m_len(static_cast<size_type>(strlen(str))) {}
+
+        /**
+         * Create a view of a character array of known length.
+         *
+         * @param str character array
+         * @param len number of characters
+         */
+        string_view(const char *str, size_type len)
+                : m_data(str),
+                  m_len(len) {}
+
+        /**
+         * @return pointer to the first character, which is
+         * not necessarily null terminated
+         */
+        const char *data() const {
+            return m_data;
+        }
+
+        /**
+         * @return the number of characters in the view
+         */
+        size_type length() const {
+            return m_len;
+        }
+
+        /**
+         * @return true if the view has no characters
+         */
+        bool empty() const {
+            return m_len == 0;
+        }
+
+        /**
+         * @param pos index of the character, which must be in the view
+         * @return the character at the index
+         */
+        const char &operator[](size_type pos) const {
+            return m_data[pos];
+        }
+
+        /**
+         * @return the first character; the view must not be empty
+         */
+        const char &front() const {
+            return m_data[0];
+        }
+
+        /**
+         * @return the last character; the view must not be empty
+         */
+        const char &back() const {
+            return m_data[m_len - 1];
+        }
+
+        const_iterator begin() const {
+            return m_data;
+        }
+
+        const_iterator end() const {
+            return m_data + m_len;
+        }
+
+        /**
+         * Drop characters from the front of the view.
+         *
+         * @param n number of characters to drop
+         */
+        void remove_prefix(size_type n) {
+            n = MIN(n, m_len);
+            m_data += n;
+            m_len -= n;
+        }
+
+        /**
+         * Drop characters from the back of the view.
+         *
+         * @param n number of characters to drop
+         */
+        void remove_suffix(size_type n) {
+            m_len -= MIN(n, m_len);
+        }
+
+        /**
+         * Make a view of part of this view. If @p pos is out of
+         * bounds the view is empty, and if the length is too long
+         * the view extends to the end of this view.
+         *
+         * @param pos    starting position
+         * @param length maximum number of characters
+         * @return a view of the substring
+         */
+        string_view substr(size_type pos, size_type length = npos) const {
+            if (pos >= m_len) {
+                return string_view(m_data + m_len, 0);
+            }
+            return string_view(m_data + pos, MIN(length, static_cast<size_type>(m_len - pos)));
+        }
+
+        /**
+         * @param c   character to find
+         * @param pos position from which to search
+         * @return the position of the first match, or @code npos @endcode
+         */
+        size_type find(char c, size_type pos = 0) const {
+            if (pos >= m_len) {
+                return npos;
+            }
+            const void *match = memchr(m_data + pos, c, m_len - pos);
+            return match ? static_cast<size_type>(static_cast<const char *>(match) - m_data) : npos;
+        }
+
+        /**
+         * @param str characters to find
+         * @param pos position from which to search
+         * @return the position of the first match, or @code npos @endcode
+         */
+        size_type find(string_view str, size_type pos = 0) const {
+            if (str.m_len > m_len) {
+                return npos;
+            }
+            for (size_type last = m_len - str.m_len; pos <= last; ++pos) {
+                if (memcmp(m_data + pos, str.m_data, str.m_len) == 0) {
+                    return pos;
+                }
+            }
+            return npos;
+        }
+
+        /**
+         * @param str prefix to test
+         * @return true if the view begins with the prefix
+         */
+        bool starts_with(string_view str) const {
+            return str.m_len <= m_len && memcmp(m_data, str.m_data, str.m_len) == 0;
+        }
+
+        /**
+         * Compare two views by character value, in the same
+         * order as @code strcmp @endcode.
+         *
+         * @param str view to compare against
+         * @return a signed number based on how the views compare
+         */
+        diff_type compare(string_view str) const {
+            int cmp = memcmp(m_data, str.m_data, MIN(m_len, str.m_len));
+            if (cmp != 0) {
+                return static_cast<diff_type>(cmp);
+            }
+            return m_len < str.m_len ? -1 : (m_len > str.m_len ? 1 : 0);
+        }
+
+    private:
+        const char *m_data;
+        size_type m_len;
+    };
+
+    inline bool operator==(string_view lhs, string_view rhs) {
+        return lhs.length() == rhs.length() && memcmp(lhs.data(), rhs.data(), lhs.length()) == 0;
+    }
+
+    inline bool operator!=(string_view lhs, string_view rhs) {
+        return !(lhs == rhs);
+    }
+
+    inline bool operator<(string_view lhs, string_view rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+    inline bool operator<=(string_view lhs, string_view rhs) {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    inline bool operator>(string_view lhs, string_view rhs) {
+        return lhs.compare(rhs) > 0;
+    }
+
+    inline bool operator>=(string_view lhs, string_view rhs) {
+        return lhs.compare(rhs) >= 0;
+    }
+
+}
+
+#endif //EMBEDDEDCPLUSPLUS_STRINGVIEW_H
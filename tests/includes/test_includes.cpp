@@ -1,30 +1,50 @@
 #include <wlib/array_heap>
 #include <wlib/array_list>
+#include <wlib/array_scan>
 #include <wlib/array2d>
+#include <wlib/binary_search>
 #include <wlib/bit_set>
+#include <wlib/btree>
+#include <wlib/btree_map>
+#include <wlib/btree_set>
 #include <wlib/comparator>
 #include <wlib/dynamic_string>
 #include <wlib/equals>
+#include <wlib/flat_map>
+#include <wlib/flat_set>
 #include <wlib/hash>
 #include <wlib/hash_map>
 #include <wlib/hash_set>
 #include <wlib/hash_table>
+#include <wlib/indexed_heap>
 #include <wlib/initializer_list>
+#include <wlib/intrusive_list>
+#include <wlib/intrusive_tree>
 #include <wlib/linked_list>
 #include <wlib/memory>
+#include <wlib/min_max_heap>
+#include <wlib/multi_queue>
+#include <wlib/node_pool>
 #include <wlib/open_map>
 #include <wlib/open_set>
 #include <wlib/open_table>
 #include <wlib/pair>
+#include <wlib/radix_sort>
 #include <wlib/shared_ptr>
+#include <wlib/sort>
+#include <wlib/spin_lock>
+#include <wlib/stable_vector>
 #include <wlib/static_string>
 #include <wlib/string>
+#include <wlib/string_view>
+#include <wlib/timing_wheel>
 #include <wlib/tree>
 #include <wlib/tree_map>
 #include <wlib/tree_set>
 #include <wlib/tuple>
 #include <wlib/type_traits>
 #include <wlib/unique_ptr>
+#include <wlib/unrolled_list>
 #include <wlib/utility>
 #include <wlib/vector2d>
 
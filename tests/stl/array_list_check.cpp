@@ -516,3 +516,60 @@ TEST(list_const_iterator_test, test_bulk_functions) {
     cit g9 = move(g8);
     ASSERT_EQ(list.begin(), g9);
 }
+
+TEST(array_list_test, test_growth_policies) {
+    ASSERT_EQ(8u, double_growth::grow<size_type>(4, 5));
+    ASSERT_EQ(1u, double_growth::grow<size_type>(0, 1));
+    ASSERT_EQ(6u, three_halves_growth::grow<size_type>(4, 5));
+    ASSERT_EQ(7u, three_halves_growth::grow<size_type>(5, 6));
+    ASSERT_EQ(2u, three_halves_growth::grow<size_type>(1, 2));
+    ASSERT_EQ(14u, fixed_growth<10>::grow<size_type>(4, 5));
+    ASSERT_EQ(16u, chunked_growth<16>::grow<size_type>(4, 5));
+    ASSERT_EQ(32u, chunked_growth<16>::grow<size_type>(16, 17));
+    ASSERT_EQ(32u, chunked_growth<16>::grow<size_type>(20, 21));
+}
+
+TEST(array_list_test, test_growth_policy_list) {
+    array_list<int, fixed_growth<3>> list(2);
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(list.push_back(i));
+    }
+    ASSERT_EQ(8u, list.capacity());
+    array_list<int, chunked_growth<4>> chunked(0);
+    ASSERT_TRUE(chunked.push_back(1));
+    ASSERT_EQ(4u, chunked.capacity());
+    const array_list<int, fixed_growth<3>> &const_list = list;
+    array_list<int, fixed_growth<3>>::const_iterator cit0 = const_list.begin();
+    for (int i = 0; i < 6; ++i, ++cit0) {
+        ASSERT_EQ(i, *cit0);
+    }
+    ASSERT_EQ(list.end(), list.find(10));
+}
+
+TEST(array_list_test, test_max_capacity) {
+    array_list<int> list(2);
+    list.set_max_capacity(5);
+    ASSERT_EQ(5u, list.max_capacity());
+    ASSERT_TRUE(list.push_back(1));
+    ASSERT_TRUE(list.push_back(2));
+    ASSERT_TRUE(list.push_back(3));
+    ASSERT_EQ(4u, list.capacity());
+    ASSERT_TRUE(list.push_front(0));
+    ASSERT_TRUE(list.push_back(4));
+    ASSERT_EQ(5u, list.capacity());
+    ASSERT_FALSE(list.push_back(5));
+    ASSERT_FALSE(list.push_front(-1));
+    ASSERT_EQ(list.end(), list.insert(2, 100));
+    ASSERT_EQ(list.end(), list.insert(list.begin(), 100));
+    ASSERT_EQ(5u, list.size());
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(i, list[static_cast<size_type>(i)]);
+    }
+    list.reserve(100);
+    ASSERT_EQ(5u, list.capacity());
+    list.pop_back();
+    ASSERT_TRUE(list.push_back(10));
+    array_list<int> moved(move(list));
+    ASSERT_EQ(5u, moved.max_capacity());
+    ASSERT_FALSE(moved.push_back(11));
+}
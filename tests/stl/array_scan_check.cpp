@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/ArrayScan.h>
+#include <wlib/stl/ArrayList.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+template<typename T>
+static void check_scans(size_t n) {
+    T data[80];
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = static_cast<T>((i * 7) % 13);
+    }
+    size_t expected_count = 0;
+    size_t expected_find = n;
+    T expected_sum = 0;
+    T expected_min = n > 0 ? data[0] : T();
+    T expected_max = expected_min;
+    for (size_t i = 0; i < n; ++i) {
+        if (data[i] == static_cast<T>(5)) {
+            ++expected_count;
+            if (expected_find == n) { expected_find = i; }
+        }
+        expected_sum = static_cast<T>(expected_sum + data[i]);
+        if (data[i] < expected_min) { expected_min = data[i]; }
+        if (expected_max < data[i]) { expected_max = data[i]; }
+    }
+    ASSERT_EQ(expected_find, scan_find(data, n, static_cast<T>(5)));
+    ASSERT_EQ(expected_count, scan_count(data, n, static_cast<T>(5)));
+    ASSERT_EQ(expected_find != n, scan_any_of(data, n, static_cast<T>(5)));
+    ASSERT_EQ(n, scan_find(data, n, static_cast<T>(20)));
+    ASSERT_FALSE(scan_any_of(data, n, static_cast<T>(20)));
+    ASSERT_EQ(expected_sum, scan_sum(data, n));
+    if (n > 0) {
+        ASSERT_EQ(expected_min, scan_min(data, n));
+        ASSERT_EQ(expected_max, scan_max(data, n));
+    }
+}
+
+template<typename T>
+static void check_all_lengths() {
+    for (size_t n = 0; n <= 80; ++n) {
+        check_scans<T>(n);
+    }
+}
+
+TEST(array_scan_test, test_scan_integers) {
+    check_all_lengths<char>();
+    check_all_lengths<int8_t>();
+    check_all_lengths<uint8_t>();
+    check_all_lengths<int16_t>();
+    check_all_lengths<uint16_t>();
+    check_all_lengths<int32_t>();
+    check_all_lengths<uint32_t>();
+    check_all_lengths<int64_t>();
+    check_all_lengths<uint64_t>();
+}
+
+TEST(array_scan_test, test_scan_floating_point) {
+    check_all_lengths<float>();
+    check_all_lengths<double>();
+}
+
+TEST(array_scan_test, test_scan_signed_extremes) {
+    int8_t bytes[40];
+    int32_t words[40];
+    int64_t longs[40];
+    for (int i = 0; i < 40; ++i) {
+        bytes[i] = 0;
+        words[i] = 0;
+        longs[i] = 0;
+    }
+    bytes[33] = -128;
+    bytes[17] = 127;
+    words[21] = -2147483647 - 1;
+    words[2] = 2147483647;
+    longs[39] = -1;
+    longs[5] = 1;
+    ASSERT_EQ(-128, scan_min(bytes, 40));
+    ASSERT_EQ(127, scan_max(bytes, 40));
+    ASSERT_EQ(-2147483647 - 1, scan_min(words, 40));
+    ASSERT_EQ(2147483647, scan_max(words, 40));
+    ASSERT_EQ(-1, scan_min(longs, 40));
+    ASSERT_EQ(1, scan_max(longs, 40));
+    ASSERT_EQ(33u, scan_find(bytes, 40, static_cast<int8_t>(-128)));
+    ASSERT_EQ(39u, scan_find(longs, 40, static_cast<int64_t>(-1)));
+}
+
+TEST(array_scan_test, test_scan_unsigned_extremes) {
+    uint8_t bytes[40];
+    uint16_t shorts[40];
+    uint32_t words[40];
+    for (int i = 0; i < 40; ++i) {
+        bytes[i] = 100;
+        shorts[i] = 1000;
+        words[i] = 100000;
+    }
+    bytes[35] = 255;
+    bytes[3] = 1;
+    shorts[18] = 65535;
+    words[31] = 4294967295u;
+    ASSERT_EQ(255, scan_max(bytes, 40));
+    ASSERT_EQ(1, scan_min(bytes, 40));
+    ASSERT_EQ(65535, scan_max(shorts, 40));
+    ASSERT_EQ(1000, scan_min(shorts, 40));
+    ASSERT_EQ(4294967295u, scan_max(words, 40));
+    ASSERT_EQ(100000u, scan_min(words, 40));
+}
+
+TEST(array_scan_test, test_scan_non_arithmetic) {
+    struct point {
+        int x;
+        int y;
+
+        bool operator==(const point &p) const { return x == p.x && y == p.y; }
+    };
+    point points[5] = {{0, 0}, {1, 2}, {3, 4}, {1, 2}, {5, 6}};
+    ASSERT_EQ(1u, scan_find(points, 5, point{1, 2}));
+    ASSERT_EQ(2u, scan_count(points, 5, point{1, 2}));
+    ASSERT_EQ(5u, scan_find(points, 5, point{9, 9}));
+}
+
+TEST(array_scan_test, test_array_list_index_of) {
+    array_list<int> list(64);
+    for (int i = 0; i < 50; ++i) {
+        list.push_back(i % 10);
+    }
+    ASSERT_EQ(7u, list.index_of(7));
+    ASSERT_EQ(50u, list.index_of(11));
+    ASSERT_EQ(5u, list.count(3));
+    ASSERT_EQ(0u, list.count(11));
+    ASSERT_EQ(7, *list.find(7));
+    ASSERT_EQ(list.end(), list.find(11));
+    array_list<int> empty;
+    ASSERT_EQ(0u, empty.index_of(1));
+    ASSERT_EQ(0u, empty.count(1));
+}
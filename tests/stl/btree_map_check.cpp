@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <wlib/stl/BTreeMap.h>
+#include <wlib/stl/BTreeSet.h>
+#include <wlib/stl/TreeMap.h>
+#include <wlib/strings/String.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef btree_map<int, int, comparator<int>, 32> small_map;
+
+template<typename Map>
+static void check_order(Map &map) {
+    size_t count = 0;
+    typename Map::iterator prev = map.end();
+    for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+        if (prev != map.end()) {
+            ASSERT_LT(prev.key(), it.key());
+        }
+        prev = it;
+        ++count;
+    }
+    ASSERT_EQ(map.size(), count);
+    typename Map::iterator it = map.end();
+    for (size_t i = 0; i < count; ++i) {
+        --it;
+    }
+    ASSERT_TRUE(it == map.begin());
+}
+
+TEST(btree_map_test, test_slots) {
+    ASSERT_EQ(3u, small_map::table_type::slots);
+    ASSERT_EQ(1u, (btree_map<int, int>::table_type::slots % 2));
+    ASSERT_LE(sizeof(btree_map<int, int>::table_type::node_type), 256u);
+}
+
+TEST(btree_map_test, test_insert_find) {
+    small_map map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.begin() == map.end());
+    ASSERT_TRUE(map.find(3) == map.end());
+    for (int i = 0; i < 200; ++i) {
+        int key = (i * 37) % 200;
+        ASSERT_TRUE(map.insert(key, key * 2).m_second);
+    }
+    ASSERT_FALSE(map.insert(10, 0).m_second);
+    ASSERT_EQ(20, map.at(10));
+    ASSERT_EQ(200u, map.size());
+    check_order(map);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(map.contains(i));
+        ASSERT_EQ(i * 2, *map.find(i));
+        ASSERT_EQ(i, map.find(i).key());
+    }
+    ASSERT_FALSE(map.contains(200));
+    ASSERT_FALSE(map.contains(-1));
+    small_map::iterator last = map.end();
+    ++last;
+    ASSERT_TRUE(last == map.end());
+    --last;
+    ASSERT_EQ(199, last.key());
+    int expected = 0;
+    for (int v : map) {
+        ASSERT_EQ(expected, v);
+        expected += 2;
+    }
+}
+
+TEST(btree_map_test, test_bounds) {
+    btree_map<int, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.insert(i * 10, i);
+    }
+    ASSERT_EQ(50, *map.lower_bound(495));
+    ASSERT_EQ(500, map.lower_bound(500).key());
+    ASSERT_EQ(510, map.upper_bound(500).key());
+    ASSERT_EQ(0, map.lower_bound(-5).key());
+    ASSERT_TRUE(map.lower_bound(9991) == map.end());
+    ASSERT_TRUE(map.upper_bound(9990) == map.end());
+    pair<btree_map<int, int>::iterator, btree_map<int, int>::iterator> range = map.equal_range(700);
+    ASSERT_EQ(70, *range.m_first);
+    ASSERT_EQ(71, *range.m_second);
+    range = map.equal_range(705);
+    ASSERT_TRUE(range.m_first == range.m_second);
+    const btree_map<int, int> &const_map = map;
+    ASSERT_EQ(20, *const_map.lower_bound(195));
+    ASSERT_EQ(3, const_map.at(30));
+}
+
+TEST(btree_map_test, test_erase) {
+    small_map map;
+    for (int i = 0; i < 300; ++i) {
+        map[i] = i;
+    }
+    small_map::iterator it = map.begin();
+    while (it != map.end()) {
+        if (it.key() % 3 != 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    ASSERT_EQ(100u, map.size());
+    check_order(map);
+    for (int i = 0; i < 300; ++i) {
+        ASSERT_EQ(i % 3 == 0, map.contains(i));
+    }
+    ASSERT_TRUE(map.erase(0));
+    ASSERT_FALSE(map.erase(0));
+    it = map.erase(map.find(297));
+    ASSERT_TRUE(it == map.end());
+    while (!map.empty()) {
+        map.erase(map.begin());
+        check_order(map);
+    }
+    ASSERT_TRUE(map.begin() == map.end());
+    map[5] = 6;
+    ASSERT_EQ(6, map.at(5));
+}
+
+TEST(btree_map_test, test_random_against_tree_map) {
+    srand(31);
+    small_map map;
+    tree_map<int, int> reference;
+    for (int step = 0; step < 20000; ++step) {
+        int key = rand() % 500;
+        if (rand() % 3 == 0) {
+            ASSERT_EQ(reference.erase(key), map.erase(key));
+        } else {
+            ASSERT_EQ(reference.insert(key, step).m_second, map.insert(key, step).m_second);
+        }
+    }
+    check_order(map);
+    ASSERT_EQ(reference.size(), map.size());
+    small_map::iterator it = map.begin();
+    for (tree_map<int, int>::iterator ref = reference.begin(); ref != reference.end(); ++ref, ++it) {
+        ASSERT_EQ(ref.key(), it.key());
+        ASSERT_EQ(*ref, *it);
+    }
+}
+
+TEST(btree_map_test, test_string_keys) {
+    typedef dynamic_string string;
+    btree_map<string, string, comparator<string>, 64> map;
+    char buf[16];
+    for (int i = 0; i < 100; ++i) {
+        snprintf(buf, sizeof(buf), "k%03d", i);
+        string key(buf);
+        string val(buf + 1);
+        map.insert(move(key), move(val));
+    }
+    ASSERT_EQ(100u, map.size());
+    ASSERT_STREQ("042", map.at(string("k042")).c_str());
+    auto ret = map.insert_or_assign(string("k042"), string("x"));
+    ASSERT_FALSE(ret.m_second);
+    ASSERT_STREQ("x", ret.m_first->c_str());
+    for (int i = 0; i < 100; i += 2) {
+        snprintf(buf, sizeof(buf), "k%03d", i);
+        ASSERT_TRUE(map.erase(string(buf)));
+    }
+    ASSERT_STREQ("k001", map.begin().key().c_str());
+    ASSERT_STREQ("099", (--map.end())->c_str());
+}
+
+TEST(btree_map_test, test_move) {
+    small_map map;
+    for (int i = 0; i < 50; ++i) {
+        map[i] = -i;
+    }
+    small_map moved(move(map));
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(50u, moved.size());
+    small_map assigned;
+    assigned[1] = 1;
+    assigned = move(moved);
+    ASSERT_EQ(-49, assigned.at(49));
+    ASSERT_TRUE(moved.begin() == moved.end());
+}
+
+TEST(btree_set_test, test_set) {
+    btree_set<int, comparator<int>, 32> set;
+    for (int i = 100; i > 0; --i) {
+        ASSERT_TRUE(set.insert(i).m_second);
+    }
+    ASSERT_FALSE(set.insert(50).m_second);
+    ASSERT_EQ(100u, set.size());
+    int expected = 1;
+    for (int v : set) {
+        ASSERT_EQ(expected++, v);
+    }
+    ASSERT_EQ(60, *set.upper_bound(59));
+    ASSERT_TRUE(set.erase(60));
+    ASSERT_EQ(61, *set.lower_bound(60));
+    ASSERT_EQ(61, *set.erase(set.find(59)));
+    ASSERT_EQ(98u, set.size());
+    set.clear();
+    ASSERT_TRUE(set.empty());
+}
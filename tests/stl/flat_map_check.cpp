@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <wlib/stl/BinarySearch.h>
+#include <wlib/stl/FlatMap.h>
+#include <wlib/stl/FlatSet.h>
+#include <wlib/stl/TreeMap.h>
+#include <wlib/strings/String.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+TEST(binary_search_test, test_bounds) {
+    int data[] = {1, 3, 3, 3, 5, 7, 9};
+    size_t n = sizeof(data) / sizeof(data[0]);
+    for (int key = 0; key <= 10; ++key) {
+        size_t lower = 0;
+        while (lower < n && data[lower] < key) {
+            ++lower;
+        }
+        size_t upper = lower;
+        while (upper < n && data[upper] == key) {
+            ++upper;
+        }
+        ASSERT_EQ(lower, lower_bound_index(data, n, key));
+        ASSERT_EQ(upper, upper_bound_index(data, n, key));
+    }
+    ASSERT_EQ(0u, lower_bound_index(data, 0, 4));
+    ASSERT_EQ(0u, upper_bound_index(data, 0, 4));
+    ASSERT_EQ(0u, lower_bound_index(data, 1, 1));
+    ASSERT_EQ(1u, upper_bound_index(data, 1, 1));
+}
+
+TEST(binary_search_test, test_reverse_comparator) {
+    int data[] = {9, 7, 5, 5, 1};
+    reverse_comparator<int> cmp;
+    ASSERT_EQ(2u, lower_bound_index(data, 5, 5, cmp));
+    ASSERT_EQ(4u, upper_bound_index(data, 5, 5, cmp));
+    ASSERT_EQ(5u, lower_bound_index(data, 5, 0, cmp));
+}
+
+TEST(flat_map_test, test_insert_find_erase) {
+    flat_map<int, int> map(4);
+    int keys[] = {50, 20, 80, 10, 30, 70, 90, 60, 40};
+    for (int key : keys) {
+        pair<flat_map<int, int>::iterator, bool> res = map.insert(key, key * 2);
+        ASSERT_TRUE(res.second());
+        ASSERT_EQ(key, res.first().key());
+        ASSERT_EQ(key * 2, *res.first());
+    }
+    ASSERT_FALSE(map.insert(30, 0).second());
+    ASSERT_EQ(9u, map.size());
+    int expected = 10;
+    for (flat_map<int, int>::iterator it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(expected, it.key());
+        ASSERT_EQ(expected * 2, *it);
+        expected += 10;
+    }
+    ASSERT_EQ(160, map.at(80));
+    ASSERT_TRUE(map.contains(40));
+    ASSERT_FALSE(map.contains(45));
+    ASSERT_TRUE(map.find(45) == map.end());
+
+    ASSERT_TRUE(map.erase(50));
+    ASSERT_FALSE(map.erase(50));
+    flat_map<int, int>::iterator it = map.erase(map.find(10));
+    ASSERT_EQ(20, it.key());
+    it = map.erase(map.find(90));
+    ASSERT_TRUE(it == map.end());
+    ASSERT_EQ(6u, map.size());
+
+    pair<flat_map<int, int>::iterator, bool> res = map.insert_or_assign(20, 7);
+    ASSERT_FALSE(res.second());
+    ASSERT_EQ(7, map[20]);
+    map[25] = 3;
+    ASSERT_EQ(7u, map.size());
+    ASSERT_EQ(25, map.nth(1).key());
+    ASSERT_EQ(3, *map.nth(1));
+}
+
+TEST(flat_map_test, test_bounds_and_positions) {
+    flat_map<int, int> map;
+    for (int i = 0; i < 100; i += 2) {
+        map.insert(i, i);
+    }
+    ASSERT_EQ(10, map.lower_bound(10).key());
+    ASSERT_EQ(12, map.lower_bound(11).key());
+    ASSERT_EQ(12, map.upper_bound(10).key());
+    ASSERT_TRUE(map.upper_bound(98) == map.end());
+    pair<flat_map<int, int>::iterator, flat_map<int, int>::iterator> range = map.equal_range(40);
+    ASSERT_EQ(1u, map.distance(range.first(), range.second()));
+    range = map.equal_range(41);
+    ASSERT_TRUE(range.first() == range.second());
+    for (size_t k = 0; k < map.size(); ++k) {
+        ASSERT_EQ(static_cast<int>(2 * k), map.nth(k).key());
+        ASSERT_EQ(k, map.rank(static_cast<int>(2 * k)));
+    }
+    ASSERT_TRUE(map.nth(map.size()) == map.end());
+    ASSERT_EQ(50u, map.rank(1000));
+    ASSERT_EQ(50u, map.distance(map.begin(), map.end()));
+    ASSERT_EQ(98, (map.end() - 1).key());
+    ASSERT_EQ(48, (map.begin() + 24).key());
+}
+
+TEST(flat_map_test, test_insert_sorted) {
+    flat_map<int, int> map;
+    for (int i = 0; i < 20; i += 4) {
+        map.insert(i, -i);
+    }
+    tuple<int, int> batch[] = {
+            make_tuple(-3, 3), make_tuple(0, 100), make_tuple(2, 2), make_tuple(2, 99),
+            make_tuple(5, 5), make_tuple(8, 100), make_tuple(9, 9), make_tuple(30, 30)
+    };
+    ASSERT_EQ(5u, map.insert_sorted(batch, batch + 8));
+    int expected_keys[] = {-3, 0, 2, 4, 5, 8, 9, 12, 16, 30};
+    int expected_vals[] = {3, 0, 2, -4, 5, -8, 9, -12, -16, 30};
+    ASSERT_EQ(10u, map.size());
+    size_t i = 0;
+    for (flat_map<int, int>::iterator it = map.begin(); it != map.end(); ++it, ++i) {
+        ASSERT_EQ(expected_keys[i], it.key());
+        ASSERT_EQ(expected_vals[i], *it);
+    }
+    ASSERT_EQ(0u, map.insert_sorted(batch, batch + 8));
+    ASSERT_EQ(0u, map.insert_sorted(batch, batch));
+}
+
+TEST(flat_map_test, test_insert_sorted_random) {
+    for (int round = 0; round < 20; ++round) {
+        flat_map<int, int> map;
+        tree_map<int, int> model;
+        for (int step = 0; step < 10; ++step) {
+            int count = rand() % 30;
+            tuple<int, int> batch[30];
+            int key = rand() % 10;
+            for (int j = 0; j < count; ++j) {
+                batch[j] = make_tuple(key, rand());
+                key += rand() % 8;
+            }
+            for (int j = 0; j < count; ++j) {
+                model.insert(get<0>(batch[j]), get<1>(batch[j]));
+            }
+            size_t before = map.size();
+            size_t inserted = map.insert_sorted(batch, batch + count);
+            ASSERT_EQ(before + inserted, map.size());
+            ASSERT_EQ(model.size(), map.size());
+            tree_map<int, int>::iterator expected = model.begin();
+            for (flat_map<int, int>::iterator it = map.begin(); it != map.end(); ++it, ++expected) {
+                ASSERT_EQ(expected.key(), it.key());
+                ASSERT_EQ(*expected, *it);
+            }
+        }
+    }
+}
+
+TEST(flat_map_test, test_construct_and_move) {
+    tuple<String16, int> sorted[] = {
+            make_tuple(String16("alpha"), 1), make_tuple(String16("beta"), 2),
+            make_tuple(String16("delta"), 4), make_tuple(String16("gamma"), 3)
+    };
+    flat_map<String16, int> map(sorted, sorted + 4);
+    ASSERT_EQ(4u, map.size());
+    ASSERT_EQ(4, map.at(String16("delta")));
+    ASSERT_EQ(4u, map.keys().size());
+    ASSERT_EQ(3, map.values().data()[3]);
+
+    flat_map<String16, int> moved(move(map));
+    ASSERT_EQ(4u, moved.size());
+    ASSERT_EQ(0u, map.size());
+    map = move(moved);
+    ASSERT_EQ(2, map.at(String16("beta")));
+    ASSERT_TRUE(map.assign_sorted(sorted, sorted + 2));
+    ASSERT_EQ(2u, map.size());
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(flat_set_test, test_set_operations) {
+    flat_set<int> set;
+    int keys[] = {5, 1, 9, 3, 7};
+    for (int key : keys) {
+        ASSERT_TRUE(set.insert(key).second());
+    }
+    ASSERT_FALSE(set.insert(3).second());
+    ASSERT_EQ(5u, set.size());
+    int expected = 1;
+    for (flat_set<int>::iterator it = set.begin(); it != set.end(); ++it) {
+        ASSERT_EQ(expected, *it);
+        expected += 2;
+    }
+    ASSERT_TRUE(set.contains(7));
+    ASSERT_FALSE(set.contains(8));
+    ASSERT_EQ(9, *set.lower_bound(8));
+    ASSERT_EQ(9, *set.upper_bound(7));
+    ASSERT_EQ(2u, set.rank(5));
+    ASSERT_EQ(7, *set.nth(3));
+    ASSERT_TRUE(set.nth(5) == set.end());
+
+    flat_set<int>::iterator it = set.erase(set.find(5));
+    ASSERT_EQ(7, *it);
+    ASSERT_TRUE(set.erase(1));
+    ASSERT_FALSE(set.erase(1));
+    ASSERT_EQ(3u, set.size());
+
+    int batch[] = {0, 2, 2, 3, 4, 9, 10};
+    ASSERT_EQ(4u, set.insert_sorted(batch, batch + 7));
+    int all[] = {0, 2, 3, 4, 7, 9, 10};
+    ASSERT_EQ(7u, set.size());
+    size_t i = 0;
+    for (flat_set<int>::iterator jt = set.begin(); jt != set.end(); ++jt, ++i) {
+        ASSERT_EQ(all[i], *jt);
+    }
+    flat_set<int> other(all, all + 7);
+    ASSERT_EQ(7u, other.size());
+    ASSERT_EQ(7u, other.distance(other.begin(), other.end()));
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <stdlib.h>
+
 #include <wlib/stl/ArrayHeap.h>
 
 #include "../template_defs.h"
@@ -158,3 +160,123 @@ TEST(heap_test, test_move_assignment_operator) {
     heap0.pop();
     ASSERT_EQ(0u, heap0.size());
 }
+
+TEST(heap_test, test_heap_push_full) {
+    array_heap<int> heap(2);
+    heap.get_array_list()->set_max_capacity(2);
+    ASSERT_TRUE(heap.push(1));
+    ASSERT_TRUE(heap.push(5));
+    ASSERT_FALSE(heap.push(10));
+    ASSERT_EQ(2u, heap.size());
+    ASSERT_EQ(5, heap.top());
+}
+
+template<typename Heap>
+static void check_d_ary_heap(Heap &heap) {
+    array_list<int> values(512);
+    for (int i = 0; i < 500; ++i) {
+        int value = rand() % 1000;
+        values.push_back(value);
+        ASSERT_TRUE(heap.push(value));
+    }
+    heap_sort(values);
+    for (size_t i = values.size(); i > 0; --i) {
+        ASSERT_EQ(values[i - 1], heap.top());
+        heap.pop();
+    }
+    ASSERT_TRUE(heap.empty());
+}
+
+TEST(heap_test, test_d_ary_heap_push_pop) {
+    array_heap<int, comparator<int>, 4> quaternary;
+    check_d_ary_heap(quaternary);
+    array_heap<int, comparator<int>, 8> octonary;
+    check_d_ary_heap(octonary);
+    array_heap<int, comparator<int>, 3> ternary;
+    check_d_ary_heap(ternary);
+}
+
+TEST(heap_test, test_d_ary_heap_reverse) {
+    array_heap<int, reverse_comparator<int>, 8> heap;
+    int values[] = {7, -3, 12, 0, 5, 5, -8, 20, 1};
+    for (int value : values) {
+        heap.push(value);
+    }
+    int expected[] = {-8, -3, 0, 1, 5, 5, 7, 12, 20};
+    for (int value : expected) {
+        ASSERT_EQ(value, heap.top());
+        heap.pop();
+    }
+}
+
+TEST(heap_test, test_d_ary_heap_functions) {
+    array_list<int> list(64);
+    for (int i = 0; i < 50; ++i) {
+        list.push_back((i * 37) % 50);
+    }
+    make_heap<4>(list.begin(), list.end());
+    ASSERT_EQ(49, list.front());
+    list.push_back(100);
+    push_heap<4>(list.begin(), list.end());
+    ASSERT_EQ(100, list.front());
+    pop_heap<4>(list.begin(), list.end());
+    ASSERT_EQ(100, list.back());
+    list.pop_back();
+    sort_heap<4>(list.begin(), list.end());
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQ(i, list[static_cast<size_t>(i)]);
+    }
+
+    reverse_comparator<int> cmp;
+    make_heap<8>(list.begin(), list.end(), cmp);
+    ASSERT_EQ(0, list.front());
+    pop_heap<8>(list.begin(), list.end(), cmp);
+    ASSERT_EQ(0, list.back());
+    ASSERT_EQ(1, list.front());
+    sort_heap<8>(list.begin(), list.end() - 1, cmp);
+    for (int i = 0; i < 49; ++i) {
+        ASSERT_EQ(49 - i, list[static_cast<size_t>(i)]);
+    }
+}
+
+TEST(heap_test, test_top_k) {
+    top_k<int> acc(5);
+    ASSERT_TRUE(acc.empty());
+    int values[] = {4, 17, -2, 9, 30, 1, 17, 8, 25, 3};
+    for (int value : values) {
+        acc.push(value);
+    }
+    ASSERT_TRUE(acc.full());
+    ASSERT_EQ(5u, acc.size());
+    ASSERT_EQ(9, acc.threshold());
+    ASSERT_FALSE(acc.push(9));
+    ASSERT_TRUE(acc.push(10));
+    ASSERT_EQ(10, acc.threshold());
+    array_list<int> sorted = acc.release_sorted();
+    int expected[] = {30, 25, 17, 17, 10};
+    ASSERT_EQ(5u, sorted.size());
+    for (size_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(expected[i], sorted[i]);
+    }
+    ASSERT_TRUE(acc.empty());
+    ASSERT_TRUE(acc.push(1));
+}
+
+TEST(heap_test, test_top_k_stream) {
+    top_k<int, reverse_comparator<int>> smallest(100);
+    array_list<int> all(5000);
+    for (int i = 0; i < 5000; ++i) {
+        int value = rand();
+        all.push_back(value);
+        smallest.push(value);
+    }
+    heap_sort(all);
+    array_list<int> sorted = smallest.release_sorted();
+    ASSERT_EQ(100u, sorted.size());
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(all[i], sorted[i]);
+    }
+    top_k<int> none(0);
+    ASSERT_FALSE(none.push(1));
+    ASSERT_TRUE(none.empty());
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <wlib/stl/IndexedHeap.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef indexed_heap<int> max_heap;
+typedef indexed_heap<int, reverse_comparator<int>, 4> min_heap;
+
+TEST(indexed_heap_test, test_push_pop) {
+    max_heap heap;
+    int values[] = {5, 10, 1, -1, 3, -5};
+    for (int value : values) {
+        ASSERT_NE(max_heap::null_handle, heap.push(value));
+    }
+    ASSERT_EQ(6u, heap.size());
+    int expected[] = {10, 5, 3, 1, -1, -5};
+    for (int value : expected) {
+        ASSERT_EQ(value, heap.top());
+        heap.pop();
+    }
+    ASSERT_TRUE(heap.empty());
+    ASSERT_EQ(max_heap::null_handle, heap.top_handle());
+    heap.pop();
+    ASSERT_TRUE(heap.empty());
+}
+
+TEST(indexed_heap_test, test_update_and_erase) {
+    min_heap heap;
+    min_heap::handle_type a = heap.push(50);
+    min_heap::handle_type b = heap.push(20);
+    min_heap::handle_type c = heap.push(30);
+    min_heap::handle_type d = heap.push(40);
+    ASSERT_EQ(b, heap.top_handle());
+    ASSERT_TRUE(heap.update(a, 10));
+    ASSERT_EQ(a, heap.top_handle());
+    ASSERT_EQ(10, heap.get(a));
+    ASSERT_TRUE(heap.update(a, 60));
+    ASSERT_EQ(b, heap.top_handle());
+    ASSERT_TRUE(heap.erase(b));
+    ASSERT_FALSE(heap.contains(b));
+    ASSERT_FALSE(heap.erase(b));
+    ASSERT_FALSE(heap.update(b, 0));
+    ASSERT_EQ(c, heap.top_handle());
+    heap.pop();
+    ASSERT_FALSE(heap.contains(c));
+    ASSERT_EQ(d, heap.top_handle());
+    ASSERT_TRUE(heap.contains(a));
+    ASSERT_EQ(2u, heap.size());
+    min_heap::handle_type e = heap.push(1);
+    ASSERT_TRUE(e == b || e == c);
+    ASSERT_EQ(1, heap.top());
+}
+
+TEST(indexed_heap_test, test_random_operations) {
+    min_heap heap;
+    const size_t n = 200;
+    int model[n];
+    bool present[n];
+    min_heap::handle_type handles[n];
+    for (size_t i = 0; i < n; ++i) {
+        model[i] = rand() % 1000;
+        handles[i] = heap.push(model[i]);
+        present[i] = true;
+    }
+    for (int step = 0; step < 2000; ++step) {
+        size_t i = static_cast<size_t>(rand()) % n;
+        int op = rand() % 3;
+        if (op == 0 && present[i]) {
+            model[i] = rand() % 1000;
+            ASSERT_TRUE(heap.update(handles[i], model[i]));
+        } else if (op == 1 && present[i]) {
+            ASSERT_TRUE(heap.erase(handles[i]));
+            present[i] = false;
+        } else if (!present[i]) {
+            model[i] = rand() % 1000;
+            handles[i] = heap.push(model[i]);
+            present[i] = true;
+        }
+        size_t count = 0;
+        int smallest = 1000;
+        for (size_t j = 0; j < n; ++j) {
+            if (present[j]) {
+                ++count;
+                ASSERT_EQ(model[j], heap.get(handles[j]));
+                if (model[j] < smallest) {
+                    smallest = model[j];
+                }
+            }
+        }
+        ASSERT_EQ(count, heap.size());
+        if (count) {
+            ASSERT_EQ(smallest, heap.top());
+        }
+    }
+    int prev = -1;
+    while (!heap.empty()) {
+        ASSERT_LE(prev, heap.top());
+        prev = heap.top();
+        heap.pop();
+    }
+}
+
+TEST(indexed_heap_test, test_full_and_move) {
+    max_heap heap(2);
+    ASSERT_NE(max_heap::null_handle, heap.push(1));
+    ASSERT_NE(max_heap::null_handle, heap.push(2));
+    max_heap moved(move(heap));
+    ASSERT_EQ(0u, heap.size());
+    ASSERT_EQ(2u, moved.size());
+    ASSERT_EQ(2, moved.top());
+    heap = move(moved);
+    ASSERT_EQ(2u, heap.size());
+    heap.clear();
+    ASSERT_TRUE(heap.empty());
+    ASSERT_EQ(0u, heap.push(7));
+}
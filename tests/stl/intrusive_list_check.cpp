@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/IntrusiveList.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+struct task {
+    int id;
+    intrusive_list_hook ready_hook;
+    intrusive_list_hook all_hook;
+
+    explicit task(int i) : id(i) {}
+};
+
+typedef intrusive_list<task, &task::ready_hook> ready_list;
+typedef intrusive_list<task, &task::all_hook> all_list;
+
+template
+class intrusive_list<task, &task::ready_hook>;
+
+template<typename List, size_t N>
+static void check_ids(const List &list, const int (&ids)[N]) {
+    ASSERT_EQ(N, list.size());
+    typename List::const_iterator it = list.begin();
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT_EQ(ids[i], it->id);
+        ++it;
+    }
+    ASSERT_TRUE(it == list.end());
+    for (size_t i = N; i > 0; --i) {
+        --it;
+        ASSERT_EQ(ids[i - 1], (*it).id);
+    }
+}
+
+TEST(intrusive_list_test, test_hook_offset) {
+    ptrdiff_t ready = __intrusive_offset<task, intrusive_list_hook, &task::ready_hook>();
+    ptrdiff_t all = __intrusive_offset<task, intrusive_list_hook, &task::all_hook>();
+    ASSERT_EQ(static_cast<ptrdiff_t>(offsetof(task, ready_hook)), ready);
+    ASSERT_EQ(static_cast<ptrdiff_t>(offsetof(task, all_hook)), all);
+    task t(3);
+    ASSERT_EQ(&t, (__intrusive_owner<task, intrusive_list_hook, &task::all_hook>(&t.all_hook)));
+}
+
+TEST(intrusive_list_test, test_push_pop) {
+    task a(1), b(2), c(3);
+    ready_list list;
+    ASSERT_TRUE(list.empty());
+    ASSERT_FALSE(a.ready_hook.is_linked());
+    list.push_back(a);
+    list.push_back(b);
+    list.push_front(c);
+    ASSERT_TRUE(a.ready_hook.is_linked());
+    const int expected1[] = {3, 1, 2};
+    check_ids(list, expected1);
+    ASSERT_EQ(3, list.front().id);
+    ASSERT_EQ(2, list.back().id);
+    list.pop_front();
+    ASSERT_FALSE(c.ready_hook.is_linked());
+    list.pop_back();
+    const int expected2[] = {1};
+    check_ids(list, expected2);
+    list.pop_back();
+    list.pop_back();
+    ASSERT_TRUE(list.empty());
+}
+
+TEST(intrusive_list_test, test_insert_erase) {
+    task a(1), b(2), c(3), d(4);
+    ready_list list;
+    list.push_back(a);
+    list.push_back(c);
+    ready_list::iterator it = list.insert(list.iterator_to(c), b);
+    ASSERT_EQ(2, it->id);
+    list.insert(list.end(), d);
+    const int expected3[] = {1, 2, 3, 4};
+    check_ids(list, expected3);
+    it = list.erase(list.iterator_to(b));
+    ASSERT_EQ(3, it->id);
+    ASSERT_FALSE(b.ready_hook.is_linked());
+    list.erase(d);
+    const int expected4[] = {1, 3};
+    check_ids(list, expected4);
+    ASSERT_TRUE(list.erase(list.end()) == list.end());
+}
+
+TEST(intrusive_list_test, test_multiple_lists) {
+    task tasks[] = {task(0), task(1), task(2), task(3), task(4)};
+    ready_list ready;
+    all_list all;
+    for (task &t : tasks) {
+        all.push_back(t);
+        if (t.id % 2 == 0) {
+            ready.push_front(t);
+        }
+    }
+    const int expected5[] = {0, 1, 2, 3, 4};
+    check_ids(all, expected5);
+    const int expected6[] = {4, 2, 0};
+    check_ids(ready, expected6);
+    ready.erase(tasks[2]);
+    const int expected7[] = {0, 1, 2, 3, 4};
+    check_ids(all, expected7);
+    const int expected8[] = {4, 0};
+    check_ids(ready, expected8);
+    all.clear();
+    ASSERT_FALSE(tasks[0].all_hook.is_linked());
+    ASSERT_TRUE(tasks[0].ready_hook.is_linked());
+    const int expected9[] = {4, 0};
+    check_ids(ready, expected9);
+}
+
+TEST(intrusive_list_test, test_move) {
+    task a(1), b(2);
+    ready_list list;
+    list.push_back(a);
+    list.push_back(b);
+    ready_list moved(move(list));
+    ASSERT_TRUE(list.empty());
+    const int expected10[] = {1, 2};
+    check_ids(moved, expected10);
+    ready_list assigned;
+    task c(3);
+    assigned.push_back(c);
+    assigned = move(moved);
+    ASSERT_FALSE(c.ready_hook.is_linked());
+    const int expected11[] = {1, 2};
+    check_ids(assigned, expected11);
+    ready_list empty;
+    assigned = move(empty);
+    ASSERT_TRUE(assigned.empty());
+    ASSERT_FALSE(a.ready_hook.is_linked());
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <wlib/stl/IntrusiveList.h>
+#include <wlib/stl/IntrusiveTree.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+struct connection {
+    int id;
+    int deadline;
+    intrusive_tree_hook by_id;
+    intrusive_tree_hook by_deadline;
+    intrusive_list_hook idle;
+
+    connection() : id(0), deadline(0) {}
+
+    connection(int i, int d) : id(i), deadline(d) {}
+};
+
+struct id_comparator {
+    bool __lt__(const connection &a, const connection &b) const { return a.id < b.id; }
+
+    bool __lt__(const connection &a, int id) const { return a.id < id; }
+
+    bool __lt__(int id, const connection &a) const { return id < a.id; }
+};
+
+struct deadline_comparator {
+    bool __lt__(const connection &a, const connection &b) const { return a.deadline < b.deadline; }
+};
+
+typedef intrusive_tree<connection, &connection::by_id, id_comparator> id_tree;
+typedef intrusive_tree<connection, &connection::by_deadline, deadline_comparator> deadline_tree;
+
+template
+class intrusive_tree<connection, &connection::by_id, id_comparator>;
+
+static int black_height(const intrusive_tree_hook *node) {
+    if (!node) {
+        return 1;
+    }
+    if (node->color() == RedBlackTreeColor::RED) {
+        if (node->m_left && node->m_left->color() == RedBlackTreeColor::RED) {
+            return -1;
+        }
+        if (node->m_right && node->m_right->color() == RedBlackTreeColor::RED) {
+            return -1;
+        }
+    }
+    if (node->m_left && node->m_left->parent() != node) {
+        return -1;
+    }
+    if (node->m_right && node->m_right->parent() != node) {
+        return -1;
+    }
+    int left = black_height(node->m_left);
+    int right = black_height(node->m_right);
+    if (left < 0 || left != right) {
+        return -1;
+    }
+    return left + (node->color() == RedBlackTreeColor::BLACK ? 1 : 0);
+}
+
+template<typename Tree>
+static void check_tree(Tree &tree) {
+    const intrusive_tree_hook *header = tree.end().m_node;
+    const intrusive_tree_hook *root = header->parent();
+    if (root) {
+        ASSERT_EQ(header, root->parent());
+        ASSERT_TRUE(root->color() == RedBlackTreeColor::BLACK);
+    }
+    ASSERT_GT(black_height(root), 0);
+    size_t count = 0;
+    for (typename Tree::iterator it = tree.begin(); it != tree.end(); ++it) {
+        ++count;
+    }
+    ASSERT_EQ(tree.size(), count);
+}
+
+TEST(intrusive_tree_test, test_insert_unique) {
+    connection conns[] = {connection(5, 0), connection(2, 0), connection(8, 0), connection(2, 1)};
+    id_tree tree;
+    ASSERT_TRUE(tree.begin() == tree.end());
+    ASSERT_TRUE(tree.insert_unique(conns[0]).m_second);
+    ASSERT_TRUE(tree.insert_unique(conns[1]).m_second);
+    ASSERT_TRUE(tree.insert_unique(conns[2]).m_second);
+    pair<id_tree::iterator, bool> res = tree.insert_unique(conns[3]);
+    ASSERT_FALSE(res.m_second);
+    ASSERT_EQ(&conns[1], &*res.m_first);
+    ASSERT_FALSE(conns[3].by_id.is_linked());
+    ASSERT_EQ(3u, tree.size());
+    id_tree::iterator it = tree.begin();
+    ASSERT_EQ(2, (it++)->id);
+    ASSERT_EQ(5, (it++)->id);
+    ASSERT_EQ(8, (it++)->id);
+    ASSERT_TRUE(it == tree.end());
+    --it;
+    ASSERT_EQ(8, it->id);
+    check_tree(tree);
+}
+
+TEST(intrusive_tree_test, test_find_by_key) {
+    connection conns[10];
+    id_tree tree;
+    for (int i = 0; i < 10; ++i) {
+        conns[i] = connection(i * 10, 0);
+        tree.insert_unique(conns[i]);
+    }
+    ASSERT_EQ(&conns[3], &*tree.find(30));
+    ASSERT_TRUE(tree.find(35) == tree.end());
+    ASSERT_EQ(40, tree.lower_bound(35)->id);
+    ASSERT_EQ(40, tree.upper_bound(30)->id);
+    ASSERT_TRUE(tree.lower_bound(100) == tree.end());
+    ASSERT_EQ(1u, tree.count(90));
+    ASSERT_EQ(0u, tree.count(91));
+    const id_tree &const_tree = tree;
+    ASSERT_EQ(50, const_tree.find(50)->id);
+    ASSERT_TRUE(const_tree.find(51) == const_tree.end());
+}
+
+TEST(intrusive_tree_test, test_insert_equal) {
+    connection conns[6] = {
+        connection(0, 3), connection(1, 1), connection(2, 3),
+        connection(3, 2), connection(4, 3), connection(5, 1)
+    };
+    deadline_tree tree;
+    for (connection &c : conns) {
+        tree.insert_equal(c);
+    }
+    check_tree(tree);
+    int expected[] = {1, 5, 3, 0, 2, 4};
+    int i = 0;
+    for (deadline_tree::iterator it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQ(expected[i++], it->id);
+    }
+    ASSERT_EQ(3u, tree.count(conns[0]));
+    pair<deadline_tree::iterator, deadline_tree::iterator> range = tree.equal_range(conns[1]);
+    ASSERT_EQ(1, range.m_first->id);
+    ASSERT_EQ(3, range.m_second->id);
+}
+
+TEST(intrusive_tree_test, test_random_insert_erase) {
+    srand(21);
+    const int n = 500;
+    connection conns[n];
+    id_tree tree;
+    for (int i = 0; i < n; ++i) {
+        conns[i] = connection(rand() % 2000, 0);
+        tree.insert_equal(conns[i]);
+    }
+    check_tree(tree);
+    for (int i = 0; i < n; i += 2) {
+        tree.erase(conns[i]);
+        ASSERT_FALSE(conns[i].by_id.is_linked());
+    }
+    check_tree(tree);
+    ASSERT_EQ(static_cast<size_t>(n / 2), tree.size());
+    int prev = -1;
+    for (id_tree::iterator it = tree.begin(); it != tree.end();) {
+        ASSERT_LE(prev, it->id);
+        prev = it->id;
+        if (prev % 3 == 0) {
+            it = tree.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    check_tree(tree);
+    for (int i = 0; i < n; i += 2) {
+        tree.insert_equal(conns[i]);
+    }
+    check_tree(tree);
+}
+
+TEST(intrusive_tree_test, test_multiple_containers) {
+    connection conns[4] = {connection(1, 40), connection(2, 10), connection(3, 30), connection(4, 20)};
+    id_tree ids;
+    deadline_tree deadlines;
+    intrusive_list<connection, &connection::idle> idle;
+    for (connection &c : conns) {
+        ids.insert_unique(c);
+        deadlines.insert_equal(c);
+        if (c.id % 2 == 1) {
+            idle.push_back(c);
+        }
+    }
+    ASSERT_EQ(2, deadlines.begin()->id);
+    ASSERT_EQ(&conns[1], &*ids.find(2));
+    connection &expired = *deadlines.begin();
+    deadlines.erase(deadlines.begin());
+    ids.erase(expired);
+    ASSERT_FALSE(expired.by_id.is_linked());
+    ASSERT_EQ(3u, ids.size());
+    ASSERT_EQ(4, deadlines.begin()->id);
+    ASSERT_EQ(1, idle.front().id);
+    check_tree(ids);
+    check_tree(deadlines);
+    ids.clear();
+    for (connection &c : conns) {
+        ASSERT_FALSE(c.by_id.is_linked());
+    }
+    ASSERT_EQ(3u, deadlines.size());
+    ASSERT_EQ(2u, idle.size());
+}
+
+TEST(intrusive_tree_test, test_move) {
+    connection conns[5];
+    id_tree tree;
+    for (int i = 0; i < 5; ++i) {
+        conns[i] = connection(i, 0);
+        tree.insert_unique(conns[i]);
+    }
+    id_tree moved(move(tree));
+    ASSERT_TRUE(tree.empty());
+    ASSERT_TRUE(tree.begin() == tree.end());
+    ASSERT_EQ(5u, moved.size());
+    check_tree(moved);
+    ASSERT_EQ(0, moved.begin()->id);
+    ASSERT_EQ(4, (--moved.end())->id);
+    id_tree assigned;
+    assigned = move(moved);
+    check_tree(assigned);
+    ASSERT_EQ(&conns[2], &*assigned.find(2));
+    assigned = id_tree();
+    ASSERT_TRUE(assigned.empty());
+    ASSERT_FALSE(conns[0].by_id.is_linked());
+}
@@ -203,3 +203,193 @@ TEST(linked_list_test, test_find) {
     ASSERT_EQ(1, *list.find(1));
     ASSERT_EQ(list.begin(), list.find(1));
 }
+
+static void check_links(const linked_list<int> &list) {
+    size_t count = 0;
+    const LinkedListNode<int> *prev = nullptr;
+    for (lli_cit it = list.begin(); it != list.end(); ++it) {
+        ASSERT_EQ(prev, it.m_current->m_prev);
+        prev = it.m_current;
+        ++count;
+    }
+    ASSERT_EQ(list.size(), count);
+    if (count > 0) {
+        ASSERT_EQ(list.back(), prev->m_val);
+    }
+}
+
+TEST(linked_list_test, test_sort) {
+    linked_list<int> list;
+    list.sort();
+    ASSERT_EQ(0u, list.size());
+    int values[] = {5, -3, 9, 0, 5, 12, -3, 7, 1, 1, 8};
+    for (int v : values) {
+        list.push_back(v);
+    }
+    list.sort();
+    int sorted[] = {-3, -3, 0, 1, 1, 5, 5, 7, 8, 9, 12};
+    size_t i = 0;
+    for (lli_it it = list.begin(); it != list.end(); ++it) {
+        ASSERT_EQ(sorted[i++], *it);
+    }
+    check_links(list);
+    list.sort(reverse_comparator<int>());
+    ASSERT_EQ(12, list.front());
+    ASSERT_EQ(-3, list.back());
+    check_links(list);
+}
+
+TEST(linked_list_test, test_sort_large) {
+    linked_list<int> list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back((i * 7919) % 1009);
+    }
+    list.sort();
+    int prev = -1;
+    for (lli_it it = list.begin(); it != list.end(); ++it) {
+        ASSERT_LE(prev, *it);
+        prev = *it;
+    }
+    check_links(list);
+}
+
+struct keyed {
+    int key;
+    int order;
+};
+
+struct keyed_comparator {
+    bool __lt__(const keyed &a, const keyed &b) const { return a.key < b.key; }
+};
+
+TEST(linked_list_test, test_sort_stable) {
+    linked_list<keyed> list;
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(keyed{(i * 37) % 5, i});
+    }
+    list.sort(keyed_comparator());
+    keyed prev = {-1, -1};
+    for (linked_list<keyed>::iterator it = list.begin(); it != list.end(); ++it) {
+        ASSERT_LE(prev.key, it->key);
+        if (prev.key == it->key) {
+            ASSERT_LT(prev.order, it->order);
+        }
+        prev = *it;
+    }
+}
+
+TEST(linked_list_test, test_merge) {
+    linked_list<int> a;
+    linked_list<int> b;
+    int va[] = {1, 3, 5, 7};
+    int vb[] = {0, 2, 3, 8, 9};
+    for (int v : va) { a.push_back(v); }
+    for (int v : vb) { b.push_back(v); }
+    LinkedListNode<int> *three = a.find(3).m_current;
+    ASSERT_TRUE(a.merge(b));
+    ASSERT_EQ(9u, a.size());
+    ASSERT_EQ(0u, b.size());
+    ASSERT_EQ(b.begin(), b.end());
+    int merged[] = {0, 1, 2, 3, 3, 5, 7, 8, 9};
+    size_t i = 0;
+    for (lli_it it = a.begin(); it != a.end(); ++it) {
+        ASSERT_EQ(merged[i++], *it);
+    }
+    ASSERT_EQ(three, a.find(3).m_current);
+    check_links(a);
+    ASSERT_TRUE(a.merge(a));
+    ASSERT_EQ(9u, a.size());
+    linked_list<int> empty;
+    ASSERT_TRUE(empty.merge(a));
+    ASSERT_EQ(9u, empty.size());
+    check_links(empty);
+}
+
+TEST(linked_list_test, test_splice) {
+    linked_list<int> a;
+    linked_list<int> b;
+    for (int i = 0; i < 3; ++i) { a.push_back(i); }
+    for (int i = 10; i < 13; ++i) { b.push_back(i); }
+    ASSERT_TRUE(a.splice(a.find(1), b));
+    ASSERT_EQ(0u, b.size());
+    ASSERT_EQ(6u, a.size());
+    int spliced[] = {0, 10, 11, 12, 1, 2};
+    size_t i = 0;
+    for (lli_it it = a.begin(); it != a.end(); ++it) {
+        ASSERT_EQ(spliced[i++], *it);
+    }
+    check_links(a);
+    a.splice(a.end(), a, a.begin());
+    ASSERT_EQ(10, a.front());
+    ASSERT_EQ(0, a.back());
+    check_links(a);
+    ASSERT_TRUE(b.splice(b.end(), a, a.find(12)));
+    ASSERT_FALSE(b.splice(b.end(), a, a.end()));
+    ASSERT_EQ(5u, a.size());
+    ASSERT_EQ(1u, b.size());
+    ASSERT_EQ(12, b.front());
+    check_links(a);
+    check_links(b);
+    b.splice(b.begin(), a);
+    ASSERT_EQ(0u, a.size());
+    ASSERT_EQ(6u, b.size());
+    ASSERT_EQ(12, b.back());
+    check_links(b);
+}
+
+TEST(linked_list_test, test_node_pool) {
+    linked_list<int>::pool_type pool;
+    linked_list<int> list(&pool);
+    ASSERT_EQ(&pool, list.pool());
+    for (int i = 0; i < 20; ++i) {
+        list.push_back(i);
+    }
+    size_t capacity = pool.capacity();
+    ASSERT_EQ(20u, pool.in_use());
+    for (int i = 0; i < 10; ++i) {
+        list.pop_front();
+    }
+    ASSERT_EQ(10u, pool.in_use());
+    for (int i = 0; i < 10; ++i) {
+        list.push_back(i);
+        list.pop_front();
+    }
+    ASSERT_EQ(capacity, pool.capacity());
+    list.insert(list.begin(), 100);
+    list.erase(list.begin());
+    ASSERT_EQ(10u, list.size());
+    ASSERT_EQ(0, list.front());
+    check_links(list);
+    list.clear();
+    ASSERT_EQ(0u, pool.in_use());
+    ASSERT_TRUE(pool.release());
+    list.push_back(5);
+    ASSERT_EQ(5, list.front());
+}
+
+TEST(linked_list_test, test_shared_node_pool) {
+    linked_list<int>::pool_type pool;
+    linked_list<int> a(&pool);
+    linked_list<int> b(&pool);
+    for (int i = 0; i < 5; ++i) {
+        a.push_back(i);
+        b.push_back(i + 10);
+    }
+    ASSERT_EQ(10u, pool.in_use());
+    ASSERT_TRUE(a.splice(a.end(), b));
+    ASSERT_EQ(10u, a.size());
+    linked_list<int> plain;
+    plain.push_back(1);
+    ASSERT_FALSE(a.splice(a.end(), plain));
+    ASSERT_FALSE(a.splice(a.end(), plain, plain.begin()));
+    ASSERT_FALSE(plain.merge(a));
+    ASSERT_EQ(10u, a.size());
+    ASSERT_EQ(1u, plain.size());
+    linked_list<int> moved(move(a));
+    ASSERT_EQ(&pool, moved.pool());
+    moved.sort(reverse_comparator<int>());
+    ASSERT_EQ(14, moved.front());
+    check_links(moved);
+    moved.clear();
+    ASSERT_EQ(0u, pool.in_use());
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <wlib/stl/MinMaxHeap.h>
+#include <wlib/stl/Sort.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+TEST(min_max_heap_test, test_push_pop_both_ends) {
+    min_max_heap<int> heap;
+    ASSERT_TRUE(heap.empty());
+    int values[] = {5, 10, 1, -1, 3, -5, 7, 12, 0};
+    for (int v : values) {
+        ASSERT_TRUE(heap.push(v));
+    }
+    ASSERT_EQ(9u, heap.size());
+    ASSERT_EQ(-5, heap.min());
+    ASSERT_EQ(12, heap.max());
+    heap.pop_max();
+    ASSERT_EQ(10, heap.max());
+    heap.pop_min();
+    ASSERT_EQ(-1, heap.min());
+    heap.pop_max();
+    heap.pop_max();
+    ASSERT_EQ(5, heap.max());
+    ASSERT_EQ(-1, heap.min());
+    heap.pop_min();
+    heap.pop_min();
+    heap.pop_min();
+    ASSERT_EQ(2u, heap.size());
+    ASSERT_EQ(3, heap.min());
+    ASSERT_EQ(5, heap.max());
+    heap.pop_min();
+    ASSERT_EQ(5, heap.min());
+    ASSERT_EQ(5, heap.max());
+    heap.pop_max();
+    ASSERT_TRUE(heap.empty());
+    heap.pop_max();
+    heap.pop_min();
+    ASSERT_TRUE(heap.empty());
+}
+
+TEST(min_max_heap_test, test_random_against_sorted) {
+    min_max_heap<int> heap;
+    array_list<int> sorted;
+    const int n = 500;
+    for (int i = 0; i < n; ++i) {
+        int v = rand() % 200;
+        heap.push(v);
+        sorted.push_back(v);
+    }
+    intro_sort(sorted.begin(), sorted.end());
+    size_t lo = 0;
+    size_t hi = sorted.size();
+    while (lo < hi) {
+        ASSERT_EQ(sorted[lo], heap.min());
+        ASSERT_EQ(sorted[hi - 1], heap.max());
+        if (rand() % 2) {
+            heap.pop_min();
+            ++lo;
+        } else {
+            heap.pop_max();
+            --hi;
+        }
+        ASSERT_EQ(hi - lo, heap.size());
+    }
+    ASSERT_TRUE(heap.empty());
+}
+
+TEST(min_max_heap_test, test_bounded_buffer) {
+    // evict the lowest priority when full, serve the highest
+    min_max_heap<int> heap;
+    const size_t bound = 16;
+    for (int i = 0; i < 200; ++i) {
+        int priority = rand() % 1000;
+        if (heap.size() == bound) {
+            if (priority <= heap.min()) {
+                continue;
+            }
+            heap.pop_min();
+        }
+        heap.push(priority);
+        if (i % 5 == 0) {
+            int top = heap.max();
+            heap.pop_max();
+            ASSERT_TRUE(heap.empty() || heap.max() <= top);
+        }
+    }
+    ASSERT_LE(heap.size(), bound);
+}
+
+TEST(min_max_heap_test, test_reverse_comparator) {
+    min_max_heap<int, reverse_comparator<int>> heap;
+    for (int i = 0; i < 20; ++i) {
+        heap.push(i);
+    }
+    ASSERT_EQ(19, heap.min());
+    ASSERT_EQ(0, heap.max());
+    heap.pop_min();
+    heap.pop_max();
+    ASSERT_EQ(18, heap.min());
+    ASSERT_EQ(1, heap.max());
+}
+
+TEST(min_max_heap_test, test_iterator_functions) {
+    array_list<int> list;
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(rand() % 1000);
+    }
+    make_min_max_heap(list.begin(), list.end());
+    array_list<int> sorted;
+    for (size_t n = list.size(); n > 0; --n) {
+        int lo = list[0];
+        for (size_t i = 1; i < n; ++i) {
+            ASSERT_LE(lo, list[i]);
+        }
+        pop_min_max_heap_min(list.begin(), list.begin() + n);
+        ASSERT_EQ(lo, list[n - 1]);
+        sorted.push_back(lo);
+    }
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        ASSERT_LE(sorted[i - 1], sorted[i]);
+    }
+
+    list.clear();
+    for (int i = 0; i < 50; ++i) {
+        list.push_back(rand() % 100);
+        push_min_max_heap(list.begin(), list.end());
+    }
+    int last = 100;
+    for (size_t n = list.size(); n > 0; --n) {
+        pop_min_max_heap_max(list.begin(), list.begin() + n, comparator<int>());
+        ASSERT_GE(last, list[n - 1]);
+        last = list[n - 1];
+    }
+}
+
+TEST(min_max_heap_test, test_move) {
+    min_max_heap<int> heap;
+    heap.push(4);
+    heap.push(8);
+    heap.push(2);
+    min_max_heap<int> moved(move(heap));
+    ASSERT_EQ(3u, moved.size());
+    ASSERT_EQ(2, moved.min());
+    ASSERT_EQ(8, moved.max());
+    min_max_heap<int> assigned;
+    assigned = move(moved);
+    ASSERT_EQ(8, assigned.max());
+    assigned.clear();
+    ASSERT_TRUE(assigned.empty());
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <thread>
+
+#include <wlib/stl/MultiQueue.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+TEST(multi_queue_test, test_spin_lock) {
+    spin_lock lock;
+    ASSERT_TRUE(lock.try_lock());
+    ASSERT_FALSE(lock.try_lock());
+    lock.unlock();
+    lock.lock();
+    ASSERT_FALSE(lock.try_lock());
+    lock.unlock();
+    ASSERT_TRUE(lock.try_lock());
+    lock.unlock();
+}
+
+TEST(multi_queue_test, test_two_shards_exact_order) {
+    // with two shards every pop compares both tops
+    multi_queue<int, comparator<int>, 2, null_lock> queue;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.push((i * 37) % 100));
+    }
+    ASSERT_EQ(100u, queue.size());
+    int value;
+    for (int expected = 99; expected >= 0; --expected) {
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(expected, value);
+    }
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.pop(value));
+}
+
+TEST(multi_queue_test, test_empty_shards) {
+    typedef multi_queue<int, comparator<int>, 4, null_lock> queue_type;
+    ASSERT_EQ(0u, sizeof(queue_type::shard_type) % WLIB_CACHE_LINE_SIZE);
+    ASSERT_LT(alignof(queue_type), static_cast<size_t>(WLIB_CACHE_LINE_SIZE));
+    queue_type queue;
+    queue_type::random_state state = 99;
+    int value;
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.pop(value, state));
+    // a lone element is found even when samples miss its shard
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(queue.push(i, state));
+        ASSERT_EQ(1u, queue.size());
+        ASSERT_FALSE(queue.empty());
+        ASSERT_TRUE(queue.pop(value, state));
+        ASSERT_EQ(i, value);
+        ASSERT_TRUE(queue.empty());
+        ASSERT_FALSE(queue.pop(value, state));
+    }
+}
+
+TEST(multi_queue_test, test_relaxed_order) {
+    multi_queue<int> queue;
+    multi_queue<int>::random_state state = 12345;
+    const int n = 1000;
+    for (int i = 0; i < n; ++i) {
+        queue.push(i, state);
+    }
+    ASSERT_EQ(static_cast<size_t>(n), queue.size());
+    bool seen[n] = {false};
+    int value;
+    int first = -1;
+    for (int i = 0; i < n; ++i) {
+        ASSERT_TRUE(queue.pop(value, state));
+        ASSERT_FALSE(seen[value]);
+        seen[value] = true;
+        if (first < 0) {
+            first = value;
+        }
+    }
+    // the first pop is the top of some shard
+    ASSERT_GE(first, n - 100);
+    ASSERT_FALSE(queue.pop(value, state));
+    queue.push(3);
+    queue.push(4);
+    queue.clear();
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(multi_queue_test, test_concurrent_push_pop) {
+    typedef multi_queue<int, comparator<int>, 16> queue_type;
+    queue_type queue;
+    const int threads = 4;
+    const int per_thread = 2000;
+    static bool popped[threads * per_thread];
+    int counts[threads] = {0};
+    std::thread workers[threads];
+    for (int t = 0; t < threads; ++t) {
+        workers[t] = std::thread([&queue, &counts, t]() {
+            queue_type::random_state state = static_cast<queue_type::random_state>(t + 1);
+            int value;
+            for (int i = 0; i < per_thread; ++i) {
+                queue.push(t * per_thread + i, state);
+                if (i % 2 && queue.pop(value, state)) {
+                    popped[value] = true;
+                    ++counts[t];
+                }
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    int total = 0;
+    for (int count : counts) {
+        total += count;
+    }
+    int value;
+    while (queue.pop(value)) {
+        ASSERT_FALSE(popped[value]);
+        popped[value] = true;
+        ++total;
+    }
+    ASSERT_EQ(threads * per_thread, total);
+    for (bool p : popped) {
+        ASSERT_TRUE(p);
+    }
+}
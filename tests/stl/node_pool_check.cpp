@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/NodePool.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+struct pool_node {
+    pool_node *m_link;
+    int m_val;
+};
+
+typedef node_pool<pool_node, &pool_node::m_link, 4> small_pool;
+
+TEST(node_pool_test, test_allocate_in_blocks) {
+    small_pool pool;
+    ASSERT_EQ(0u, pool.capacity());
+    ASSERT_EQ(0u, pool.blocks());
+    pool_node *nodes[9];
+    for (int i = 0; i < 9; ++i) {
+        nodes[i] = pool.allocate();
+        ASSERT_NE(nullptr, nodes[i]);
+        nodes[i]->m_val = i;
+    }
+    ASSERT_EQ(3u, pool.blocks());
+    ASSERT_EQ(12u, pool.capacity());
+    ASSERT_EQ(3u, pool.available());
+    ASSERT_EQ(9u, pool.in_use());
+    for (int i = 0; i < 9; ++i) {
+        ASSERT_EQ(i, nodes[i]->m_val);
+    }
+}
+
+TEST(node_pool_test, test_reuse) {
+    small_pool pool;
+    pool_node *a = pool.allocate();
+    pool_node *b = pool.allocate();
+    pool.deallocate(a);
+    ASSERT_EQ(a, pool.allocate());
+    pool.deallocate(b);
+    pool.deallocate(a);
+    ASSERT_EQ(4u, pool.available());
+    ASSERT_EQ(a, pool.allocate());
+    ASSERT_EQ(b, pool.allocate());
+    ASSERT_EQ(1u, pool.blocks());
+}
+
+TEST(node_pool_test, test_deallocate_chain_and_release) {
+    small_pool pool;
+    pool_node *nodes[6];
+    for (int i = 0; i < 6; ++i) {
+        nodes[i] = pool.allocate();
+    }
+    ASSERT_FALSE(pool.release());
+    for (int i = 0; i < 5; ++i) {
+        nodes[i]->m_link = nodes[i + 1];
+    }
+    pool.deallocate(nodes[0], nodes[5], 6);
+    ASSERT_EQ(0u, pool.in_use());
+    ASSERT_EQ(nodes[0], pool.allocate());
+    pool.deallocate(nodes[0]);
+    ASSERT_TRUE(pool.release());
+    ASSERT_EQ(0u, pool.capacity());
+    ASSERT_NE(nullptr, pool.allocate());
+    ASSERT_EQ(1u, pool.blocks());
+}
+
+TEST(node_pool_test, test_move) {
+    small_pool pool;
+    pool_node *node = pool.allocate();
+    small_pool moved(move(pool));
+    ASSERT_EQ(0u, pool.capacity());
+    ASSERT_EQ(1u, moved.in_use());
+    moved.deallocate(node);
+    ASSERT_EQ(node, moved.allocate());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <wlib/stl/RadixSort.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+template<typename T>
+static void check_sorted(const T *data, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        ASSERT_FALSE(data[i] < data[i - 1]);
+    }
+}
+
+TEST(radix_sort_test, test_unsigned) {
+    srand(1);
+    uint32_t data[1000];
+    uint64_t sum = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        data[i] = static_cast<uint32_t>(rand()) * 2654435761u;
+        sum += data[i];
+    }
+    ASSERT_TRUE(radix_sort(data, data + 1000));
+    check_sorted(data, 1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        sum -= data[i];
+    }
+    ASSERT_EQ(0u, sum);
+}
+
+TEST(radix_sort_test, test_signed) {
+    int16_t shorts[] = {5, -32768, 32767, 0, -1, 1, -300, 300, -1};
+    ASSERT_TRUE(radix_sort(shorts, shorts + 9));
+    check_sorted(shorts, 9);
+    ASSERT_EQ(-32768, shorts[0]);
+    ASSERT_EQ(32767, shorts[8]);
+    int64_t longs[] = {5, -5, 1LL << 40, -(1LL << 40), 0, 7};
+    ASSERT_TRUE(radix_sort(longs, longs + 6));
+    check_sorted(longs, 6);
+    int8_t bytes[] = {-128, 127, 0, -1, 1};
+    ASSERT_TRUE(radix_sort(bytes, bytes + 5));
+    check_sorted(bytes, 5);
+}
+
+TEST(radix_sort_test, test_floating_point) {
+    float floats[] = {3.5f, -0.25f, 0.0f, -100.0f, 1e-30f, -1e30f, 42.0f, -0.0f, 2.0f};
+    ASSERT_TRUE(radix_sort(floats, floats + 9));
+    check_sorted(floats, 9);
+    ASSERT_EQ(-1e30f, floats[0]);
+    ASSERT_EQ(42.0f, floats[8]);
+    double doubles[] = {1.5, -2.5, 0.0, 1e300, -1e-300, 3.0};
+    ASSERT_TRUE(radix_sort(doubles, doubles + 6));
+    check_sorted(doubles, 6);
+}
+
+TEST(radix_sort_test, test_static_string_prefix) {
+    array_list<static_string<16>> list;
+    const char *words[] = {"pear", "apple", "", "fig", "kiwi", "banana", "apricot", "ap"};
+    for (const char *w : words) {
+        list.push_back(static_string<16>(w));
+    }
+    ASSERT_TRUE(radix_sort(list));
+    ASSERT_STREQ("", list[0].c_str());
+    ASSERT_STREQ("ap", list[1].c_str());
+    ASSERT_STREQ("apple", list[2].c_str());
+    ASSERT_STREQ("apricot", list[3].c_str());
+    ASSERT_STREQ("banana", list[4].c_str());
+    ASSERT_STREQ("pear", list[7].c_str());
+}
+
+struct event {
+    uint32_t timestamp;
+    int id;
+};
+
+struct event_key {
+    typedef uint32_t key_type;
+
+    key_type operator()(const event &e) const {
+        return e.timestamp;
+    }
+};
+
+TEST(radix_sort_test, test_key_functor_stable) {
+    array_list<event> list;
+    for (int i = 0; i < 200; ++i) {
+        list.push_back(event{static_cast<uint32_t>((i * 31) % 7) << 20, i});
+    }
+    ASSERT_TRUE(radix_sort(list, event_key()));
+    for (size_t i = 1; i < list.size(); ++i) {
+        ASSERT_LE(list[i - 1].timestamp, list[i].timestamp);
+        if (list[i - 1].timestamp == list[i].timestamp) {
+            ASSERT_LT(list[i - 1].id, list[i].id);
+        }
+    }
+}
+
+TEST(radix_sort_test, test_small_and_uniform) {
+    uint32_t empty[1] = {0};
+    ASSERT_TRUE(radix_sort(empty, empty));
+    uint32_t same[] = {7, 7, 7, 7};
+    ASSERT_TRUE(radix_sort(same, same + 4));
+    ASSERT_EQ(7u, same[3]);
+    uint32_t high[] = {3u << 24, 1u << 24, 2u << 24};
+    ASSERT_TRUE(radix_sort(high, high + 3));
+    ASSERT_EQ(1u << 24, high[0]);
+    ASSERT_EQ(3u << 24, high[2]);
+}
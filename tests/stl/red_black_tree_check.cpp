@@ -149,3 +149,62 @@ TEST(rb_tree_test, test_insert_equal_and_range) {
     ASSERT_TRUE(tree.begin() == tree.end());
 }
 
+
+static int _rb_black_height(rb_tree::node_type *node) {
+    if (!node) {
+        return 1;
+    }
+    if (node->color() == RedBlackTreeColor::RED) {
+        if ((node->m_left && node->m_left->color() == RedBlackTreeColor::RED) ||
+            (node->m_right && node->m_right->color() == RedBlackTreeColor::RED)) {
+            return -1;
+        }
+    }
+    int left = _rb_black_height(node->m_left);
+    int right = _rb_black_height(node->m_right);
+    if (left < 0 || left != right) {
+        return -1;
+    }
+    return left + (node->color() == RedBlackTreeColor::BLACK ? 1 : 0);
+}
+
+TEST(rb_tree_test, test_assign_sorted) {
+    _rb_element elements[70];
+    for (int i = 0; i < 70; ++i) {
+        elements[i] = make_tuple(static_cast<char>('0' + i), i);
+    }
+    for (int n = 0; n <= 70; ++n) {
+        rb_tree tree;
+        tree.insert_unique(make_tuple('~', -1));
+        ASSERT_TRUE(tree.assign_sorted(elements, elements + n));
+        ASSERT_EQ(static_cast<size_t>(n), tree.size());
+        rb_tree::node_type *root = tree.end().m_node->parent();
+        ASSERT_TRUE(n == 0 ? root == nullptr : root->color() == RedBlackTreeColor::BLACK);
+        ASSERT_LT(0, _rb_black_height(root));
+        int i = 0;
+        for (rbi it = tree.begin(); it != tree.end(); ++it, ++i) {
+            ASSERT_EQ(i, *it);
+        }
+        ASSERT_EQ(n, i);
+        tree.insert_unique(make_tuple('~', -1));
+        ASSERT_EQ(static_cast<size_t>(n) + 1, tree.size());
+        tree.erase(static_cast<char>('0' + n / 2));
+        ASSERT_LT(0, _rb_black_height(tree.end().m_node->parent()));
+    }
+}
+
+TEST(rb_tree_test, test_color_packed_in_parent) {
+    typedef RedBlackTreeNode<tuple<int, int>> node_type;
+    ASSERT_EQ(3 * sizeof(void *) + sizeof(tuple<int, int>), sizeof(node_type));
+    node_type parent;
+    node_type node;
+    node.set_color(RedBlackTreeColor::BLACK);
+    node.set_parent(&parent);
+    ASSERT_EQ(&parent, node.parent());
+    ASSERT_TRUE(node.color() == RedBlackTreeColor::BLACK);
+    node.set_color(RedBlackTreeColor::RED);
+    ASSERT_EQ(&parent, node.parent());
+    ASSERT_TRUE(node.color() == RedBlackTreeColor::RED);
+    node.set_parent(nullptr);
+    ASSERT_TRUE(node.color() == RedBlackTreeColor::RED);
+}
@@ -0,0 +1,239 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <wlib/stl/Sort.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+template<typename T, typename Cmp>
+static bool is_sorted(const array_list<T> &list, Cmp cmp) {
+    for (size_t i = 1; i < list.size(); ++i) {
+        if (cmp.__lt__(list[i], list[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void fill_pattern(array_list<int> &list, size_t n, int pattern) {
+    list.clear();
+    for (size_t i = 0; i < n; ++i) {
+        int v = static_cast<int>(i);
+        switch (pattern) {
+            case 0: v = rand(); break;
+            case 1: break;
+            case 2: v = static_cast<int>(n - i); break;
+            case 3: v = rand() % 4; break;
+            case 4: v = 7; break;
+            case 5: v = i < n / 2 ? static_cast<int>(i) : static_cast<int>(n - i); break;
+            case 6: v = i % 2 == 0 ? static_cast<int>(i) : -static_cast<int>(i); break;
+            default: v = i % 16 == 0 ? rand() : static_cast<int>(i); break;
+        }
+        list.push_back(v);
+    }
+}
+
+TEST(sort_test, test_intro_sort_small) {
+    array_list<int> list;
+    intro_sort(list);
+    ASSERT_EQ(0u, list.size());
+    list.push_back(5);
+    intro_sort(list);
+    ASSERT_EQ(5, list[0]);
+    int values[] = {5, -2, 9, 0, 3, 3, -7, 1};
+    for (int v : values) {
+        list.push_back(v);
+    }
+    intro_sort(list);
+    int sorted[] = {-7, -2, 0, 1, 3, 3, 5, 5, 9};
+    ASSERT_EQ(9u, list.size());
+    for (size_t i = 0; i < 9; ++i) {
+        ASSERT_EQ(sorted[i], list[i]);
+    }
+}
+
+TEST(sort_test, test_intro_sort_patterns) {
+    srand(12);
+    array_list<int> list(3000);
+    size_t sizes[] = {2, 10, 23, 24, 25, 100, 128, 129, 500, 3000};
+    for (size_t n : sizes) {
+        for (int pattern = 0; pattern < 8; ++pattern) {
+            fill_pattern(list, n, pattern);
+            long long sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += list[i];
+            }
+            intro_sort(list.begin(), list.end());
+            ASSERT_TRUE(is_sorted(list, comparator<int>()));
+            for (size_t i = 0; i < n; ++i) {
+                sum -= list[i];
+            }
+            ASSERT_EQ(0, sum);
+        }
+    }
+}
+
+TEST(sort_test, test_intro_sort_comparator) {
+    srand(7);
+    array_list<int> list(1000);
+    for (int pattern = 0; pattern < 8; ++pattern) {
+        fill_pattern(list, 1000, pattern);
+        intro_sort(list, reverse_comparator<int>());
+        ASSERT_TRUE(is_sorted(list, reverse_comparator<int>()));
+    }
+}
+
+TEST(sort_test, test_intro_sort_subrange) {
+    array_list<int> list;
+    for (int i = 0; i < 200; ++i) {
+        list.push_back(200 - i);
+    }
+    intro_sort(list.begin() + 50, list.begin() + 150);
+    ASSERT_EQ(200, list[0]);
+    ASSERT_EQ(151, list[49]);
+    for (int i = 50; i < 150; ++i) {
+        ASSERT_EQ(i + 1, list[static_cast<size_t>(i)]);
+    }
+    ASSERT_EQ(50, list[150]);
+    ASSERT_EQ(1, list[199]);
+}
+
+TEST(sort_test, test_intro_sort_strings) {
+    array_list<static_string<8>> list;
+    const char *words[] = {"pear", "apple", "fig", "kiwi", "banana", "apple", "date"};
+    for (const char *w : words) {
+        list.push_back(static_string<8>(w));
+    }
+    intro_sort(list);
+    ASSERT_TRUE(is_sorted(list, comparator<static_string<8>>()));
+    ASSERT_STREQ("apple", list[0].c_str());
+    ASSERT_STREQ("pear", list[6].c_str());
+}
+
+struct record {
+    int key;
+    int order;
+};
+
+struct record_comparator {
+    bool __lt__(const record &a, const record &b) const { return a.key < b.key; }
+};
+
+static void check_stable(const array_list<record> &list) {
+    for (size_t i = 1; i < list.size(); ++i) {
+        ASSERT_LE(list[i - 1].key, list[i].key);
+        if (list[i - 1].key == list[i].key) {
+            ASSERT_LT(list[i - 1].order, list[i].order);
+        }
+    }
+}
+
+TEST(sort_test, test_merge_sort_stable) {
+    srand(3);
+    size_t sizes[] = {0, 1, 2, 16, 17, 100, 1000};
+    for (size_t n : sizes) {
+        array_list<record> list(n + 1);
+        for (size_t i = 0; i < n; ++i) {
+            list.push_back(record{rand() % 10, static_cast<int>(i)});
+        }
+        merge_sort(list, record_comparator());
+        check_stable(list);
+    }
+}
+
+TEST(sort_test, test_merge_sort_iterators) {
+    srand(5);
+    array_list<int> list(1000);
+    for (int pattern = 0; pattern < 8; ++pattern) {
+        fill_pattern(list, 1000, pattern);
+        merge_sort(list.begin(), list.end());
+        ASSERT_TRUE(is_sorted(list, comparator<int>()));
+        merge_sort(list.begin(), list.end(), reverse_comparator<int>());
+        ASSERT_TRUE(is_sorted(list, reverse_comparator<int>()));
+    }
+}
+
+TEST(sort_test, test_merge_sort_unbuffered) {
+    srand(9);
+    array_list<record> list(500);
+    for (int i = 0; i < 500; ++i) {
+        list.push_back(record{rand() % 7, i});
+    }
+    record_comparator cmp;
+    __merge_sort_loop(list.data(), (size_t) 0, list.size(), (record *) nullptr, cmp);
+    check_stable(list);
+}
+
+TEST(sort_test, test_merge_sort_linked_list) {
+    linked_list<int> list;
+    for (int i = 0; i < 50; ++i) {
+        list.push_back(50 - i);
+    }
+    merge_sort(list);
+    int expected = 1;
+    for (linked_list<int>::iterator it = list.begin(); it != list.end(); ++it) {
+        ASSERT_EQ(expected++, *it);
+    }
+}
+
+TEST(sort_test, test_partial_sort) {
+    srand(11);
+    array_list<int> list(1000);
+    array_list<int> sorted(1000);
+    for (int pattern = 0; pattern < 8; ++pattern) {
+        for (size_t k : {(size_t) 0, (size_t) 1, (size_t) 10, (size_t) 500, (size_t) 1000}) {
+            fill_pattern(list, 1000, pattern);
+            sorted.clear();
+            for (size_t i = 0; i < list.size(); ++i) {
+                sorted.push_back(list[i]);
+            }
+            intro_sort(sorted);
+            partial_sort(list.begin(), list.begin() + k, list.end());
+            for (size_t i = 0; i < k; ++i) {
+                ASSERT_EQ(sorted[i], list[i]);
+            }
+        }
+        fill_pattern(list, 1000, pattern);
+        partial_sort(list.begin(), list.begin() + 100, list.end(), reverse_comparator<int>());
+        for (size_t i = 100; i < list.size(); ++i) {
+            ASSERT_GE(list[99], list[i]);
+        }
+        for (size_t i = 1; i < 100; ++i) {
+            ASSERT_GE(list[i - 1], list[i]);
+        }
+    }
+}
+
+TEST(sort_test, test_nth_element) {
+    srand(13);
+    array_list<int> list(2000);
+    array_list<int> sorted(2000);
+    for (int pattern = 0; pattern < 8; ++pattern) {
+        for (size_t n : {(size_t) 1, (size_t) 20, (size_t) 2000}) {
+            for (int trial = 0; trial < 5; ++trial) {
+                size_t nth = static_cast<size_t>(rand()) % n;
+                fill_pattern(list, n, pattern);
+                sorted.clear();
+                for (size_t i = 0; i < list.size(); ++i) {
+                    sorted.push_back(list[i]);
+                }
+                intro_sort(sorted);
+                nth_element(list.begin(), list.begin() + nth, list.end());
+                ASSERT_EQ(sorted[nth], list[nth]);
+                for (size_t i = 0; i < nth; ++i) {
+                    ASSERT_LE(list[i], list[nth]);
+                }
+                for (size_t i = nth + 1; i < n; ++i) {
+                    ASSERT_GE(list[i], list[nth]);
+                }
+            }
+        }
+    }
+    fill_pattern(list, 500, 0);
+    nth_element(list.begin(), list.begin() + 10, list.end(), reverse_comparator<int>());
+    for (size_t i = 11; i < list.size(); ++i) {
+        ASSERT_LE(list[i], list[10]);
+    }
+    nth_element(list.begin(), list.end(), list.end());
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <wlib/stl/StableVector.h>
+#include <wlib/stl/Sort.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+typedef stable_vector<int, 4> small_vector;
+
+TEST(stable_vector_test, test_push_back_pointer_stability) {
+    small_vector vector(0);
+    ASSERT_EQ(0u, vector.capacity());
+    int *pointers[100];
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(vector.push_back(i));
+        pointers[i] = &vector.back();
+    }
+    ASSERT_EQ(100u, vector.size());
+    ASSERT_EQ(100u, vector.capacity());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(pointers[i], &vector[static_cast<size_t>(i)]);
+        ASSERT_EQ(i, *pointers[i]);
+    }
+    vector.reserve(1000);
+    ASSERT_EQ(1000u, vector.capacity());
+    ASSERT_EQ(pointers[0], &vector.front());
+    ASSERT_EQ(pointers[99], &vector.back());
+}
+
+TEST(stable_vector_test, test_capacity_rounding) {
+    small_vector vector(5);
+    ASSERT_EQ(8u, vector.capacity());
+    stable_vector<int> defaults;
+    ASSERT_EQ(16u, defaults.capacity());
+    for (int i = 0; i < 9; ++i) {
+        vector.push_back(i);
+    }
+    ASSERT_EQ(12u, vector.capacity());
+    vector.reserve(40);
+    ASSERT_EQ(40u, vector.capacity());
+    vector.shrink();
+    ASSERT_EQ(12u, vector.capacity());
+    vector.clear();
+    ASSERT_EQ(0u, vector.size());
+    ASSERT_EQ(12u, vector.capacity());
+    vector.shrink();
+    ASSERT_EQ(0u, vector.capacity());
+    ASSERT_TRUE(vector.push_back(3));
+    ASSERT_EQ(3, vector.front());
+}
+
+TEST(stable_vector_test, test_insert_erase) {
+    small_vector vector;
+    for (int i = 0; i < 10; ++i) {
+        vector.push_back(i);
+    }
+    ASSERT_EQ(100, *vector.insert(static_cast<size_t>(3), 100));
+    ASSERT_EQ(11u, vector.size());
+    ASSERT_EQ(2, vector[2]);
+    ASSERT_EQ(100, vector[3]);
+    ASSERT_EQ(3, vector[4]);
+    ASSERT_EQ(9, vector[10]);
+    vector.push_front(-1);
+    ASSERT_EQ(-1, vector.front());
+    ASSERT_EQ(0, vector[1]);
+    ASSERT_EQ(4, *vector.erase(static_cast<size_t>(5)));
+    vector.pop_front();
+    vector.pop_back();
+    int expected[] = {0, 1, 2, 100, 4, 5, 6, 7, 8};
+    ASSERT_EQ(9u, vector.size());
+    for (size_t i = 0; i < 9; ++i) {
+        ASSERT_EQ(expected[i], vector.at(i));
+    }
+    small_vector::iterator it = vector.find(100);
+    ASSERT_EQ(3u, vector.index_of(100));
+    it = vector.erase(it);
+    ASSERT_EQ(4, *it);
+    it = vector.insert(it, 3);
+    ASSERT_EQ(3, *it);
+    ASSERT_EQ(vector.end(), vector.find(100));
+    ASSERT_EQ(1u, vector.count(3));
+    ASSERT_EQ(vector.end(), vector.erase(vector.end()));
+}
+
+TEST(stable_vector_test, test_iterators) {
+    small_vector vector;
+    for (int i = 0; i < 23; ++i) {
+        vector.push_back(i * 2);
+    }
+    int expected = 0;
+    for (small_vector::iterator it = vector.begin(); it != vector.end(); ++it) {
+        ASSERT_EQ(expected, *it);
+        expected += 2;
+    }
+    const small_vector &const_vector = vector;
+    small_vector::const_iterator cit = const_vector.begin() + 10;
+    ASSERT_EQ(20, *cit);
+    cit -= 3;
+    ASSERT_EQ(14, *cit);
+    cit += 100;
+    ASSERT_EQ(const_vector.end(), cit);
+    ASSERT_EQ(23, const_vector.end() - const_vector.begin());
+    ASSERT_TRUE((is_random_access_iterator<small_vector::iterator>()));
+}
+
+TEST(stable_vector_test, test_sort) {
+    small_vector vector;
+    for (int i = 0; i < 200; ++i) {
+        vector.push_back((i * 7919) % 211);
+    }
+    intro_sort(vector.begin(), vector.end());
+    for (size_t i = 1; i < vector.size(); ++i) {
+        ASSERT_LE(vector[i - 1], vector[i]);
+    }
+}
+
+TEST(stable_vector_test, test_move) {
+    small_vector vector;
+    for (int i = 0; i < 10; ++i) {
+        vector.push_back(i);
+    }
+    int *p = &vector[7];
+    small_vector moved(move(vector));
+    ASSERT_EQ(0u, vector.size());
+    ASSERT_EQ(0u, vector.capacity());
+    ASSERT_EQ(10u, moved.size());
+    ASSERT_EQ(p, &moved[7]);
+    small_vector other;
+    other.push_back(1);
+    other = move(moved);
+    ASSERT_EQ(10u, other.size());
+    ASSERT_EQ(p, &other[7]);
+    ASSERT_TRUE(vector.push_back(5));
+    ASSERT_EQ(5, vector[0]);
+}
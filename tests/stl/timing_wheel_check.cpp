@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <wlib/stl/TimingWheel.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+struct connection {
+    int id;
+    uint64_t fired_at;
+    int fire_count;
+    timer_hook timeout;
+
+    connection() : id(0), fired_at(0), fire_count(0) {}
+};
+
+typedef timing_wheel<connection, &connection::timeout> wheel;
+typedef timing_wheel<connection, &connection::timeout, 2, 3> small_wheel;
+
+template
+class timing_wheel<connection, &connection::timeout>;
+
+struct record_fired {
+    uint64_t *now;
+
+    void operator()(connection &c) const {
+        c.fired_at = *now;
+        ++c.fire_count;
+    }
+};
+
+TEST(timing_wheel_test, test_schedule_and_expire) {
+    wheel w;
+    connection a, b, c;
+    w.schedule(a, 5);
+    w.schedule_after(b, 1);
+    w.schedule(c, 300);
+    ASSERT_EQ(3u, w.size());
+    ASSERT_TRUE(a.timeout.is_scheduled());
+    uint64_t now = 4;
+    record_fired cb{&now};
+    ASSERT_EQ(1u, w.advance(now, cb));
+    ASSERT_EQ(1, b.fire_count);
+    ASSERT_FALSE(b.timeout.is_scheduled());
+    ASSERT_EQ(0, a.fire_count);
+    now = 5;
+    ASSERT_EQ(1u, w.advance(now, cb));
+    ASSERT_EQ(1, a.fire_count);
+    now = 299;
+    ASSERT_EQ(0u, w.advance(now, cb));
+    now = 300;
+    ASSERT_EQ(1u, w.advance(now, cb));
+    ASSERT_EQ(300u, c.fired_at);
+    ASSERT_TRUE(w.empty());
+}
+
+TEST(timing_wheel_test, test_cancel_and_reschedule) {
+    wheel w(100);
+    connection a, b;
+    ASSERT_FALSE(w.cancel(a));
+    w.schedule(a, 150);
+    w.schedule(b, 150);
+    ASSERT_TRUE(w.cancel(a));
+    ASSERT_FALSE(a.timeout.is_scheduled());
+    ASSERT_EQ(1u, w.size());
+    w.schedule(b, 5000);
+    ASSERT_EQ(1u, w.size());
+    ASSERT_EQ(5000u, b.timeout.expiry());
+    w.schedule(a, 50);
+    ASSERT_EQ(101u, a.timeout.expiry());
+    uint64_t now = 4999;
+    record_fired cb{&now};
+    ASSERT_EQ(1u, w.advance(now, cb));
+    ASSERT_EQ(1, a.fire_count);
+    ASSERT_EQ(0, b.fire_count);
+    now = 5000;
+    ASSERT_EQ(1u, w.advance(now, cb));
+    ASSERT_EQ(1, b.fire_count);
+}
+
+TEST(timing_wheel_test, test_batch_limit) {
+    wheel w;
+    connection conns[10];
+    for (connection &c : conns) {
+        w.schedule(c, 10);
+    }
+    uint64_t now = 20;
+    record_fired cb{&now};
+    ASSERT_EQ(4u, w.advance(now, cb, 4));
+    ASSERT_EQ(10u, w.now());
+    ASSERT_EQ(6u, w.size());
+    ASSERT_EQ(4u, w.advance(now, cb, 4));
+    ASSERT_EQ(2u, w.advance(now, cb, 4));
+    ASSERT_EQ(20u, w.now());
+    for (connection &c : conns) {
+        ASSERT_EQ(1, c.fire_count);
+    }
+}
+
+TEST(timing_wheel_test, test_reschedule_from_callback) {
+    wheel w;
+    connection c;
+    w.schedule(c, 3);
+    struct periodic {
+        wheel *w;
+
+        void operator()(connection &c) const {
+            ++c.fire_count;
+            w->schedule_after(c, 3);
+        }
+    } cb{&w};
+    ASSERT_EQ(4u, w.advance(12, cb));
+    ASSERT_EQ(4, c.fire_count);
+    ASSERT_EQ(15u, c.timeout.expiry());
+    w.clear();
+    ASSERT_FALSE(c.timeout.is_scheduled());
+    ASSERT_TRUE(w.empty());
+}
+
+TEST(timing_wheel_test, test_random_expiry) {
+    // two levels of eight slots span 64 ticks, so longer timers
+    // go through the overflow list
+    small_wheel w;
+    const size_t n = 300;
+    connection conns[n];
+    for (size_t i = 0; i < n; ++i) {
+        conns[i].id = static_cast<int>(i);
+        w.schedule(conns[i], static_cast<uint64_t>(1 + rand() % 500));
+    }
+    for (size_t i = 0; i < n; i += 7) {
+        w.cancel(conns[i]);
+    }
+    uint64_t now = 0;
+    record_fired cb{&now};
+    while (now < 600) {
+        now += static_cast<uint64_t>(1 + rand() % 9);
+        w.advance(now, cb);
+        for (size_t i = 0; i < n; ++i) {
+            if (conns[i].fire_count) {
+                continue;
+            }
+            if (i % 7 == 0) {
+                ASSERT_FALSE(conns[i].timeout.is_scheduled());
+            } else {
+                ASSERT_LT(now, conns[i].timeout.expiry());
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 7 == 0) {
+            ASSERT_EQ(0, conns[i].fire_count);
+        } else {
+            ASSERT_EQ(1, conns[i].fire_count);
+            ASSERT_GE(conns[i].fired_at, conns[i].timeout.expiry());
+            ASSERT_LT(conns[i].fired_at - conns[i].timeout.expiry(), 9u);
+        }
+    }
+    ASSERT_TRUE(w.empty());
+}
+
+TEST(timing_wheel_test, test_expiry_order) {
+    small_wheel w;
+    const size_t n = 200;
+    connection conns[n];
+    for (size_t i = 0; i < n; ++i) {
+        w.schedule(conns[i], static_cast<uint64_t>(1 + rand() % 1000));
+    }
+    struct check_order {
+        const small_wheel *w;
+        uint64_t *last;
+        size_t *count;
+
+        void operator()(connection &c) const {
+            EXPECT_EQ(w->now(), c.timeout.expiry());
+            EXPECT_LE(*last, c.timeout.expiry());
+            *last = c.timeout.expiry();
+            ++*count;
+        }
+    };
+    uint64_t last = 0;
+    size_t count = 0;
+    ASSERT_EQ(n, w.advance(2000, check_order{&w, &last, &count}));
+    ASSERT_EQ(n, count);
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <wlib/stl/TreeMap.h>
+#include <wlib/stl/TreeSet.h>
 #include <wlib/strings/String.h>
 
 using namespace wlp;
@@ -42,6 +43,29 @@ TEST(tree_map, insert_rvalue) {
     ASSERT_STREQ("val", map[akey].c_str());
 }
 
+TEST(tree_map, insert_moved_keys_in_order) {
+    typedef dynamic_string string;
+    typedef tree_map<string, int> string_map;
+
+    string_map map;
+    const char *keys[] = {"mike", "charlie", "xray", "alpha", "tango", "echo", "zulu"};
+    int value = 0;
+    for (const char *key : keys) {
+        string moved(key);
+        map.insert(move(moved), value++);
+    }
+    ASSERT_EQ(7u, map.size());
+    const char *sorted[] = {"alpha", "charlie", "echo", "mike", "tango", "xray", "zulu"};
+    string_map::iterator it = map.begin();
+    for (const char *key : sorted) {
+        ASSERT_STREQ(key, it.key().c_str());
+        ++it;
+    }
+    ASSERT_TRUE(it == map.end());
+    ASSERT_EQ(2, map.at(string("xray")));
+    ASSERT_EQ(6, map.at(string("zulu")));
+}
+
 TEST(tree_map, test_iterator_get_key) {
     tree_map<char *, int> map;
     static char key1[] = "first";
@@ -60,3 +84,312 @@ TEST(tree_map, test_iterator_get_key) {
     }
     ASSERT_EQ(0, sum);
 }
+
+TEST(tree_map, test_pooled_insert_erase) {
+    typedef tree_map<int, int> int_map;
+    int_map::pool_type pool;
+    int_map map(&pool);
+    ASSERT_EQ(&pool, map.get_backing_table()->pool());
+    for (int i = 0; i < 100; ++i) {
+        map.insert(i, i * i);
+    }
+    ASSERT_EQ(100u, pool.in_use());
+    for (int i = 0; i < 100; i += 2) {
+        ASSERT_TRUE(map.erase(i));
+    }
+    ASSERT_EQ(50u, pool.in_use());
+    size_t blocks = pool.blocks();
+    for (int i = 0; i < 100; i += 2) {
+        map.insert(i, -i);
+    }
+    ASSERT_EQ(blocks, pool.blocks());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i % 2 == 0 ? -i : i * i, map.at(i));
+    }
+    map.clear();
+    ASSERT_EQ(0u, pool.in_use());
+    ASSERT_TRUE(map.empty());
+    map.insert(7, 7);
+    ASSERT_EQ(7, map.at(7));
+}
+
+TEST(tree_map, test_pooled_adjacent_nodes) {
+    typedef tree_map<int, int> int_map;
+    int_map::pool_type pool;
+    int_map map(&pool);
+    for (int i = 0; i < 8; ++i) {
+        map.insert(i, i);
+    }
+    int_map::iterator prev = map.begin();
+    int_map::iterator it = prev;
+    for (++it; it != map.end(); ++it, ++prev) {
+        ASSERT_EQ(prev.m_node + 1, it.m_node);
+    }
+}
+
+TEST(tree_map, test_pooled_shared) {
+    typedef dynamic_string string;
+    typedef tree_map<string, int> string_map;
+    string_map::pool_type pool;
+    {
+        string_map a(&pool);
+        string_map b(&pool);
+        a.insert(string("two"), 2);
+        a.insert(string("one"), 1);
+        b.insert(string("three"), 3);
+        ASSERT_EQ(3u, pool.in_use());
+        string_map moved(move(b));
+        ASSERT_EQ(&pool, moved.get_backing_table()->pool());
+        ASSERT_EQ(3, moved.at(string("three")));
+        a.erase(string("one"));
+        ASSERT_EQ(2u, pool.in_use());
+    }
+    ASSERT_EQ(0u, pool.in_use());
+    ASSERT_TRUE(pool.release());
+}
+
+TEST(tree_map, test_counted_nth_rank) {
+    typedef tree_map<int, int, comparator<int>, true> counted_map;
+    counted_map map;
+    for (int i = 0; i < 64; ++i) {
+        map.insert((i * 37) % 64, i);
+    }
+    for (int i = 0; i < 64; i += 3) {
+        ASSERT_TRUE(map.erase(i));
+    }
+    size_t k = 0;
+    for (counted_map::iterator it = map.begin(); it != map.end(); ++it, ++k) {
+        ASSERT_EQ(it, map.nth(k));
+        ASSERT_EQ(k, map.rank(it.key()));
+        ASSERT_EQ(k, map.distance(map.begin(), it));
+        ASSERT_EQ(map.size() - k, map.distance(it, map.end()));
+    }
+    ASSERT_EQ(map.size(), k);
+    ASSERT_EQ(map.end(), map.nth(map.size()));
+    ASSERT_EQ(0u, map.rank(-1));
+    ASSERT_EQ(map.size(), map.rank(64));
+    ASSERT_EQ(2u, map.rank(3));
+    ASSERT_EQ(2, map.nth(1).key());
+}
+
+TEST(tree_map, test_uncounted_nth_rank) {
+    typedef tree_map<int, int> int_map;
+    int_map map;
+    for (int i = 9; i >= 0; --i) {
+        map.insert(i * 2, i);
+    }
+    ASSERT_EQ(6, map.nth(3).key());
+    ASSERT_EQ(map.end(), map.nth(10));
+    ASSERT_EQ(4u, map.rank(7));
+    ASSERT_EQ(4u, map.rank(8));
+    ASSERT_EQ(3u, map.distance(map.find(4), map.find(10)));
+}
+
+TEST(tree_set, test_counted_percentile) {
+    typedef tree_set<int, comparator<int>, true> counted_set;
+    counted_set::pool_type pool;
+    counted_set set(&pool);
+    for (int i = 0; i < 100; ++i) {
+        set.insert(99 - i);
+    }
+    ASSERT_EQ(90, *set.nth(set.size() * 9 / 10));
+    set.erase(50);
+    ASSERT_EQ(91, *set.nth(90));
+    ASSERT_EQ(50u, set.rank(50));
+    ASSERT_EQ(50u, set.rank(51));
+    ASSERT_EQ(10u, set.distance(set.lower_bound(40), set.lower_bound(51)));
+    set.clear();
+    set.insert(5);
+    ASSERT_EQ(5, *set.nth(0));
+    ASSERT_EQ(1u, set.distance(set.begin(), set.end()));
+}
+
+TEST(tree_map, test_construct_sorted) {
+    typedef tree_map<int, int, comparator<int>, true> counted_map;
+    tuple<int, int> elements[32];
+    for (int i = 0; i < 32; ++i) {
+        elements[i] = make_tuple(i * 3, i);
+    }
+    counted_map map(elements, elements + 32);
+    ASSERT_EQ(32u, map.size());
+    ASSERT_EQ(10, map.at(30));
+    ASSERT_EQ(45, map.nth(15).key());
+    ASSERT_EQ(11u, map.rank(31));
+    map.insert(31, -1);
+    ASSERT_EQ(12u, map.rank(32));
+    ASSERT_TRUE(map.assign_sorted(elements, elements + 4));
+    ASSERT_EQ(4u, map.size());
+    ASSERT_FALSE(map.contains(31));
+}
+
+TEST(tree_set, test_construct_sorted_pooled) {
+    typedef tree_set<int> int_set;
+    int keys[] = {1, 2, 3, 5, 8, 13, 21};
+    int_set::pool_type pool;
+    int_set set(keys, keys + 7, &pool);
+    ASSERT_EQ(7u, pool.in_use());
+    ASSERT_EQ(7u, set.size());
+    int i = 0;
+    for (int_set::iterator it = set.begin(); it != set.end(); ++it) {
+        ASSERT_EQ(keys[i++], *it);
+    }
+    set.clear();
+    ASSERT_EQ(0u, pool.in_use());
+}
+
+template<typename Node>
+static int _rb_black_height(const Node *node) {
+    if (!node) {
+        return 1;
+    }
+    if (node->color() == RedBlackTreeColor::RED) {
+        if ((node->m_left && node->m_left->color() == RedBlackTreeColor::RED) ||
+            (node->m_right && node->m_right->color() == RedBlackTreeColor::RED)) {
+            return -1;
+        }
+    }
+    if ((node->m_left && node->m_left->parent() != node) ||
+        (node->m_right && node->m_right->parent() != node)) {
+        return -1;
+    }
+    size_t count = 1 + RedBlackTreeCounter<Node>::count(node->m_left) + RedBlackTreeCounter<Node>::count(node->m_right);
+    if (RedBlackTreeCounter<Node>::counted && RedBlackTreeCounter<Node>::count(node) != count) {
+        return -1;
+    }
+    int left = _rb_black_height(node->m_left);
+    int right = _rb_black_height(node->m_right);
+    if (left < 0 || left != right) {
+        return -1;
+    }
+    return left + (node->color() == RedBlackTreeColor::BLACK ? 1 : 0);
+}
+
+template<typename Map>
+static void check_red_black(Map &map) {
+    typename Map::table_type::node_type *root = map.get_backing_table()->end().m_node->parent();
+    if (map.empty()) {
+        ASSERT_EQ(nullptr, root);
+        return;
+    }
+    ASSERT_TRUE(root->color() == RedBlackTreeColor::BLACK);
+    ASSERT_LT(0, _rb_black_height(root));
+    size_t count = 0;
+    for (typename Map::iterator it = map.begin(); it != map.end(); ++it) {
+        ++count;
+    }
+    ASSERT_EQ(map.size(), count);
+}
+
+TEST(tree_map, test_split_join) {
+    typedef tree_map<int, int> int_map;
+    int_map::pool_type pool;
+    int_map map(&pool);
+    int_map upper(&pool);
+    for (int i = 0; i < 200; ++i) {
+        map.insert(i, -i);
+    }
+    ASSERT_TRUE(map.split(150, upper));
+    check_red_black(map);
+    check_red_black(upper);
+    ASSERT_EQ(150u, map.size());
+    ASSERT_EQ(50u, upper.size());
+    ASSERT_EQ(200u, pool.in_use());
+    ASSERT_EQ(149, (--map.end()).key());
+    ASSERT_EQ(150, upper.begin().key());
+    ASSERT_FALSE(map.contains(150));
+    ASSERT_EQ(-175, upper.at(175));
+    int expected = 0;
+    for (int_map::iterator it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(expected++, it.key());
+    }
+    ASSERT_FALSE(upper.join(map));
+    ASSERT_TRUE(map.join(upper));
+    check_red_black(map);
+    check_red_black(upper);
+    ASSERT_TRUE(upper.empty());
+    ASSERT_EQ(200u, map.size());
+    expected = 0;
+    for (int_map::iterator it = map.begin(); it != map.end(); ++it) {
+        ASSERT_EQ(expected++, it.key());
+    }
+    ASSERT_EQ(200, expected);
+    ASSERT_TRUE(map.split(-1, upper));
+    check_red_black(map);
+    check_red_black(upper);
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(200u, upper.size());
+    int_map other;
+    ASSERT_FALSE(upper.join(other));
+}
+
+TEST(tree_map, test_counted_split_merge) {
+    typedef tree_map<int, int, comparator<int>, true> counted_map;
+    counted_map map;
+    counted_map upper;
+    for (int i = 0; i < 100; ++i) {
+        map.insert(i * 2, i);
+    }
+    ASSERT_TRUE(map.split(61, upper));
+    check_red_black(map);
+    check_red_black(upper);
+    ASSERT_EQ(31u, map.size());
+    ASSERT_EQ(69u, upper.size());
+    ASSERT_EQ(62, upper.nth(0).key());
+    ASSERT_EQ(60, map.nth(30).key());
+    ASSERT_EQ(10u, upper.rank(82));
+    counted_map odd;
+    for (int i = 0; i < 50; ++i) {
+        odd.insert(i * 4 + 1, -i);
+    }
+    odd.insert(62, 0);
+    ASSERT_EQ(50u, upper.merge(odd));
+    check_red_black(upper);
+    check_red_black(odd);
+    ASSERT_EQ(1u, odd.size());
+    ASSERT_EQ(62, odd.begin().key());
+    ASSERT_EQ(119u, upper.size());
+    ASSERT_EQ(-5, upper.at(21));
+    size_t k = 0;
+    int prev = -1;
+    for (counted_map::iterator it = upper.begin(); it != upper.end(); ++it, ++k) {
+        ASSERT_LT(prev, it.key());
+        prev = it.key();
+        ASSERT_EQ(it, upper.nth(k));
+    }
+    ASSERT_EQ(31u, upper.merge(map));
+    check_red_black(upper);
+    check_red_black(map);
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(150u, upper.size());
+}
+
+template<typename Map>
+static void check_split_every_key(int n, int stride) {
+    for (int key = -1; key <= n; ++key) {
+        Map map;
+        Map upper;
+        // a strided insertion order gives trees of varied shape
+        for (int i = 0; i < n; ++i) {
+            map.insert((i * stride) % n, i);
+        }
+        ASSERT_TRUE(map.split(key, upper));
+        check_red_black(map);
+        check_red_black(upper);
+        int low = key < 0 ? 0 : (key > n ? n : key);
+        ASSERT_EQ(static_cast<size_t>(low), map.size());
+        ASSERT_EQ(static_cast<size_t>(n - low), upper.size());
+        ASSERT_TRUE(map.join(upper));
+        check_red_black(map);
+        ASSERT_EQ(static_cast<size_t>(n), map.size());
+    }
+}
+
+TEST(tree_map, test_split_join_invariants) {
+    typedef tree_map<int, int> int_map;
+    typedef tree_map<int, int, comparator<int>, true> counted_map;
+    check_split_every_key<int_map>(97, 1);
+    check_split_every_key<int_map>(97, 31);
+    check_split_every_key<counted_map>(97, 1);
+    check_split_every_key<counted_map>(97, 53);
+    check_split_every_key<counted_map>(300, 7);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <wlib/stl/UnrolledList.h>
+
+#include "../template_defs.h"
+
+using namespace wlp;
+
+template<typename T, size_t N>
+static void check_nodes(const unrolled_list<T, N> &list) {
+    size_t count = 0;
+    size_t nodes = 0;
+    for (const UnrolledListNode<T, N> *node = list.begin().m_current; node; node = node->m_next) {
+        ASSERT_GT(node->m_count, 0u);
+        ASSERT_LE(node->m_count, N);
+        if (node->m_next) {
+            ASSERT_EQ(node, node->m_next->m_prev);
+        }
+        count += node->m_count;
+        ++nodes;
+    }
+    ASSERT_EQ(list.size(), count);
+    ASSERT_EQ(list.nodes(), nodes);
+}
+
+TEST(unrolled_list_test, test_push_pop) {
+    unrolled_list<int, 4> list;
+    ASSERT_TRUE(list.empty());
+    ASSERT_TRUE(list.begin() == list.end());
+    for (int i = 0; i < 10; ++i) {
+        list.push_back(i);
+    }
+    list.push_front(-1);
+    check_nodes(list);
+    ASSERT_EQ(11u, list.size());
+    ASSERT_EQ(-1, list.front());
+    ASSERT_EQ(9, list.back());
+    int expected = -1;
+    for (unrolled_list<int, 4>::iterator it = list.begin(); it != list.end(); ++it) {
+        ASSERT_EQ(expected++, *it);
+    }
+    unrolled_list<int, 4>::iterator it = list.end();
+    for (int i = 9; i >= -1; --i) {
+        --it;
+        ASSERT_EQ(i, *it);
+    }
+    ASSERT_TRUE(it == list.begin());
+    list.pop_front();
+    list.pop_back();
+    ASSERT_EQ(0, list.front());
+    ASSERT_EQ(8, list.back());
+    while (!list.empty()) {
+        list.pop_back();
+        check_nodes(list);
+    }
+    ASSERT_EQ(0u, list.nodes());
+}
+
+TEST(unrolled_list_test, test_at) {
+    unrolled_list<int> list;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(i * 2);
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(static_cast<int>(i * 2), list[i]);
+    }
+    ASSERT_EQ(0, list.at(1000));
+    const unrolled_list<int> &const_list = list;
+    ASSERT_EQ(998, const_list.at(499));
+    ASSERT_EQ(250u, list.index_of(500));
+    ASSERT_EQ(1000u, list.index_of(501));
+    ASSERT_EQ(500, *list.find(500));
+    ASSERT_TRUE(const_list.find(3) == const_list.end());
+}
+
+TEST(unrolled_list_test, test_insert_split) {
+    unrolled_list<int, 4> list;
+    for (int i = 0; i < 8; ++i) {
+        list.push_back(i * 10);
+    }
+    ASSERT_EQ(2u, list.nodes());
+    unrolled_list<int, 4>::iterator it = list.insert(static_cast<size_t>(3), 25);
+    ASSERT_EQ(25, *it);
+    check_nodes(list);
+    ASSERT_EQ(3u, list.nodes());
+    it = list.insert(list.begin(), -10);
+    ASSERT_EQ(-10, *it);
+    it = list.insert(list.end(), 80);
+    ASSERT_EQ(80, *it);
+    int expected[] = {-10, 0, 10, 20, 25, 30, 40, 50, 60, 70, 80};
+    ASSERT_EQ(11u, list.size());
+    for (size_t i = 0; i < 11; ++i) {
+        ASSERT_EQ(expected[i], list[i]);
+    }
+    check_nodes(list);
+}
+
+TEST(unrolled_list_test, test_erase_merge) {
+    unrolled_list<int, 8> list;
+    for (int i = 0; i < 64; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQ(8u, list.nodes());
+    unrolled_list<int, 8>::iterator it = list.begin();
+    while (it != list.end()) {
+        if (*it % 3 != 0) {
+            it = list.erase(it);
+        } else {
+            ++it;
+        }
+        check_nodes(list);
+    }
+    ASSERT_EQ(22u, list.size());
+    for (size_t i = 0; i < list.size(); ++i) {
+        ASSERT_EQ(static_cast<int>(i * 3), list[i]);
+    }
+    ASSERT_LE(list.nodes(), 22u / 4 + 1);
+    it = list.erase(static_cast<size_t>(21));
+    ASSERT_TRUE(it == list.end());
+    ASSERT_TRUE(list.erase(list.end()) == list.end());
+}
+
+TEST(unrolled_list_test, test_random_operations) {
+    srand(17);
+    unrolled_list<int, 6> list;
+    linked_list<int> reference;
+    for (int step = 0; step < 3000; ++step) {
+        int op = rand() % 4;
+        if (op < 2 || reference.empty()) {
+            size_t i = reference.empty() ? 0 : static_cast<size_t>(rand()) % reference.size();
+            list.insert(i, step);
+            reference.insert(i, step);
+        } else if (op == 2) {
+            size_t i = static_cast<size_t>(rand()) % reference.size();
+            list.erase(i);
+            reference.erase(i);
+        } else {
+            list.push_back(step);
+            reference.push_back(step);
+        }
+    }
+    check_nodes(list);
+    ASSERT_EQ(reference.size(), list.size());
+    linked_list<int>::iterator ref = reference.begin();
+    for (unrolled_list<int, 6>::iterator it = list.begin(); it != list.end(); ++it, ++ref) {
+        ASSERT_EQ(*ref, *it);
+    }
+}
+
+TEST(unrolled_list_test, test_move) {
+    unrolled_list<int, 4> list;
+    for (int i = 0; i < 10; ++i) {
+        list.push_back(i);
+    }
+    unrolled_list<int, 4> moved(move(list));
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(0u, list.nodes());
+    ASSERT_EQ(10u, moved.size());
+    unrolled_list<int, 4> assigned;
+    assigned.push_back(100);
+    assigned = move(moved);
+    ASSERT_EQ(10u, assigned.size());
+    ASSERT_EQ(9, assigned.back());
+    ASSERT_TRUE(moved.empty());
+}
@@ -153,3 +153,114 @@ TEST(dynamic_string_tests, resize_length_set) {
     ASSERT_EQ(length, str.length());
 }
 
+
+TEST(dynamic_string_tests, capacity_growth) {
+    dynamic_string str;
+    ASSERT_EQ(dynamic_string::local_capacity, str.capacity());
+    size_t reallocations = 0;
+    size_t capacity = str.capacity();
+    for (int i = 0; i < 1000; ++i) {
+        str.push_back(static_cast<char>('a' + i % 26));
+        if (str.capacity() != capacity) {
+            ++reallocations;
+            capacity = str.capacity();
+        }
+    }
+    ASSERT_EQ(1000u, str.length());
+    ASSERT_GE(str.capacity(), str.length());
+    ASSERT_LE(reallocations, 6u);
+    ASSERT_EQ('a', str[0]);
+    ASSERT_EQ('l', str[999]);
+    ASSERT_EQ('\0', str.c_str()[1000]);
+
+    str += 'x';
+    str += "yz";
+    ASSERT_EQ(1003u, str.length());
+    ASSERT_STREQ("xyz", str.c_str() + 1000);
+
+    str.clear();
+    ASSERT_EQ(capacity, str.capacity());
+    str = 'q';
+    ASSERT_EQ(1u, str.length());
+    ASSERT_STREQ("q", str.c_str());
+}
+
+TEST(dynamic_string_tests, reserve_shrink_to_fit) {
+    dynamic_string str("hello");
+    ASSERT_EQ(dynamic_string::local_capacity, str.capacity());
+    str.reserve(64);
+    ASSERT_EQ(64u, str.capacity());
+    ASSERT_STREQ("hello", str.c_str());
+    str.reserve(10);
+    ASSERT_EQ(64u, str.capacity());
+    str.append(" world");
+    ASSERT_EQ(64u, str.capacity());
+    str.append(str);
+    ASSERT_STREQ("hello worldhello world", str.c_str());
+    str.shrink_to_fit();
+    ASSERT_EQ(22u, str.capacity());
+    ASSERT_EQ(dynamic_string::local_capacity, str.capacity());
+    ASSERT_STREQ("hello worldhello world", str.c_str());
+    str.append(str);
+    ASSERT_STREQ("hello worldhello worldhello worldhello world", str.c_str());
+
+    dynamic_string moved(move(str));
+    ASSERT_EQ(44u, moved.length());
+    ASSERT_EQ(dynamic_string::local_capacity, str.capacity());
+    str.push_back('!');
+    ASSERT_STREQ("!", str.c_str());
+}
+
+TEST(dynamic_string_tests, compact_layout) {
+    ASSERT_EQ(sizeof(char *) + 2 * sizeof(size_t), sizeof(dynamic_string));
+    ASSERT_EQ(sizeof(dynamic_string) - 2, dynamic_string::local_capacity);
+#if defined(__x86_64__) || defined(__aarch64__)
+    ASSERT_EQ(24u, sizeof(dynamic_string));
+#endif
+}
+
+TEST(dynamic_string_tests, small_string) {
+    const char *fits = "twenty-two characters!";
+    const char *spills = "twenty-three characters";
+    ASSERT_EQ(dynamic_string::local_capacity, strlen(fits));
+
+    dynamic_string small(fits);
+    ASSERT_EQ(dynamic_string::local_capacity, small.capacity());
+    dynamic_string large(spills);
+    ASSERT_EQ(strlen(spills), large.capacity());
+
+    // moving a local string copies its characters
+    dynamic_string moved_small(move(small));
+    ASSERT_STREQ(fits, moved_small.c_str());
+    ASSERT_STREQ("", small.c_str());
+    ASSERT_TRUE(small.empty());
+    small = move(moved_small);
+    ASSERT_STREQ(fits, small.c_str());
+
+    // moving a heap string transfers its array
+    const char *array = large.c_str();
+    dynamic_string moved_large(move(large));
+    ASSERT_EQ(array, moved_large.c_str());
+    ASSERT_TRUE(large.empty());
+    small = move(moved_large);
+    ASSERT_EQ(array, small.c_str());
+    ASSERT_STREQ(spills, small.c_str());
+
+    // a local string spills to the heap and comes back on shrink
+    dynamic_string str(fits);
+    str.push_back('+');
+    ASSERT_STREQ("twenty-two characters!+", str.c_str());
+    ASSERT_LT(dynamic_string::local_capacity, str.capacity());
+    str.pop_back();
+    str.shrink_to_fit();
+    ASSERT_EQ(dynamic_string::local_capacity, str.capacity());
+    ASSERT_STREQ(fits, str.c_str());
+
+    dynamic_string sub = dynamic_string(spills).substr(7, 5);
+    ASSERT_STREQ("three", sub.c_str());
+    ASSERT_STREQ("", sub.substr(5, 1).c_str());
+    str = sub;
+    ASSERT_STREQ("three", str.c_str());
+    str = str;
+    ASSERT_STREQ("three", str.c_str());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <wlib/strings/String.h>
+#include <wlib/stl/Comparator.h>
+#include <wlib/stl/Equal.h>
+#include <wlib/stl/Hash.h>
+
+using namespace wlp;
+
+TEST(string_view_tests, construct_and_access) {
+    string_view empty;
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQ(0u, empty.length());
+
+    const char *text = "waterloop";
+    string_view view(text);
+    ASSERT_EQ(9u, view.length());
+    ASSERT_EQ(text, view.data());
+    ASSERT_EQ('w', view.front());
+    ASSERT_EQ('p', view.back());
+    ASSERT_EQ('t', view[2]);
+
+    string_view part(text, 5);
+    ASSERT_EQ(5u, part.length());
+    ASSERT_TRUE(part == "water");
+
+    size_t count = 0;
+    for (char c : view) {
+        ASSERT_EQ(text[count++], c);
+    }
+    ASSERT_EQ(9u, count);
+}
+
+TEST(string_view_tests, substr_and_find) {
+    string_view view("key=value;other=1");
+    ASSERT_EQ(3u, view.find('='));
+    ASSERT_EQ(15u, view.find('=', 4));
+    ASSERT_EQ(string_view::npos, view.find('#'));
+    ASSERT_EQ(string_view::npos, view.find('=', 100));
+    ASSERT_EQ(10u, view.find("other"));
+    ASSERT_EQ(string_view::npos, view.find("others"));
+    ASSERT_EQ(0u, view.find(""));
+
+    ASSERT_TRUE(view.substr(0, 3) == "key");
+    ASSERT_TRUE(view.substr(4, 5) == "value");
+    ASSERT_TRUE(view.substr(16) == "1");
+    ASSERT_TRUE(view.substr(16, 100) == "1");
+    ASSERT_TRUE(view.substr(17).empty());
+    ASSERT_TRUE(view.substr(50).empty());
+    ASSERT_TRUE(view.starts_with("key="));
+    ASSERT_FALSE(view.starts_with("value"));
+
+    string_view trimmed = view;
+    trimmed.remove_prefix(4);
+    trimmed.remove_suffix(8);
+    ASSERT_TRUE(trimmed == "value");
+    trimmed.remove_suffix(100);
+    ASSERT_TRUE(trimmed.empty());
+}
+
+TEST(string_view_tests, tokenize_without_copy) {
+    dynamic_string message("GET /pods/3/speed HTTP/1.1");
+    string_view rest = message;
+    const char *tokens[] = {"GET", "/pods/3/speed", "HTTP/1.1"};
+    for (const char *token : tokens) {
+        size_t end = rest.find(' ');
+        string_view field = rest.substr(0, end);
+        ASSERT_TRUE(field == token);
+        ASSERT_GE(field.data(), message.c_str());
+        ASSERT_LE(field.data() + field.length(), message.c_str() + message.length());
+        rest.remove_prefix(end == string_view::npos ? rest.length() : end + 1);
+    }
+    ASSERT_TRUE(rest.empty());
+}
+
+TEST(string_view_tests, string_conversions) {
+    static_string<32> fixed("static string");
+    dynamic_string dynamic("dynamic string");
+
+    string_view fixed_view = fixed;
+    string_view dynamic_view = dynamic;
+    ASSERT_EQ(fixed.c_str(), fixed_view.data());
+    ASSERT_EQ(fixed.length(), fixed_view.length());
+    ASSERT_EQ(dynamic.c_str(), dynamic_view.data());
+    ASSERT_EQ(dynamic.length(), dynamic_view.length());
+
+    string_view word = dynamic.substr_view(8, 3);
+    ASSERT_TRUE(word == "str");
+    ASSERT_EQ(dynamic.c_str() + 8, word.data());
+    ASSERT_TRUE(fixed.substr_view(7) == "string");
+    ASSERT_TRUE(fixed.substr_view(40).empty());
+
+    dynamic_string copied(word);
+    ASSERT_STREQ("str", copied.c_str());
+    static_string<8> fixed_copy(fixed.substr_view(0, 6));
+    ASSERT_STREQ("static", fixed_copy.c_str());
+    ASSERT_EQ(6u, fixed_copy.length());
+    ASSERT_EQ(4u, fixed.substr(7, 4).length());
+
+    ASSERT_TRUE(fixed_view != dynamic_view);
+    ASSERT_TRUE(dynamic_view < fixed);
+    ASSERT_TRUE(fixed == string_view("static string"));
+}
+
+TEST(string_view_tests, compare) {
+    ASSERT_TRUE(string_view("abc") == string_view("abcdef", 3));
+    ASSERT_TRUE(string_view("abc") < string_view("abd"));
+    ASSERT_TRUE(string_view("ab") < string_view("abc"));
+    ASSERT_TRUE(string_view("abc") > string_view("ab"));
+    ASSERT_TRUE(string_view("b") >= string_view("abc"));
+    ASSERT_TRUE(string_view("abc") <= string_view("abc"));
+    ASSERT_TRUE(string_view() == "");
+    ASSERT_EQ(0, string_view("same").compare("same"));
+    ASSERT_GT(0, string_view("").compare("a"));
+}
+
+TEST(string_view_tests, hash_equals_comparator) {
+    hash<string_view, uint16_t> view_hash;
+    hash<dynamic_string, uint16_t> dynamic_hash;
+    hash<const char *, uint16_t> c_hash;
+    dynamic_string str("field_name");
+    dynamic_string line("a field_name b");
+    string_view view = line.substr_view(2, 10);
+    ASSERT_EQ(dynamic_hash(str), view_hash(view));
+    ASSERT_EQ(c_hash("field_name"), view_hash(view));
+
+    equals<string_view> eq;
+    ASSERT_TRUE(eq(view, str));
+    ASSERT_FALSE(eq(view, "field"));
+
+    comparator<string_view> cmp;
+    ASSERT_TRUE(cmp.__lt__("apple", "banana"));
+    ASSERT_TRUE(cmp.__le__("apple", "apple"));
+    ASSERT_TRUE(cmp.__eq__(view, str));
+    ASSERT_TRUE(cmp.__ne__(view, "x"));
+    ASSERT_TRUE(cmp.__gt__("b", "a"));
+    ASSERT_TRUE(cmp.__ge__("b", "b"));
+}
@@ -5,10 +5,21 @@
 #include <wlib/stl/HashMap.h>
 #include <wlib/stl/OpenMap.h>
 #include <wlib/stl/ArrayHeap.h>
+#include <wlib/stl/BTreeMap.h>
+#include <wlib/stl/BTreeSet.h>
+#include <wlib/stl/FlatMap.h>
+#include <wlib/stl/FlatSet.h>
+#include <wlib/stl/IndexedHeap.h>
 #include <wlib/stl/LinkedList.h>
+#include <wlib/stl/MinMaxHeap.h>
+#include <wlib/stl/MultiQueue.h>
 #include <wlib/stl/UniquePtr.h>
 #include <wlib/stl/SharedPtr.h>
 #include <wlib/stl/Array2D.h>
+#include <wlib/stl/StableVector.h>
+#include <wlib/stl/TreeMap.h>
+#include <wlib/stl/TreeSet.h>
+#include <wlib/stl/UnrolledList.h>
 
 namespace wlp {
     template
@@ -62,9 +73,42 @@ namespace wlp {
     template
     class array_heap<const char *>;
 
+    template
+    class array_heap<int, comparator<int>, 4>;
+
+    template
+    class array_heap<int, reverse_comparator<int>, 8>;
+
+    template
+    class top_k<int>;
+
+    template
+    class indexed_heap<int>;
+
+    template
+    class indexed_heap<int, reverse_comparator<int>, 4>;
+
+    template
+    class min_max_heap<int>;
+
+    template
+    class min_max_heap<const char *>;
+
+    template
+    class multi_queue<int>;
+
+    template
+    class multi_queue<int, reverse_comparator<int>, 4, null_lock>;
+
     template
     class array_list<int>;
 
+    template
+    class array_list<int, three_halves_growth>;
+
+    template
+    class array_list<int, chunked_growth<16>>;
+
     template
     class static_string<8>;
 
@@ -92,6 +136,24 @@ namespace wlp {
     template
     struct comparator<String8>;
 
+    template
+    class btree_map<int, int>;
+
+    template
+    class btree_set<int>;
+
+    template
+    class flat_map<int, int>;
+
+    template
+    class flat_set<int>;
+
+    template
+    class tree_map<int, int, comparator<int>, true>;
+
+    template
+    class tree_set<int, comparator<int>, true>;
+
     template
     class linked_list<int>;
 
@@ -101,6 +163,33 @@ namespace wlp {
     template
     struct LinkedListIterator<int, const int &, const int *>;
 
+    template
+    class node_pool<LinkedListNode<int>, &LinkedListNode<int>::m_next>;
+
+    template
+    class stable_vector<int>;
+
+    template
+    class stable_vector<int, 4>;
+
+    template
+    class StableVectorIterator<int, int &, int *, 16>;
+
+    template
+    class StableVectorIterator<int, const int &, const int *, 16>;
+
+    template
+    class unrolled_list<int>;
+
+    template
+    class unrolled_list<int, 4>;
+
+    template
+    struct UnrolledListIterator<int, int &, int *, 16>;
+
+    template
+    struct UnrolledListIterator<int, const int &, const int *, 16>;
+
     template
     class unique_ptr<int>;
 